@@ -0,0 +1,59 @@
+// bench.hpp
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+// Number of heap allocations performed so far (provided by bench/main.cpp)
+size_t benchAllocationCount();
+
+// Result of one timed benchmark run
+struct BenchResult {
+    double seconds = 0.0;       // Wall-clock time of the run
+    size_t allocations = 0;     // Heap allocations during the run
+};
+
+// Time a callable and count the allocations it performs
+template <typename Fn>
+inline BenchResult runBench(Fn&& fn) {
+    size_t allocsBefore = benchAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    
+    BenchResult result;
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    result.allocations = benchAllocationCount() - allocsBefore;
+    return result;
+}
+
+// Print one benchmark line: name, MB/s, allocations per line
+inline void reportBench(const char* name, const BenchResult& r,
+                        size_t bytes, size_t lines) {
+    std::printf("  %-34s %9.1f MB/s  %8.3f allocs/line\n", name,
+                bytes / r.seconds / (1024.0 * 1024.0),
+                lines ? static_cast<double>(r.allocations) / lines : 0.0);
+}
+
+// Build a synthetic rc file with the given number of lines; every other
+// line is an alias definition, the rest is typical shell boilerplate
+inline std::string makeSyntheticRc(size_t lines) {
+    std::string rc;
+    rc.reserve(lines * 40);
+    for (size_t i = 0; i < lines; ++i) {
+        switch (i % 6) {
+            case 0: rc += "alias ll" + std::to_string(i) + "='ls -la --color=auto'\n"; break;
+            case 1: rc += "# generated by config management\n"; break;
+            case 2: rc += "alias gs" + std::to_string(i) + "=\"git status \\$PWD\"\n"; break;
+            case 3: rc += "export PATH=\"$HOME/bin:$PATH\"\n"; break;
+            case 4: rc += "  alias k" + std::to_string(i) + "='kubectl get pods'\n"; break;
+            default: rc += "[ -f ~/.fzf.bash ] && source ~/.fzf.bash\n"; break;
+        }
+    }
+    return rc;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Benchmarks for Command Escaping
+//
+// This file measures escapeCommand and unescapeString against the original
+// byte-at-a-time loops they replaced, on commands with few and with many
+// special characters, and reports throughput and allocations per command.
+// ------------------------------------------------------------------------------
+
+#include "aliasmanager.hpp"
+#include "bench.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Number of commands per run
+static constexpr size_t kCommands = 200000;
+
+// ------------------------------------------------------------------------------
+// Baseline: Original Escape Loop
+// ------------------------------------------------------------------------------
+static std::string legacyEscape(const std::string& command) {
+    std::string escaped;
+    escaped.reserve(command.length() * 2);
+    for (char c : command) {
+        if (c == '\'' || c == '"' || c == '\\' || c == '$' || 
+            c == '`' || c == '!' || c == '*' || c == '?') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// ------------------------------------------------------------------------------
+// Baseline: Original Unescape Loop
+// ------------------------------------------------------------------------------
+static std::string legacyUnescape(const std::string& str) {
+    std::string unescaped;
+    unescaped.reserve(str.length());
+    bool prevBackslash = false;
+    for (char c : str) {
+        if (prevBackslash) {
+            unescaped += c;
+            prevBackslash = false;
+        } else if (c == '\\') {
+            prevBackslash = true;
+        } else {
+            unescaped += c;
+        }
+    }
+    if (prevBackslash) {
+        unescaped += '\\';
+    }
+    return unescaped;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Run All Variants on One Command Set
+// ------------------------------------------------------------------------------
+static void benchCommands(const char* label, const std::vector<std::string>& commands) {
+    size_t bytes = 0;
+    for (const auto& c : commands) {
+        bytes += c.size();
+    }
+    size_t sink = 0;
+    std::printf("  [%s]\n", label);
+    
+    reportBench("legacy escape", runBench([&] {
+        for (const auto& c : commands) sink += legacyEscape(c).size();
+    }), bytes, commands.size());
+    
+    reportBench("escapeCommand", runBench([&] {
+        for (const auto& c : commands) sink += AliasManager::escapeCommand(c).size();
+    }), bytes, commands.size());
+    
+    reportBench("escapeCommand (no-copy overload)", runBench([&] {
+        std::string storage;
+        for (const auto& c : commands) sink += AliasManager::escapeCommand(c, storage).size();
+    }), bytes, commands.size());
+    
+    std::vector<std::string> escaped;
+    for (const auto& c : commands) {
+        escaped.push_back(AliasManager::escapeCommand(c));
+    }
+    
+    reportBench("legacy unescape", runBench([&] {
+        for (const auto& c : escaped) sink += legacyUnescape(c).size();
+    }), bytes, commands.size());
+    
+    reportBench("unescapeString (no-copy overload)", runBench([&] {
+        std::string storage;
+        for (const auto& c : escaped) sink += AliasManager::unescapeString(c, storage).size();
+    }), bytes, commands.size());
+    
+    std::printf("  (%zu bytes produced)\n", sink);
+}
+
+// ------------------------------------------------------------------------------
+// Main Benchmark Runner
+// ------------------------------------------------------------------------------
+void bench_escape() {
+    std::vector<std::string> plain;
+    std::vector<std::string> special;
+    for (size_t i = 0; i < kCommands; ++i) {
+        plain.push_back("git log --oneline --graph --decorate --all -n " + std::to_string(i));
+        special.push_back("echo \"$HOME\" && find . -name '*.log' | xargs rm -f # " + 
+                          std::to_string(i));
+    }
+    
+    benchCommands("plain commands", plain);
+    benchCommands("commands with special characters", special);
+}
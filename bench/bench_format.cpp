@@ -0,0 +1,52 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Benchmarks for Alias Formatting
+//
+// This file measures regenerating a block of alias definitions, first with
+// one formatAlias call per alias appended to a string, then with the batch
+// formatAliasesInto, and reports throughput and allocations per alias.
+// ------------------------------------------------------------------------------
+
+#include "aliasmanager.hpp"
+#include "bench.hpp"
+
+#include <string>
+#include <vector>
+
+// Number of aliases in the regenerated block
+static constexpr size_t kAliases = 50000;
+
+// ------------------------------------------------------------------------------
+// Main Benchmark Runner
+// ------------------------------------------------------------------------------
+void bench_format() {
+    std::vector<Alias> aliases;
+    for (size_t i = 0; i < kAliases; ++i) {
+        std::string name = std::to_string(i);
+        name.insert(name.begin(), 'a');
+        std::string command = (i % 4 == 0) ? "echo \"$HOME\" && ls -la" : "git log --oneline -n 20";
+        aliases.push_back({name, command, "", true, "", ""});
+    }
+    
+    AliasManager manager(ShellDetector::Shell::BASH);
+    size_t bytes = 0;
+    {
+        std::string block;
+        manager.formatAliasesInto(block, aliases);
+        bytes = block.size();
+    }
+    
+    reportBench("formatAlias per alias", runBench([&] {
+        std::string block;
+        for (const auto& a : aliases) {
+            block += manager.formatAlias(a);
+            block += '\n';
+        }
+    }), bytes, aliases.size());
+    
+    reportBench("formatAliasesInto", runBench([&] {
+        std::string block;
+        manager.formatAliasesInto(block, aliases);
+    }), bytes, aliases.size());
+}
@@ -0,0 +1,187 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Benchmarks for Alias Line Parsing
+//
+// This file measures the cost of turning rc file text into aliases. It
+// compares the owning parseAliasLine API against the view-based
+// parseAliasView API, the bulk line scanner and the table-driven tokenizer
+// over one shared buffer and reports throughput and heap allocations per
+// input line. The save-time three-way merge is measured on the same buffer.
+// ------------------------------------------------------------------------------
+
+#include "aliasmanager.hpp"
+#include "linescanner.hpp"
+#include "aliastokenizer.hpp"
+#include "aliastable.hpp"
+#include "linemerge.hpp"
+#include "bench.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Number of lines in the synthetic rc file
+static constexpr size_t kLines = 200000;
+
+// ------------------------------------------------------------------------------
+// Utility: Visit Lines
+// Calls fn with a view of each line of the buffer
+// ------------------------------------------------------------------------------
+template <typename Fn>
+static void forEachLine(std::string_view text, Fn&& fn) {
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        fn(text.substr(0, eol));
+        text = (eol == std::string_view::npos) ? std::string_view() 
+                                                : text.substr(eol + 1);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Main Benchmark Runner
+// ------------------------------------------------------------------------------
+void bench_parser() {
+    const std::string rc = makeSyntheticRc(kLines);
+    size_t found = 0;
+    
+    // Owning parser: one Alias (and its strings) per line
+    BenchResult owning = runBench([&] {
+        forEachLine(rc, [&](std::string_view line) {
+            if (AliasManager::isAliasLine(line)) {
+                Alias a = AliasManager::parseAliasLine(line);
+                found += !a.name.empty();
+            }
+        });
+    });
+    reportBench("parseAliasLine", owning, rc.size(), kLines);
+    
+    // View parser: slices of the shared buffer, no materialization
+    BenchResult views = runBench([&] {
+        AliasView view;
+        forEachLine(rc, [&](std::string_view line) {
+            found += AliasManager::parseAliasView(line, view);
+        });
+    });
+    reportBench("parseAliasView", views, rc.size(), kLines);
+    
+    // View parser plus materializing commands into one reused string
+    BenchResult reused = runBench([&] {
+        AliasView view;
+        std::string command;
+        forEachLine(rc, [&](std::string_view line) {
+            if (AliasManager::parseAliasView(line, view)) {
+                view.materializeCommand(command);
+                found += !command.empty();
+            }
+        });
+    });
+    reportBench("parseAliasView + materialize", reused, rc.size(), kLines);
+    
+    // Bulk scanner: only alias lines reach the parser
+    BenchResult scanned = runBench([&] {
+        AliasView view;
+        for (const LineRef& ref : LineScanner::findAliasLines(rc)) {
+            found += AliasManager::parseAliasView(LineScanner::lineAt(rc, ref), view);
+        }
+    });
+    reportBench("findAliasLines + parseAliasView", scanned, rc.size(), kLines);
+    
+    // Scanner alone against the per-line reference on a mostly non-alias file
+    std::string sparse;
+    for (size_t i = 0; i < kLines; ++i) {
+        sparse += (i % 50 == 0) ? "alias x='y'\n" 
+                                : "export SOME_VARIABLE_NAME=\"/usr/local/share/some/path\"\n";
+    }
+    BenchResult scalarScan = runBench([&] {
+        found += LineScanner::findAliasLinesScalar(sparse).size();
+    });
+    reportBench("findAliasLinesScalar (sparse)", scalarScan, sparse.size(), kLines);
+    BenchResult simdScan = runBench([&] {
+        found += LineScanner::findAliasLines(sparse).size();
+    });
+    reportBench("findAliasLines (sparse)", simdScan, sparse.size(), kLines);
+    
+    // Tokenizer over the whole buffer (definitions reserved up front)
+    std::vector<AliasDefinition> defs;
+    defs.reserve(kLines);
+    BenchResult tokenized = runBench([&] {
+        defs.clear();
+        AliasTokenizer::tokenize(ShellDetector::Shell::BASH, rc, defs);
+        found += defs.size();
+    });
+    reportBench("AliasTokenizer::tokenize", tokenized, rc.size(), kLines);
+    
+    // Scanner hits fed to the statement tokenizer (the loadAliases path)
+    BenchResult statements = runBench([&] {
+        defs.clear();
+        size_t end = 0;
+        for (const LineRef& ref : LineScanner::findAliasLines(rc)) {
+            if (ref.offset >= end) {
+                end = AliasTokenizer::tokenizeStatement(ShellDetector::Shell::BASH, rc,
+                                                        ref.offset, ref.lineNumber, defs);
+            }
+        }
+        found += defs.size();
+    });
+    reportBench("findAliasLines + tokenizeStatement", statements, rc.size(), kLines);
+    
+    // Materializing the definitions: owning Alias objects vs one AliasTable
+    BenchResult toVector = runBench([&] {
+        std::vector<Alias> aliases;
+        aliases.reserve(defs.size());
+        for (const AliasDefinition& def : defs) {
+            aliases.push_back(def.view.toAlias());
+        }
+        found += aliases.size();
+    });
+    reportBench("definitions -> std::vector<Alias>", toVector, rc.size(), kLines);
+    BenchResult toTable = runBench([&] {
+        AliasTable table;
+        table.reserve(defs.size(), rc.size());
+        for (const AliasDefinition& def : defs) {
+            table.append(def.view);
+        }
+        found += table.size();
+    });
+    reportBench("definitions -> AliasTable", toTable, rc.size(), kLines);
+    
+    // Cache hit: the table is restored from its binary image, not parsed
+    AliasTable parsed;
+    for (const AliasDefinition& def : defs) {
+        parsed.append(def.view);
+    }
+    std::string image;
+    parsed.serialize(image);
+    BenchResult restored = runBench([&] {
+        AliasTable table;
+        found += table.deserialize(image) ? table.size() : 0;
+    });
+    reportBench("AliasTable::deserialize (cache hit)", restored, rc.size(), kLines);
+    
+    // Fish syntax, which parseAliasLine only handles through the tokenizer
+    std::string fish;
+    for (size_t i = 0; i < kLines; ++i) {
+        fish += (i % 2) ? "alias f" + std::to_string(i) + " 'ls -la --color=auto'\n"
+                        : std::string("set -gx EDITOR nvim\n");
+    }
+    BenchResult fishTokenized = runBench([&] {
+        defs.clear();
+        AliasTokenizer::tokenize(ShellDetector::Shell::FISH, fish, defs);
+        found += defs.size();
+    });
+    reportBench("AliasTokenizer::tokenize (fish)", fishTokenized, fish.size(), kLines);
+    
+    // Save-time merge: one edit on disk, two of ours, far apart
+    std::string theirs = rc;
+    std::string ours = rc;
+    theirs.insert(theirs.find('\n', theirs.size() / 3) + 1, "alias theirs='true'\n");
+    ours.replace(ours.find("alias ll0="), 6, "alias L");
+    ours += "alias ours='true'\n";
+    BenchResult merged = runBench([&] {
+        found += LineMerge::merge(rc, theirs, ours).conflicts.size();
+    });
+    reportBench("LineMerge::merge (three-way)", merged, rc.size(), kLines);
+    
+    std::printf("  (%zu aliases parsed)\n", found);
+}
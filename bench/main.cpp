@@ -0,0 +1,67 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Benchmark Runner for AliaCan - Shell Alias Manager with Auto-Backup
+//
+// This file is the entry point for the AliaCan micro-benchmarks. It replaces
+// the global allocation operators with counting versions so each benchmark
+// can report heap allocations alongside throughput, then runs the benchmark
+// functions from the other bench modules in sequence.
+// ------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "bench.hpp"
+
+// Global allocation counter shared with the bench modules.
+static std::atomic<size_t> allocationCount{0};
+
+size_t benchAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+// Counting replacements for the global allocation functions.
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Forward declarations of benchmark functions from other bench modules.
+void bench_parser();            // Alias line parsing throughput and allocations
+void bench_escape();            // Command escaping throughput and allocations
+void bench_format();            // Alias block formatting throughput and allocations
+
+// Main function - Entry point for the benchmark suite.
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "AliaCan Benchmarks v0.0.1.1" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+    
+    std::cout << "[BENCH] Running parser benchmarks..." << std::endl;
+    bench_parser();
+    std::cout << std::endl;
+    
+    std::cout << "[BENCH] Running escaping benchmarks..." << std::endl;
+    bench_escape();
+    std::cout << std::endl;
+    
+    std::cout << "[BENCH] Running formatting benchmarks..." << std::endl;
+    bench_format();
+    std::cout << std::endl;
+    
+    return 0;
+}
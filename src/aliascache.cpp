@@ -0,0 +1,214 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Cache Component Implementation
+//
+// This file implements the AliasCache class. An entry is a fixed header
+// (magic, version, key, payload hash) followed by the definition locations
+// and the table image. Loading maps the entry, compares the header with the
+// caller's key and checks the payload hash before copying anything out, so
+// stale, foreign or damaged entries are simply treated as misses.
+// ------------------------------------------------------------------------------
+
+#include "aliascache.hpp"
+#include "hash.hpp"          // Entry names and payload checksums
+#include "mappedfile.hpp"    // Zero-copy entry reads
+#include "atomicwriter.hpp"  // Entries are replaced, never patched
+#include <cstdio>            // For std::snprintf
+#include <cstdlib>           // For std::getenv
+#include <cstring>           // For std::memcpy, std::memcmp
+#include <filesystem>        // Directory creation, path handling
+#include <system_error>      // For std::error_code
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// Identifies an AliaCan cache entry
+static constexpr char kMagic[8] = {'A', 'L', 'I', 'A', 'C', 'A', 'C', 'H'};
+
+// ------------------------------------------------------------------------------
+// Structure: EntryHeader
+// Purpose: Fixed-size start of every cache entry (native byte order; the
+// cache never leaves the machine that wrote it).
+// ------------------------------------------------------------------------------
+struct EntryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t shell;
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtimeNs;
+    uint64_t contentHash;
+    uint64_t definitionCount;
+    uint64_t payloadHash;       // hash::bytes of everything after the header
+};
+
+static_assert(sizeof(EntryHeader) == 72, "EntryHeader must have no padding");
+static_assert(sizeof(CachedDefinition) == 32, "CachedDefinition must have no padding");
+
+// ------------------------------------------------------------------------------
+// Constructor
+// Entries are named after the config file plus a hash of its absolute path,
+// so two files called .bashrc in different places do not collide
+// ------------------------------------------------------------------------------
+AliasCache::AliasCache(const std::string& configPath) {
+    const std::string dir = cacheDirectory();
+    if (dir.empty()) {
+        return;
+    }
+    
+    std::error_code ec;
+    fs::path absolute = fs::absolute(configPath, ec);
+    if (ec) {
+        absolute = configPath;
+    }
+    
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), "-%016llx.cache",
+                  static_cast<unsigned long long>(hash::bytes(absolute.string())));
+    path = (fs::path(dir) / (absolute.filename().string() + suffix)).string();
+}
+
+// ------------------------------------------------------------------------------
+// Cache Directory
+// ------------------------------------------------------------------------------
+std::string AliasCache::cacheDirectory() {
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && xdg[0] == '/') {
+        return (fs::path(xdg) / "aliacan").string();
+    }
+    if (const char* home = std::getenv("HOME"); home != nullptr && home[0] != '\0') {
+        return (fs::path(home) / ".cache" / "aliacan").string();
+    }
+    return "";
+}
+
+// ------------------------------------------------------------------------------
+// Entry Path
+// ------------------------------------------------------------------------------
+std::string AliasCache::entryPath() const {
+    return path;
+}
+
+// ------------------------------------------------------------------------------
+// Load Entry
+// ------------------------------------------------------------------------------
+bool AliasCache::load(const CacheKey& key, AliasTable& table,
+                      std::vector<CachedDefinition>& definitions) {
+    if (path.empty()) {
+        lastError = "No cache directory";
+        return false;
+    }
+    
+    MappedFile file;
+    if (!file.open(path)) {
+        lastError = "No cache entry";
+        return false;
+    }
+    
+    std::string_view data = file.view();
+    EntryHeader header;
+    if (data.size() < sizeof(header)) {
+        lastError = "Cache entry truncated";
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    data.remove_prefix(sizeof(header));
+    
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        lastError = "Cache entry has another format version";
+        return false;
+    }
+    
+    const CacheKey stored{header.device, header.inode, header.size, header.mtimeNs,
+                          header.contentHash, header.shell};
+    if (!(stored == key)) {
+        lastError = "Cache entry is stale";
+        return false;
+    }
+    
+    if (hash::bytes(data) != header.payloadHash ||
+        header.definitionCount > data.size() / sizeof(CachedDefinition)) {
+        lastError = "Cache entry is damaged";
+        return false;
+    }
+    
+    const size_t count = static_cast<size_t>(header.definitionCount);
+    definitions.resize(count);
+    if (count != 0) {
+        std::memcpy(definitions.data(), data.data(), count * sizeof(CachedDefinition));
+    }
+    data.remove_prefix(count * sizeof(CachedDefinition));
+    
+    if (!table.deserialize(data) || table.size() != count) {
+        table.clear();
+        definitions.clear();
+        lastError = "Cache entry is damaged";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Store Entry
+// The entry is assembled in memory and published with one atomic rename,
+// so concurrent readers see either the old entry or the new one
+// ------------------------------------------------------------------------------
+bool AliasCache::store(const CacheKey& key, const AliasTable& table,
+                       std::span<const CachedDefinition> definitions) {
+    if (path.empty()) {
+        lastError = "No cache directory";
+        return false;
+    }
+    
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    if (ec) {
+        lastError = "Cannot create cache directory: " + ec.message();
+        return false;
+    }
+    
+    std::string entry(sizeof(EntryHeader), '\0');
+    entry.append(reinterpret_cast<const char*>(definitions.data()),
+                 definitions.size() * sizeof(CachedDefinition));
+    table.serialize(entry);
+    
+    EntryHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.shell = key.shell;
+    header.device = key.device;
+    header.inode = key.inode;
+    header.size = key.size;
+    header.mtimeNs = key.mtimeNs;
+    header.contentHash = key.contentHash;
+    header.definitionCount = definitions.size();
+    header.payloadHash = hash::bytes(std::string_view(entry).substr(sizeof(header)));
+    std::memcpy(entry.data(), &header, sizeof(header));
+    
+    AtomicWriter writer(path);
+    if (!writer.open() || !writer.write(entry) || !writer.commit()) {
+        lastError = "Cannot write cache entry: " + writer.getLastError();
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Remove Entry
+// ------------------------------------------------------------------------------
+bool AliasCache::remove() {
+    std::error_code ec;
+    if (path.empty() || !fs::remove(path, ec)) {
+        lastError = ec ? ec.message() : "No cache entry";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Get Last Error Message
+// ------------------------------------------------------------------------------
+std::string AliasCache::getLastError() const {
+    return lastError;
+}
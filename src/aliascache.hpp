@@ -0,0 +1,84 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Cache Component Header
+//
+// This header defines the AliasCache class, a persistent cache of parsed
+// configuration files. Each entry holds the binary image of an AliasTable
+// plus the byte location of every definition, keyed by the file's identity
+// (device, inode, size, mtime) and a hash of its content. Entries live under
+// $XDG_CACHE_HOME/aliacan (or ~/.cache/aliacan), are read through mmap, and
+// carry a format version so that parser changes invalidate them.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASCACHE_HPP
+#define ALIASCACHE_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "aliastable.hpp"
+
+// ------------------------------------------------------------------------------
+// Structure: CacheKey
+// Purpose: Identity of the file content a cache entry was built from.
+// ------------------------------------------------------------------------------
+struct CacheKey {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+    uint64_t contentHash = 0;   // hash::bytes of the whole file
+    uint32_t shell = 0;         // Grammar the file was parsed with
+    bool operator==(const CacheKey&) const = default;
+};
+
+// ------------------------------------------------------------------------------
+// Structure: CachedDefinition
+// Purpose: Byte location of the definition behind one table row.
+// ------------------------------------------------------------------------------
+struct CachedDefinition {
+    uint64_t offset = 0;            // Start of name=value
+    uint64_t length = 0;            // Length of name=value
+    uint64_t statementOffset = 0;   // Start of the statement's first line
+    uint64_t statementEnd = 0;      // Just past the statement
+};
+
+class AliasCache {
+public:
+    // Format version; bump whenever the tokenizer, the table image or this
+    // file layout changes
+    static constexpr uint32_t kVersion = 1;
+    
+    // Cache entry for the configuration file at configPath
+    explicit AliasCache(const std::string& configPath);
+    
+    // Directory holding all cache entries
+    // Returns: $XDG_CACHE_HOME/aliacan, ~/.cache/aliacan, or "" without HOME
+    static std::string cacheDirectory();
+    
+    // Path of this file's entry ("" if there is no cache directory)
+    std::string entryPath() const;
+    
+    // Load the entry if it was written for exactly key
+    // Returns: true if table and definitions were filled from the cache
+    bool load(const CacheKey& key, AliasTable& table, std::vector<CachedDefinition>& definitions);
+    
+    // Write (or replace) the entry; definitions are parallel to table rows
+    // Returns: true if the entry was written
+    bool store(const CacheKey& key, const AliasTable& table,
+               std::span<const CachedDefinition> definitions);
+    
+    // Delete the entry
+    bool remove();
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    std::string path;       // Entry path
+    std::string lastError;  // Last error message
+};
+
+#endif // ALIASCACHE_HPP
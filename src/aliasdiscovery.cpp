@@ -0,0 +1,480 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Discovery Component Implementation
+//
+// This file implements the AliasDiscovery class. Each file is mapped once.
+// A light lexer finds source and . commands (at the start of a command,
+// after ; && || | and keywords like then or and) and their argument is
+// expanded the way the shell would for the simple cases: quotes, ~, $VAR
+// and ${VAR:-default}. Anything needing the shell itself (command
+// substitution, globs, unset variables) is reported, not guessed.
+//
+// Execution order is kept as a list of segments: the lines of a file up to
+// an include, then the included file's segments, then the following lines.
+// A file sourced again replays the segments of its first run, so nothing
+// is read twice, and a file that includes itself (directly or not) is a
+// cycle. Definitions are collected per file in parallel and laid out along
+// the segments afterwards.
+// ------------------------------------------------------------------------------
+
+#include "aliasdiscovery.hpp"
+#include "aliastokenizer.hpp"  // Statement tokenizer
+#include "mappedfile.hpp"      // Zero-copy file reads
+#include "threadpool.hpp"      // Parallel parsing
+#include <algorithm>           // For std::sort, std::partition_point
+#include <cctype>              // For std::isalnum
+#include <cstdlib>             // For std::getenv
+#include <deque>               // Stable storage for mapped files
+#include <filesystem>          // Directory listing
+#include <map>                 // File identities
+#include <string_view>         // Word slices
+#include <sys/stat.h>          // For stat
+#include <system_error>        // For std::error_code
+#include <unordered_map>       // Shadowing lookup
+#include <utility>             // For std::pair
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------
+// Structure: IncludeCommand
+// Purpose: A source or . command and its unexpanded argument.
+// ------------------------------------------------------------------------------
+struct IncludeCommand {
+    size_t line = 0;
+    std::string word;
+};
+
+// ------------------------------------------------------------------------------
+// Structure: RunSegment
+// Purpose: Lines [firstLine, endLine) of a file, run without interruption.
+// ------------------------------------------------------------------------------
+struct RunSegment {
+    size_t file = 0;
+    size_t firstLine = 0;
+    size_t endLine = 0;
+};
+
+// ------------------------------------------------------------------------------
+// Structure: FileDefinition
+// Purpose: An alias definition of one file, before it is placed in order.
+// ------------------------------------------------------------------------------
+struct FileDefinition {
+    std::string name;
+    std::string command;
+    size_t line = 0;
+};
+
+// ------------------------------------------------------------------------------
+// Utility: Check for a Word That Keeps the Next Word a Command
+// ------------------------------------------------------------------------------
+static bool isCommandPrefix(std::string_view word, bool fish) {
+    static constexpr std::string_view common[] = {
+        "if", "then", "else", "elif", "do", "while", "until", "!", "builtin", "command"
+    };
+    static constexpr std::string_view fishOnly[] = {"and", "or", "not", "begin"};
+    
+    for (std::string_view keyword : common) {
+        if (word == keyword) return true;
+    }
+    if (fish) {
+        for (std::string_view keyword : fishOnly) {
+            if (word == keyword) return true;
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Scan One Line for Includes
+// ------------------------------------------------------------------------------
+static void scanLine(std::string_view text, size_t line, bool fish,
+                     std::vector<IncludeCommand>& out) {
+    bool commandPos = true;   // The next word is a command name
+    bool wantArg = false;     // The next word is an include argument
+    size_t i = 0;
+    
+    while (i < text.size()) {
+        const char c = text[i];
+        if (c == ' ' || c == '\t' || c == '\r') {
+            ++i;
+            continue;
+        }
+        if (c == '#') {
+            return;
+        }
+        if (c == ';' || c == '&' || c == '|' || c == '(' || c == ')' || c == '{' || c == '}') {
+            ++i;
+            commandPos = true;
+            wantArg = false;
+            continue;
+        }
+        
+        // One word, quotes and $(...) included
+        const size_t start = i;
+        int depth = 0;
+        while (i < text.size()) {
+            const char w = text[i];
+            if (w == '\\') {
+                i += 2;
+                continue;
+            }
+            if (w == '\'' || w == '"') {
+                const size_t close = text.find(w, i + 1);
+                i = close == std::string_view::npos ? text.size() : close + 1;
+                continue;
+            }
+            if (w == '$' && i + 1 < text.size() && text[i + 1] == '(') {
+                ++depth;
+                i += 2;
+                continue;
+            }
+            if (depth > 0) {
+                depth -= (w == ')');
+                ++i;
+                continue;
+            }
+            if (w == ' ' || w == '\t' || w == '\r' || w == ';' || w == '&' || w == '|' ||
+                w == '(' || w == ')') {
+                break;
+            }
+            ++i;
+        }
+        const std::string_view word = text.substr(start, std::min(i, text.size()) - start);
+        
+        if (wantArg) {
+            out.push_back({line, std::string(word)});
+            wantArg = false;
+        } else if (commandPos && (word == "source" || (!fish && word == "."))) {
+            wantArg = true;
+        } else if (!(commandPos && isCommandPrefix(word, fish))) {
+            commandPos = false;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Find Every Include of a File
+// Only lines that could hold one are lexed
+// ------------------------------------------------------------------------------
+static std::vector<IncludeCommand> scanIncludes(std::string_view text, bool fish) {
+    std::vector<IncludeCommand> includes;
+    size_t line = 1;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        const std::string_view content = text.substr(pos, eol - pos);
+        if (content.find("source") != std::string_view::npos ||
+            (!fish && content.find('.') != std::string_view::npos)) {
+            scanLine(content, line, fish, includes);
+        }
+        pos = eol + 1;
+        ++line;
+    }
+    return includes;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Value of a Shell Variable as Seen at Startup
+// Returns: false if it is unset (or only the shell itself would know it)
+// ------------------------------------------------------------------------------
+static bool variableValue(std::string_view name, std::string& value) {
+    if (name == "ZDOTDIR") {
+        value = ShellDetector::getZshConfigDir();
+        return true;
+    }
+    if (name == "__fish_config_dir") {
+        value = ShellDetector::getFishConfigDir();
+        return true;
+    }
+    const char* env = std::getenv(std::string(name).c_str());
+    if (env == nullptr || env[0] == '\0') {
+        return false;
+    }
+    value = env;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Expand an Include Argument
+// Returns: false if the path cannot be known without running the shell
+// ------------------------------------------------------------------------------
+static bool expandWord(std::string_view word, std::string& out) {
+    out.clear();
+    size_t i = 0;
+    
+    // Leading ~ or ~user
+    if (!word.empty() && word[0] == '~') {
+        const size_t slash = std::min(word.find('/'), word.size());
+        const std::string prefix(word.substr(0, slash));
+        out = ShellDetector::expandHome(prefix);
+        if (out == prefix) {
+            return false;
+        }
+        i = slash;
+    }
+    
+    bool inDouble = false;
+    while (i < word.size()) {
+        const char c = word[i];
+        if (c == '\'' && !inDouble) {
+            const size_t close = word.find('\'', i + 1);
+            if (close == std::string_view::npos) return false;
+            out.append(word.substr(i + 1, close - i - 1));
+            i = close + 1;
+        } else if (c == '"') {
+            inDouble = !inDouble;
+            ++i;
+        } else if (c == '\\') {
+            if (i + 1 >= word.size()) return false;
+            out += word[i + 1];
+            i += 2;
+        } else if (c == '`') {
+            return false;
+        } else if (c == '$') {
+            std::string_view name;
+            std::string_view fallback;
+            bool hasFallback = false;
+            if (i + 1 < word.size() && word[i + 1] == '{') {
+                const size_t close = word.find('}', i + 2);
+                if (close == std::string_view::npos) return false;
+                name = word.substr(i + 2, close - i - 2);
+                if (size_t dash = name.find(":-"); dash != std::string_view::npos) {
+                    fallback = name.substr(dash + 2);
+                    name = name.substr(0, dash);
+                    hasFallback = true;
+                }
+                i = close + 1;
+            } else {
+                size_t end = i + 1;
+                while (end < word.size() && (std::isalnum(static_cast<unsigned char>(word[end])) ||
+                                             word[end] == '_')) {
+                    ++end;
+                }
+                name = word.substr(i + 1, end - i - 1);
+                i = end;
+            }
+            if (name.empty()) return false;
+            
+            std::string value;
+            if (variableValue(name, value)) {
+                out += value;
+            } else if (hasFallback && expandWord(fallback, value)) {
+                out += value;
+            } else {
+                return false;
+            }
+        } else if (!inDouble && (c == '*' || c == '?' || c == '[')) {
+            return false;
+        } else {
+            out += c;
+            ++i;
+        }
+    }
+    return !inDouble && !out.empty();
+}
+
+// ------------------------------------------------------------------------------
+// Structure: DiscoveryWalk
+// Purpose: State of one discovery while files are followed.
+// ------------------------------------------------------------------------------
+struct DiscoveryWalk {
+    bool fish = false;
+    std::string home;                                 // Base of relative includes
+    AliasDiscovery::Result result;
+    std::deque<MappedFile> contents;                  // Mapped files by index
+    std::vector<std::vector<IncludeCommand>> includes;  // Includes by file
+    std::vector<std::pair<size_t, size_t>> firstRun;  // Segments of each file's first run
+    std::vector<uint8_t> active;                      // File is on the include stack
+    std::map<std::pair<uint64_t, uint64_t>, size_t> ids;  // (device, inode) -> file
+    std::vector<RunSegment> segments;
+    size_t runs = 0;
+    
+    // Map a new file and find its includes
+    // Returns: Its index, or kNone with the reason in error
+    size_t addFile(const std::string& path, const struct stat& st, size_t from, size_t line,
+                   std::string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = file.getLastError();
+            return AliasDiscovery::kNone;
+        }
+        const size_t index = result.files.size();
+        result.files.push_back({path, from, line});
+        includes.push_back(scanIncludes(file.view(), fish));
+        contents.push_back(std::move(file));
+        firstRun.emplace_back(0, 0);
+        active.push_back(0);
+        ids.emplace(std::make_pair(static_cast<uint64_t>(st.st_dev),
+                                   static_cast<uint64_t>(st.st_ino)), index);
+        return index;
+    }
+    
+    // Run a file: its lines, interrupted by the files it includes
+    void run(size_t file) {
+        ++runs;
+        active[file] = 1;
+        firstRun[file].first = segments.size();
+        size_t line = 1;
+        for (size_t k = 0; k < includes[file].size(); ++k) {
+            const IncludeCommand include = includes[file][k];
+            segments.push_back({file, line, include.line});
+            line = include.line;
+            follow(file, include);
+        }
+        segments.push_back({file, line, SIZE_MAX});
+        firstRun[file].second = segments.size();
+        active[file] = 0;
+    }
+    
+    // Run the target of an include, or record why it is skipped
+    void follow(size_t file, const IncludeCommand& include) {
+        auto skip = [&](std::string reason) {
+            result.skipped.push_back({file, include.line, include.word, std::move(reason)});
+        };
+        
+        std::string path;
+        if (!expandWord(include.word, path)) {
+            skip("cannot be resolved without running the shell");
+            return;
+        }
+        if (path[0] != '/') {
+            path = home + "/" + path;
+        }
+        enter(path, file, include.line, skip);
+    }
+    
+    // Run path (from file at line, or as a startup file if file is kNone)
+    template <typename Skip>
+    void enter(const std::string& path, size_t file, size_t line, Skip&& skip) {
+        struct stat st {};
+        if (stat(path.c_str(), &st) != 0) {
+            skip("not found");
+            return;
+        }
+        if (!S_ISREG(st.st_mode)) {
+            skip("not a regular file");
+            return;
+        }
+        if (runs >= AliasDiscovery::kMaxIncludes) {
+            skip("include limit reached");
+            return;
+        }
+        
+        auto known = ids.find({static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino)});
+        if (known == ids.end()) {
+            std::string error;
+            const size_t index = addFile(path, st, file, line, error);
+            if (index == AliasDiscovery::kNone) {
+                skip(error);
+                return;
+            }
+            run(index);
+        } else if (active[known->second]) {
+            skip("include cycle");
+        } else {
+            // Sourced again: the same definitions run again
+            ++runs;
+            const auto [first, last] = firstRun[known->second];
+            for (size_t s = first; s < last; ++s) {
+                segments.push_back(segments[s]);
+            }
+        }
+    }
+};
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+AliasDiscovery::AliasDiscovery(ShellDetector::Shell shell) : shell(shell) {
+}
+
+// ------------------------------------------------------------------------------
+// Startup Files
+// ------------------------------------------------------------------------------
+std::vector<std::string> AliasDiscovery::startupFiles(ShellDetector::Shell shell) {
+    switch (shell) {
+        case ShellDetector::Shell::ZSH: {
+            const std::string dir = ShellDetector::getZshConfigDir();
+            return {dir + "/.zshenv", dir + "/.zshrc"};
+        }
+        case ShellDetector::Shell::FISH: {
+            const std::string dir = ShellDetector::getFishConfigDir();
+            std::vector<std::string> files;
+            std::error_code ec;
+            for (fs::directory_iterator it(dir + "/conf.d", ec), end; !ec && it != end;
+                 it.increment(ec)) {
+                if (it->path().extension() == ".fish") {
+                    files.push_back(it->path().string());
+                }
+            }
+            std::sort(files.begin(), files.end());
+            files.push_back(ShellDetector::getConfigFilePath(shell));
+            return files;
+        }
+        case ShellDetector::Shell::BASH:
+        case ShellDetector::Shell::UNKNOWN:
+        default:
+            return {ShellDetector::getConfigFilePath(ShellDetector::Shell::BASH)};
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Discover from the Startup Files
+// ------------------------------------------------------------------------------
+AliasDiscovery::Result AliasDiscovery::discover() const {
+    return discover(startupFiles(shell));
+}
+
+// ------------------------------------------------------------------------------
+// Discover from Given Files
+// ------------------------------------------------------------------------------
+AliasDiscovery::Result AliasDiscovery::discover(const std::vector<std::string>& roots) const {
+    DiscoveryWalk walk;
+    walk.fish = shell == ShellDetector::Shell::FISH;
+    walk.home = ShellDetector::expandHome("~");
+    for (const std::string& root : roots) {
+        walk.enter(root, kNone, 0, [](const std::string&) {});
+    }
+    
+    // Definitions of every file, parsed in parallel
+    const size_t fileCount = walk.result.files.size();
+    std::vector<std::vector<FileDefinition>> definitions(fileCount);
+    ThreadPool::shared().parallelFor(fileCount, [&](size_t i) {
+        std::vector<AliasDefinition> found;
+        AliasTokenizer::tokenize(shell, walk.contents[i].view(), found);
+        definitions[i].reserve(found.size());
+        for (const AliasDefinition& def : found) {
+            FileDefinition entry{std::string(def.view.name), std::string(), def.lineNumber};
+            def.view.materializeCommand(entry.command);
+            definitions[i].push_back(std::move(entry));
+        }
+    });
+    
+    // Lay them out in execution order
+    std::vector<SourcedAlias>& aliases = walk.result.aliases;
+    for (const RunSegment& segment : walk.segments) {
+        const std::vector<FileDefinition>& defs = definitions[segment.file];
+        auto it = std::partition_point(defs.begin(), defs.end(),
+            [&segment](const FileDefinition& def) { return def.line < segment.firstLine; });
+        for (; it != defs.end() && it->line < segment.endLine; ++it) {
+            aliases.push_back({it->name, it->command, segment.file, it->line, false, kNone});
+        }
+    }
+    
+    // The last definition of each name wins
+    std::unordered_map<std::string_view, size_t> next;
+    next.reserve(aliases.size());
+    for (size_t i = aliases.size(); i-- > 0;) {
+        auto [it, inserted] = next.try_emplace(aliases[i].name, i);
+        aliases[i].effective = inserted;
+        if (!inserted) {
+            aliases[i].shadowedBy = it->second;
+            it->second = i;
+        }
+    }
+    
+    return std::move(walk.result);
+}
@@ -0,0 +1,99 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Discovery Component Header
+//
+// This header defines the AliasDiscovery class, which finds every file an
+// interactive shell reads aliases from. Starting at the shell's startup
+// files (honouring $ZDOTDIR and $XDG_CONFIG_HOME, and fish's conf.d), it
+// follows source and . statements to the files they pull in, detecting
+// cycles by device and inode. The files are then parsed in parallel and
+// their definitions laid out in the order the shell executes them, so the
+// definition in effect for each name is known.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASDISCOVERY_HPP
+#define ALIASDISCOVERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "shelldetector.hpp"
+
+class AliasDiscovery {
+public:
+    // Index meaning "no such entry"
+    static constexpr size_t kNone = SIZE_MAX;
+    
+    // Most file executions followed (files sourced repeatedly count each time)
+    static constexpr size_t kMaxIncludes = 4096;
+    
+    // --------------------------------------------------------------------------
+    // Structure: SourceFile
+    // Purpose: A discovered file and where it was first pulled in from.
+    // --------------------------------------------------------------------------
+    struct SourceFile {
+        std::string path;             // Path as resolved from the include
+        size_t includedFrom = kNone;  // Including file (kNone for startup files)
+        size_t includeLine = 0;       // Line of the include in that file
+    };
+    
+    // --------------------------------------------------------------------------
+    // Structure: SourcedAlias
+    // Purpose: One executed alias definition. A file sourced twice defines
+    // its aliases twice, so one (file, line) can appear more than once.
+    // --------------------------------------------------------------------------
+    struct SourcedAlias {
+        std::string name;             // Alias identifier
+        std::string command;          // Unescaped command
+        size_t file = 0;              // Index into Result::files
+        size_t line = 0;              // Line of the definition (1-based)
+        bool effective = false;       // Last definition of the name (wins)
+        size_t shadowedBy = kNone;    // Next definition of the name, if any
+    };
+    
+    // --------------------------------------------------------------------------
+    // Structure: SkippedInclude
+    // Purpose: An include that was not followed.
+    // --------------------------------------------------------------------------
+    struct SkippedInclude {
+        size_t file = 0;              // File holding the include
+        size_t line = 0;              // Line of the include
+        std::string target;           // Include argument as written
+        std::string reason;           // Why it was not followed
+    };
+    
+    // Everything one discovery found
+    struct Result {
+        std::vector<SourceFile> files;        // Files in discovery order
+        std::vector<SourcedAlias> aliases;    // Definitions in execution order
+        std::vector<SkippedInclude> skipped;  // Includes not followed
+    };
+    
+    // --------------------------------------------------------------------------
+    // Constructor
+    // --------------------------------------------------------------------------
+    
+    explicit AliasDiscovery(ShellDetector::Shell shell);
+    
+    // --------------------------------------------------------------------------
+    // Discovery
+    // --------------------------------------------------------------------------
+    
+    // Startup files of an interactive shell in the order it reads them
+    // (BASH: ~/.bashrc; ZSH: .zshenv and .zshrc in $ZDOTDIR; FISH:
+    // conf.d/*.fish by name, then config.fish), whether or not they exist
+    static std::vector<std::string> startupFiles(ShellDetector::Shell shell);
+    
+    // Discover from the shell's startup files
+    Result discover() const;
+    
+    // Discover from the given files, read in order (missing ones are ignored)
+    Result discover(const std::vector<std::string>& roots) const;
+
+private:
+    ShellDetector::Shell shell;     // Shell whose syntax is followed
+};
+
+#endif // ALIASDISCOVERY_HPP
@@ -0,0 +1,119 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Formatter Component Implementation
+//
+// This file implements the shell-specialised formatter. Output is produced
+// in two steps: the exact size is computed (validation plus an escape
+// count), then the bytes are written into the already sized buffer with no
+// intermediate strings.
+// ------------------------------------------------------------------------------
+
+#include "aliasformatter.hpp"
+#include <cstring>   // For std::memchr, std::memcpy
+
+// ------------------------------------------------------------------------------
+// Utility: Check an Alias Before Formatting
+// ------------------------------------------------------------------------------
+static bool isFormattable(const Alias& alias) {
+    return AliasManager::validateAliasName(alias.name) &&
+           AliasManager::validateCommand(alias.command);
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Quote Character for a Command
+// BASH/ZSH switch to double quotes when the command contains a single
+// quote; FISH always uses single quotes
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+static char quoteFor(const std::string& command) {
+    if constexpr (S == ShellDetector::Shell::FISH) {
+        return '\'';
+    } else {
+        return std::memchr(command.data(), '\'', command.size()) != nullptr ? '"' : '\'';
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Formatted Size
+// "alias " + name + separator + quote + escaped command + quote
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+size_t Formatter<S>::formattedSize(const Alias& alias) {
+    if (!isFormattable(alias)) {
+        return 0;
+    }
+    return 6 + alias.name.size() + 2 + alias.command.size() +
+           AliasManager::countEscapes(alias.command) + 1;
+}
+
+// ------------------------------------------------------------------------------
+// Write One Alias
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+char* Formatter<S>::write(char* dst, const Alias& alias) {
+    const char quote = quoteFor<S>(alias.command);
+    
+    std::memcpy(dst, "alias ", 6);
+    dst += 6;
+    std::memcpy(dst, alias.name.data(), alias.name.size());
+    dst += alias.name.size();
+    *dst++ = (S == ShellDetector::Shell::FISH) ? ' ' : '=';
+    *dst++ = quote;
+    dst = AliasManager::writeEscaped(dst, alias.command);
+    *dst++ = quote;
+    return dst;
+}
+
+// ------------------------------------------------------------------------------
+// Append One Alias
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+bool Formatter<S>::appendTo(std::string& out, const Alias& alias) {
+    const size_t size = formattedSize(alias);
+    if (size == 0) {
+        return false;
+    }
+    
+    const size_t base = out.size();
+    out.resize(base + size);
+    write(out.data() + base, alias);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Append Many Aliases
+// The first pass sums the sizes, the second writes into the resized buffer
+// (the validity check is repeated there; it is cheap next to the escape count)
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+size_t Formatter<S>::appendAll(std::string& out, std::span<const Alias> aliases) {
+    size_t total = 0;
+    for (const Alias& alias : aliases) {
+        const size_t size = formattedSize(alias);
+        total += size + (size != 0);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    
+    const size_t base = out.size();
+    out.resize(base + total);
+    
+    char* dst = out.data() + base;
+    size_t written = 0;
+    for (const Alias& alias : aliases) {
+        if (!isFormattable(alias)) {
+            continue;
+        }
+        dst = write(dst, alias);
+        *dst++ = '\n';
+        ++written;
+    }
+    return written;
+}
+
+// Explicit instantiations for all supported shells
+template class Formatter<ShellDetector::Shell::BASH>;
+template class Formatter<ShellDetector::Shell::ZSH>;
+template class Formatter<ShellDetector::Shell::FISH>;
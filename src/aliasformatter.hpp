@@ -0,0 +1,52 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Formatter Component Header
+//
+// This header defines the shell-specialised alias formatter. The quoting
+// syntax is chosen at compile time from the Shell template parameter, and
+// every formatted alias is written straight into a caller-owned buffer, so
+// a whole block of definitions is produced with a single allocation.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASFORMATTER_HPP
+#define ALIASFORMATTER_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include "aliasmanager.hpp"
+#include "shelldetector.hpp"
+
+// ------------------------------------------------------------------------------
+// Class Template: Formatter
+// Purpose: Formats aliases in the syntax of one shell.
+// - BASH/ZSH: alias name='command' (double quotes if command contains ')
+// - FISH:     alias name 'command'
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+class Formatter {
+public:
+    // Bytes the formatted alias occupies (without a trailing newline)
+    // Returns: 0 if the alias is invalid
+    static size_t formattedSize(const Alias& alias);
+    
+    // Append the formatted alias to out
+    // Returns: false (and leaves out unchanged) if the alias is invalid
+    static bool appendTo(std::string& out, const Alias& alias);
+    
+    // Append every valid alias to out, each followed by a newline. Sizes
+    // are computed first, so out is resized exactly once.
+    // Returns: Number of aliases written
+    static size_t appendAll(std::string& out, std::span<const Alias> aliases);
+
+private:
+    // Write the formatted alias (formattedSize bytes) to dst
+    static char* write(char* dst, const Alias& alias);
+};
+
+extern template class Formatter<ShellDetector::Shell::BASH>;
+extern template class Formatter<ShellDetector::Shell::ZSH>;
+extern template class Formatter<ShellDetector::Shell::FISH>;
+
+#endif // ALIASFORMATTER_HPP
@@ -10,9 +10,12 @@
 // ------------------------------------------------------------------------------
 
 #include "aliasmanager.hpp"
-#include <algorithm>  // For std::all_of, std::isalnum
-#include <cctype>     // For character classification
-#include <sstream>    // For string stream operations
+#include "aliasformatter.hpp"  // Shell-specialised output syntax
+#include "aliastokenizer.hpp"  // For fish syntax lines
+#include "charclass.hpp"       // Compile-time byte classification tables
+#include "simd.hpp"            // Block-wise byte classification
+#include <bit>                 // For std::popcount
+#include <cstring>             // For std::memchr, std::memcpy
 
 // ------------------------------------------------------------------------------
 // Constructor Implementation
@@ -25,27 +28,71 @@ AliasManager::AliasManager(ShellDetector::Shell shell) : currentShell(shell) {
 // Validation: Alias Name
 // Rules:
 // 1. Non-empty, max 255 characters
-// 2. First character: letter or underscore
+// 2. First character: letter, digit or underscore
 // 3. Subsequent characters: letter, digit, underscore, or hyphen
 // 4. No spaces, special punctuation, or control characters
+// Classification uses the ASCII tables from charclass.hpp, so the result
+// does not depend on the current locale.
 // ------------------------------------------------------------------------------
-bool AliasManager::validateAliasName(const std::string& name) {
+bool AliasManager::validateAliasName(std::string_view name) {
     // Check length constraints
     if (name.empty() || name.length() > 255) return false;
     
-    // First character must be alphabetic or underscore
-    // Using C locale for consistent behavior across platforms
-    if (!std::isalnum(static_cast<unsigned char>(name[0])) && name[0] != '_') {
+    // First character must be alphanumeric or underscore
+    if (!charclass::has(name[0], charclass::kNameStart)) {
         return false;
     }
     
-    // Check all remaining characters
-    return std::all_of(name.begin() + 1, name.end(), [](char c) {
-        // Allow alphanumeric, underscore, and hyphen
-        return std::isalnum(static_cast<unsigned char>(c)) || 
-               c == '_' || 
-               c == '-';
-    });
+    // AND the property bits of all remaining characters (no early exit,
+    // so the loop has no data-dependent branches)
+    uint8_t acc = charclass::kNameChar;
+    for (char c : name.substr(1)) {
+        acc &= charclass::props(c);
+    }
+    return (acc & charclass::kNameChar) != 0;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Name Character Mask
+// Bit i is set when byte i of the block may appear in an alias name
+// (kNameChar: letter, digit, '_' or '-')
+// ------------------------------------------------------------------------------
+static simd::Mask nameCharMask(simd::Block block) {
+    return simd::inRange(block, 'a', 'z') | simd::inRange(block, 'A', 'Z') |
+           simd::inRange(block, '0', '9') | simd::eq(block, '_') | simd::eq(block, '-');
+}
+
+// ------------------------------------------------------------------------------
+// Validation: Many Alias Names
+// Same rules as validateAliasName. Each name is classified a whole SIMD
+// block at a time; a name shorter than a block (almost all of them) takes
+// a single zero-padded block, whose padding bits are masked off
+// ------------------------------------------------------------------------------
+std::vector<uint8_t> AliasManager::validateAliasNames(std::span<const std::string_view> names) {
+    std::vector<uint8_t> valid(names.size());
+    
+    for (size_t i = 0; i < names.size(); ++i) {
+        std::string_view name = names[i];
+        const size_t len = name.size();
+        if (len == 0 || len > 255 || !charclass::has(name[0], charclass::kNameStart)) {
+            continue;
+        }
+        
+        // Bits of bytes that are not name characters
+        simd::Mask bad = 0;
+        size_t pos = 0;
+        for (; pos + simd::kBlockSize <= len; pos += simd::kBlockSize) {
+            bad |= ~nameCharMask(simd::load(name.data() + pos)) & simd::lowBits(simd::kBlockSize);
+        }
+        if (pos < len) {
+            char tail[simd::kBlockSize] = {};
+            std::memcpy(tail, name.data() + pos, len - pos);
+            bad |= ~nameCharMask(simd::load(tail)) & simd::lowBits(len - pos);
+        }
+        valid[i] = bad == 0 ? 1 : 0;
+    }
+    
+    return valid;
 }
 
 // ------------------------------------------------------------------------------
@@ -67,42 +114,45 @@ bool AliasManager::validateCommand(const std::string& command) {
 
 // ------------------------------------------------------------------------------
 // Format Alias for Shell Configuration
-// Handles:
+// Dispatches to the Formatter for the current shell, which handles:
 // - Shell-specific syntax variations
 // - Proper quoting based on command content
 // - Special character escaping
+// Returns an empty string for invalid aliases
 // ------------------------------------------------------------------------------
 std::string AliasManager::formatAlias(const Alias& alias) const {
-    // Basic validation
-    if (!validateAliasName(alias.name) || !validateCommand(alias.command)) {
-        return "";
-    }
-    
-    // Handle shell-specific formatting
+    std::string line;
     switch (currentShell) {
-        case ShellDetector::Shell::BASH:
         case ShellDetector::Shell::ZSH:
-            // BASH/ZSH: alias name='command' or alias name="command"
-            if (alias.command.find('\'') != std::string::npos) {
-                // Command contains single quotes, use double quotes
-                return "alias " + alias.name + "=\"" + 
-                       escapeCommand(alias.command) + "\"";
-            } else {
-                // Use single quotes (safer, prevents variable expansion)
-                return "alias " + alias.name + "='" + 
-                       escapeCommand(alias.command) + "'";
-            }
-            
+            Formatter<ShellDetector::Shell::ZSH>::appendTo(line, alias);
+            break;
         case ShellDetector::Shell::FISH:
-            // FISH: alias name 'command'
-            return "alias " + alias.name + " '" + 
-                   escapeCommand(alias.command) + "'";
-            
+            Formatter<ShellDetector::Shell::FISH>::appendTo(line, alias);
+            break;
+        case ShellDetector::Shell::BASH:
         case ShellDetector::Shell::UNKNOWN:
         default:
             // Default to BASH syntax
-            return "alias " + alias.name + "='" + 
-                   escapeCommand(alias.command) + "'";
+            Formatter<ShellDetector::Shell::BASH>::appendTo(line, alias);
+            break;
+    }
+    return line;
+}
+
+// ------------------------------------------------------------------------------
+// Format Many Aliases into One Buffer
+// The shell is resolved once for the whole batch; see Formatter::appendAll
+// ------------------------------------------------------------------------------
+size_t AliasManager::formatAliasesInto(std::string& out, std::span<const Alias> aliases) const {
+    switch (currentShell) {
+        case ShellDetector::Shell::ZSH:
+            return Formatter<ShellDetector::Shell::ZSH>::appendAll(out, aliases);
+        case ShellDetector::Shell::FISH:
+            return Formatter<ShellDetector::Shell::FISH>::appendAll(out, aliases);
+        case ShellDetector::Shell::BASH:
+        case ShellDetector::Shell::UNKNOWN:
+        default:
+            return Formatter<ShellDetector::Shell::BASH>::appendAll(out, aliases);
     }
 }
 
@@ -114,68 +164,84 @@ std::string AliasManager::formatAlias(const Alias& alias) const {
 // - alias name = 'command' (with spaces)
 // - alias name 'command' (fish syntax)
 // ------------------------------------------------------------------------------
-Alias AliasManager::parseAliasLine(const std::string& line) {
-    Alias result;  // Default empty result
+Alias AliasManager::parseAliasLine(std::string_view line) {
+    AliasView view;
+    if (!parseAliasView(line, view)) {
+        return Alias();  // Default empty result
+    }
+    return view.toAlias();
+}
+
+// ------------------------------------------------------------------------------
+// Parse Alias Line into Views
+// Same grammar as parseAliasLine, but name and command are slices of the
+// input line. Nothing is copied; escapes are only flagged, not resolved.
+// ------------------------------------------------------------------------------
+bool AliasManager::parseAliasView(std::string_view line, AliasView& out) {
+    out = AliasView();
     
     // Skip leading whitespace
     size_t start = line.find_first_not_of(" \t");
-    if (start == std::string::npos) return result;  // Empty line
+    if (start == std::string_view::npos) return false;  // Empty line
     
     // Check if line starts with "alias"
-    if (line.substr(start, 5) != "alias") return result;  // Not an alias line
+    if (line.substr(start, 5) != "alias") return false;  // Not an alias line
     
     // Find equals sign (might be spaces around it)
     size_t eqPos = line.find('=', start + 5);
-    if (eqPos == std::string::npos) {
+    if (eqPos == std::string_view::npos) {
         // Fish syntax: alias name 'command' (no equals)
-        // Could implement fish-specific parsing here
-        return result;
+        std::vector<AliasDefinition> defs;
+        ShellTokenizer<ShellDetector::Shell::FISH>::tokenizeStatement(line, 0, 1, defs);
+        if (defs.empty()) return false;
+        out = defs.front().view;
+        return true;
     }
     
     // Extract alias name (between "alias" and "=")
-    std::string namePart = line.substr(start + 5, eqPos - start - 5);
+    std::string_view namePart = line.substr(start + 5, eqPos - start - 5);
     size_t nameStart = namePart.find_first_not_of(" \t");
     size_t nameEnd = namePart.find_last_not_of(" \t");
     
-    if (nameStart == std::string::npos) return result;  // No name found
+    if (nameStart == std::string_view::npos) return false;  // No name found
     
-    result.name = namePart.substr(nameStart, nameEnd - nameStart + 1);
+    out.name = namePart.substr(nameStart, nameEnd - nameStart + 1);
     
     // Extract command (after "=")
-    std::string commandPart = line.substr(eqPos + 1);
+    std::string_view commandPart = line.substr(eqPos + 1);
     size_t cmdStart = commandPart.find_first_not_of(" \t");
     
-    if (cmdStart == std::string::npos) return result;  // No command found
+    if (cmdStart == std::string_view::npos) return true;  // No command found
     
     // Check for quoted command
     if (commandPart[cmdStart] == '\'' || commandPart[cmdStart] == '"') {
         char quote = commandPart[cmdStart];
         size_t endQuote = commandPart.find(quote, cmdStart + 1);
         
-        if (endQuote != std::string::npos) {
+        if (endQuote != std::string_view::npos) {
             // Found matching quote
-            result.command = commandPart.substr(cmdStart + 1, 
-                                               endQuote - cmdStart - 1);
+            out.command = commandPart.substr(cmdStart + 1, 
+                                             endQuote - cmdStart - 1);
         } else {
             // Unclosed quote - take everything after opening quote
-            result.command = commandPart.substr(cmdStart + 1);
+            out.command = commandPart.substr(cmdStart + 1);
         }
     } else {
         // Unquoted command - read until comment or end of line
         size_t commentPos = commandPart.find('#', cmdStart);
-        result.command = commandPart.substr(cmdStart, commentPos - cmdStart);
+        out.command = commandPart.substr(cmdStart, commentPos - cmdStart);
         
         // Trim trailing whitespace
-        size_t end = result.command.find_last_not_of(" \t");
-        if (end != std::string::npos) {
-            result.command.resize(end + 1);
+        size_t end = out.command.find_last_not_of(" \t");
+        if (end != std::string_view::npos) {
+            out.command = out.command.substr(0, end + 1);
         }
     }
     
-    // Unescape the command if needed
-    result.command = unescapeString(result.command);
+    // Only flag escapes here; they are resolved when the view is materialized
+    out.hasEscapes = out.command.find('\\') != std::string_view::npos;
     
-    return result;
+    return true;
 }
 
 // ------------------------------------------------------------------------------
@@ -183,15 +249,39 @@ Alias AliasManager::parseAliasLine(const std::string& line) {
 // Simple check: line starts with "alias" keyword
 // Could be enhanced to handle indented or commented alias lines
 // ------------------------------------------------------------------------------
-bool AliasManager::isAliasLine(const std::string& line) {
+bool AliasManager::isAliasLine(std::string_view line) {
     // Skip leading whitespace
     size_t start = line.find_first_not_of(" \t");
     
     // Check if line starts with "alias"
-    return start != std::string::npos && 
+    return start != std::string_view::npos && 
            line.substr(start, 5) == "alias";
 }
 
+// ------------------------------------------------------------------------------
+// AliasView: Materialize Command
+// Copies the command slice, resolving quotes or escapes only when present
+// ------------------------------------------------------------------------------
+void AliasView::materializeCommand(std::string& out) const {
+    if (hasQuotes) {
+        AliasManager::dequoteInto(command, out);
+    } else if (hasEscapes) {
+        AliasManager::unescapeInto(command, out);
+    } else {
+        out.assign(command);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// AliasView: Convert to Owning Alias
+// ------------------------------------------------------------------------------
+Alias AliasView::toAlias() const {
+    Alias result{};
+    result.name.assign(name);
+    materializeCommand(result.command);
+    return result;
+}
+
 // ------------------------------------------------------------------------------
 // Shell Getter/Setter
 // ------------------------------------------------------------------------------
@@ -224,53 +314,225 @@ std::string AliasManager::extractQuotedString(const std::string& str, size_t sta
 }
 
 // ------------------------------------------------------------------------------
-// Utility: Escape Command String
-// Escapes special shell characters to prevent interpretation
+// Utility: Escape Mask
+// Bit i is set when byte i of the block is one of the escaped characters
 // ------------------------------------------------------------------------------
-std::string AliasManager::escapeCommand(const std::string& command) {
-    std::string escaped;
-    escaped.reserve(command.length() * 2);  // Reserve worst-case space
+static simd::Mask escapeMask(simd::Block block) {
+    simd::Mask mask = 0;
+    for (char c : charclass::kEscapedChars) {
+        mask |= simd::eq(block, c);
+    }
+    return mask;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Visit Escaped Positions
+// Calls fn(offset) for every byte of text that needs escaping, classifying
+// a whole SIMD block per step; the tail goes through a padded block
+// ------------------------------------------------------------------------------
+template <typename Fn>
+static void forEachEscape(std::string_view text, Fn&& fn) {
+    const char* data = text.data();
+    const size_t size = text.size();
     
-    for (char c : command) {
-        // Escape characters that have special meaning in shells
-        if (c == '\'' || c == '"' || c == '\\' || c == '$' || 
-            c == '`' || c == '!' || c == '*' || c == '?') {
-            escaped += '\\';
+    auto visit = [&fn](size_t base, simd::Mask mask) {
+        while (mask != 0) {
+            fn(base + static_cast<size_t>(simd::firstBit(mask)));
+            mask &= mask - 1;
         }
-        escaped += c;
+    };
+    
+    size_t pos = 0;
+    for (; pos + simd::kBlockSize <= size; pos += simd::kBlockSize) {
+        visit(pos, escapeMask(simd::load(data + pos)));
     }
+    if (pos < size) {
+        char tail[simd::kBlockSize] = {};
+        std::memcpy(tail, data + pos, size - pos);
+        visit(pos, escapeMask(simd::load(tail)) & simd::lowBits(size - pos));
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Count Escapes
+// ------------------------------------------------------------------------------
+size_t AliasManager::countEscapes(std::string_view command) {
+    size_t count = 0;
+    const char* data = command.data();
+    const size_t size = command.size();
+    
+    size_t pos = 0;
+    for (; pos + simd::kBlockSize <= size; pos += simd::kBlockSize) {
+        count += static_cast<size_t>(std::popcount(escapeMask(simd::load(data + pos))));
+    }
+    for (; pos < size; ++pos) {
+        count += charclass::has(data[pos], charclass::kEscape);
+    }
+    return count;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Write Escaped Command
+// Copies the run before each escaped byte, then its backslash; the escaped
+// byte itself starts the next run. dst must have room for the command
+// plus one byte per escape.
+// ------------------------------------------------------------------------------
+char* AliasManager::writeEscaped(char* dst, std::string_view command) {
+    if (command.empty()) return dst;
+    
+    const char* src = command.data();
+    size_t runStart = 0;
+    forEachEscape(command, [&](size_t at) {
+        std::memcpy(dst, src + runStart, at - runStart);
+        dst += at - runStart;
+        *dst++ = '\\';
+        runStart = at;
+    });
+    std::memcpy(dst, src + runStart, command.size() - runStart);
+    return dst + (command.size() - runStart);
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Append Escaped Command
+// Escapes special shell characters to prevent interpretation. The output is
+// resized once to its exact final length and the runs between escaped
+// characters are copied with memcpy.
+// ------------------------------------------------------------------------------
+void AliasManager::appendEscaped(std::string& out, std::string_view command) {
+    if (command.empty()) return;
+    
+    const size_t escapes = countEscapes(command);
+    const size_t base = out.size();
+    out.resize(base + command.size() + escapes);
     
+    // Nothing to escape: one bulk copy
+    if (escapes == 0) {
+        std::memcpy(out.data() + base, command.data(), command.size());
+        return;
+    }
+    writeEscaped(out.data() + base, command);
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Escape Command String
+// ------------------------------------------------------------------------------
+std::string AliasManager::escapeCommand(std::string_view command) {
+    std::string escaped;
+    appendEscaped(escaped, command);
     return escaped;
 }
 
+// ------------------------------------------------------------------------------
+// Utility: Escape Command Only If Needed
+// ------------------------------------------------------------------------------
+std::string_view AliasManager::escapeCommand(std::string_view command, std::string& storage) {
+    if (countEscapes(command) == 0) {
+        return command;  // Fast path: no copy
+    }
+    storage.clear();
+    appendEscaped(storage, command);
+    return storage;
+}
+
 // ------------------------------------------------------------------------------
 // Utility: Unescape String
 // Removes backslash escapes from string
 // ------------------------------------------------------------------------------
-std::string AliasManager::unescapeString(const std::string& str) {
+std::string AliasManager::unescapeString(std::string_view str) {
     std::string unescaped;
-    unescaped.reserve(str.length());  // Unescaped string won't be longer
+    unescapeInto(str, unescaped);
+    return unescaped;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Unescape String Only If Needed
+// ------------------------------------------------------------------------------
+std::string_view AliasManager::unescapeString(std::string_view str, std::string& storage) {
+    if (std::memchr(str.data(), '\\', str.size()) == nullptr) {
+        return str;  // Fast path: no copy
+    }
+    unescapeInto(str, storage);
+    return storage;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Unescape Into Existing String
+// Same rules as unescapeString; out is cleared first. Backslashes are
+// located with memchr (vectorized by libc) and the runs between them are
+// copied with memcpy into a buffer sized once to the input length.
+// ------------------------------------------------------------------------------
+void AliasManager::unescapeInto(std::string_view str, std::string& out) {
+    const char* src = str.data();
+    const size_t size = str.size();
     
+    const void* hit = std::memchr(src, '\\', size);
+    if (hit == nullptr) {
+        out.assign(str);  // Nothing to unescape
+        return;
+    }
+    
+    // Unescaped string won't be longer; shrink to the real length at the end
+    out.resize(size);
+    char* dst = out.data();
+    size_t runStart = 0;
+    
+    while (hit != nullptr) {
+        size_t at = static_cast<size_t>(static_cast<const char*>(hit) - src);
+        std::memcpy(dst, src + runStart, at - runStart);
+        dst += at - runStart;
+        
+        if (at + 1 == size) {
+            // Handle trailing backslash (malformed but possible)
+            *dst++ = '\\';
+            runStart = size;
+            break;
+        }
+        
+        // Escaped character is added literally; an escaped newline is a
+        // line continuation and disappears
+        if (src[at + 1] != '\n') {
+            *dst++ = src[at + 1];
+        }
+        runStart = at + 2;
+        hit = runStart < size ? std::memchr(src + runStart, '\\', size - runStart) : nullptr;
+    }
+    
+    std::memcpy(dst, src + runStart, size - runStart);
+    dst += size - runStart;
+    out.resize(static_cast<size_t>(dst - out.data()));
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Dequote Shell Word
+// Drops the quote characters of every quoted segment and resolves
+// backslash escapes, producing the word's final value
+// ------------------------------------------------------------------------------
+void AliasManager::dequoteInto(std::string_view word, std::string& out) {
+    out.clear();
+    out.reserve(word.length());  // Dequoted word won't be longer
+    
+    char quote = 0;              // Active quote character, 0 if none
     bool prevBackslash = false;
     
-    for (char c : str) {
+    for (char c : word) {
         if (prevBackslash) {
-            // Current character was escaped, add it literally
-            unescaped += c;
+            if (c != '\n') {
+                out += c;
+            }
             prevBackslash = false;
         } else if (c == '\\') {
-            // Backslash found, escape next character
             prevBackslash = true;
+        } else if (quote == 0 && (c == '\'' || c == '"')) {
+            quote = c;           // Opening quote
+        } else if (c == quote) {
+            quote = 0;           // Closing quote
         } else {
-            // Normal character
-            unescaped += c;
+            out += c;
         }
     }
     
     // Handle trailing backslash (malformed but possible)
     if (prevBackslash) {
-        unescaped += '\\';
+        out += '\\';
     }
-    
-    return unescaped;
-}
\ No newline at end of file
+}
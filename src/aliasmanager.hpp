@@ -13,7 +13,11 @@
 #ifndef ALIASMANAGER_HPP
 #define ALIASMANAGER_HPP
 
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "shelldetector.hpp"
 
 // ------------------------------------------------------------------------------
@@ -31,11 +35,35 @@ struct Alias {
     }
     
     std::string description;    // Human-readable description
-    bool enabled;               // Whether alias is active
+    bool enabled = true;        // Whether alias is active
     std::string created_date;   // When alias was created
     std::string last_used;      // When alias was last used
 };
 
+// ------------------------------------------------------------------------------
+// Structure: AliasView
+// Purpose: Non-owning view of an alias definition inside a larger text buffer.
+// Name and command are slices of the parsed text, so parsing a whole file
+// allocates nothing. The command keeps its raw (still escaped, or for
+// concatenated words still quoted) form and is only copied and resolved
+// when it is materialized.
+// ------------------------------------------------------------------------------
+struct AliasView {
+    std::string_view name;      // Alias identifier slice
+    std::string_view command;   // Command slice, quotes stripped, escapes kept
+    bool hasEscapes = false;    // Command contains backslash escapes
+    bool hasQuotes = false;     // Command is a word with embedded quotes
+    
+    // Check whether the view holds a parsed alias
+    bool empty() const { return name.empty(); }
+    
+    // Write the unescaped command into out, reusing its capacity
+    void materializeCommand(std::string& out) const;
+    
+    // Build an owning Alias from the view
+    Alias toAlias() const;
+};
+
 // ------------------------------------------------------------------------------
 // Class: AliasManager
 // Purpose: Central manager for all alias-related operations.
@@ -62,7 +90,11 @@ public:
     
     // Validate alias name according to shell naming conventions
     // Returns: true if name is valid, false otherwise
-    static bool validateAliasName(const std::string& name);
+    static bool validateAliasName(std::string_view name);
+    
+    // Validate many alias names in one call (bulk imports, fleet scans)
+    // Returns: One entry per name, 1 if valid and 0 otherwise
+    static std::vector<uint8_t> validateAliasNames(std::span<const std::string_view> names);
     
     // Validate command string for safety and syntax
     // Returns: true if command is valid, false otherwise
@@ -76,13 +108,22 @@ public:
     // Returns: Formatted alias string ready for insertion into config file
     std::string formatAlias(const Alias& alias) const;
     
+    // Append every valid alias to out, one per line, with a single resize
+    // Invalid aliases are skipped
+    // Returns: Number of aliases written
+    size_t formatAliasesInto(std::string& out, std::span<const Alias> aliases) const;
+    
     // Parse a line from config file into Alias structure
     // Returns: Parsed Alias object, empty if line is not a valid alias
-    static Alias parseAliasLine(const std::string& line);
+    static Alias parseAliasLine(std::string_view line);
+    
+    // Parse a line into views over the line itself (no allocation)
+    // Returns: true if an alias name was found, out is cleared otherwise
+    static bool parseAliasView(std::string_view line, AliasView& out);
     
     // Check if a line appears to be an alias definition
     // Returns: true if line starts with 'alias' keyword
-    static bool isAliasLine(const std::string& line);
+    static bool isAliasLine(std::string_view line);
     
     // --------------------------------------------------------------------------
     // String Utility Methods (Static)
@@ -96,12 +137,38 @@ public:
     // Escape special characters in command string
     // Handles: quotes, backslashes, dollar signs
     // Returns: Escaped string safe for shell interpretation
-    static std::string escapeCommand(const std::string& command);
+    static std::string escapeCommand(std::string_view command);
+    
+    // Escape command only if needed, using storage for the escaped copy
+    // Returns: command itself when nothing needs escaping, else storage
+    static std::string_view escapeCommand(std::string_view command, std::string& storage);
+    
+    // Count the characters of command that need a backslash
+    static size_t countEscapes(std::string_view command);
+    
+    // Append the escaped command to out with a single exact resize
+    static void appendEscaped(std::string& out, std::string_view command);
+    
+    // Write the escaped command to dst, which must hold
+    // command.size() + countEscapes(command) bytes
+    // Returns: Pointer just past the written bytes
+    static char* writeEscaped(char* dst, std::string_view command);
     
     // Remove escape sequences from string
-    // Handles: backslash-escaped characters
+    // Handles: backslash-escaped characters, backslash-newline continuations
     // Returns: Unescaped string
-    static std::string unescapeString(const std::string& str);
+    static std::string unescapeString(std::string_view str);
+    
+    // Unescape str only if needed, using storage for the unescaped copy
+    // Returns: str itself when it has no backslash, else storage
+    static std::string_view unescapeString(std::string_view str, std::string& storage);
+    
+    // Unescape str into out, reusing out's existing capacity
+    static void unescapeInto(std::string_view str, std::string& out);
+    
+    // Remove quotes and escapes from a shell word such as 'ls '"-la"
+    // Handles: quoted segments, backslash escapes, line continuations
+    static void dequoteInto(std::string_view word, std::string& out);
     
 private:
     // Current shell type for formatting decisions
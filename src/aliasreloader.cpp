@@ -0,0 +1,283 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Reloader Component Implementation
+//
+// This file implements the AliasReloader class. A change is located by
+// the common prefix and suffix of the old and new content. The region is
+// widened to whole statements of the old text, tokenized in the new text,
+// and widened again whenever a new statement runs past it (an opened quote
+// can swallow following lines) until both texts are at the same statement
+// boundary. Rows outside the region are copied with shifted locations.
+// ------------------------------------------------------------------------------
+
+#include "aliasreloader.hpp"
+#include "aliastokenizer.hpp"  // Statement tokenizer
+#include "mappedfile.hpp"      // Zero-copy file reads
+#include <algorithm>           // For std::count, std::partition_point, std::min
+#include <cstring>             // For std::memcmp
+#include <filesystem>          // Existence checks
+#include <system_error>        // For std::error_code
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------
+// Utility: Length of the Common Prefix
+// ------------------------------------------------------------------------------
+static size_t commonPrefix(std::string_view a, std::string_view b) {
+    const size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i + 64 <= n && std::memcmp(a.data() + i, b.data() + i, 64) == 0) {
+        i += 64;
+    }
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Length of the Common Suffix
+// ------------------------------------------------------------------------------
+static size_t commonSuffix(std::string_view a, std::string_view b) {
+    const size_t n = std::min(a.size(), b.size());
+    const char* ea = a.data() + a.size();
+    const char* eb = b.data() + b.size();
+    size_t i = 0;
+    while (i + 64 <= n && std::memcmp(ea - i - 64, eb - i - 64, 64) == 0) {
+        i += 64;
+    }
+    while (i < n && ea[-1 - static_cast<ptrdiff_t>(i)] == eb[-1 - static_cast<ptrdiff_t>(i)]) {
+        ++i;
+    }
+    return i;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Count Newlines in a Range
+// ------------------------------------------------------------------------------
+static size_t countLines(std::string_view text, size_t begin, size_t end) {
+    return static_cast<size_t>(std::count(text.begin() + begin, text.begin() + end, '\n'));
+}
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+AliasReloader::AliasReloader(const std::string& configPath, ShellDetector::Shell shell)
+    : configPath(configPath), handler(configPath, shell), shell(shell) {
+}
+
+// ------------------------------------------------------------------------------
+// Refresh from Disk
+// ------------------------------------------------------------------------------
+bool AliasReloader::refresh(AliasDelta& delta, AliasTable& snapshot, std::string* fileContent) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // First load: the whole file, through the parse cache
+    if (!loaded) {
+        table = handler.loadAliasTable(content, locations);
+        loaded = true;
+        parsedBytes = content.size();
+        delta = {currentGeneration, currentGeneration + 1, 0, 0, table.size()};
+        ++currentGeneration;
+        snapshot = table;
+        if (fileContent != nullptr) {
+            *fileContent = content;
+        }
+        return true;
+    }
+    
+    // A deleted file has no aliases
+    MappedFile file;
+    std::error_code ec;
+    if (fs::exists(configPath, ec) && !file.open(configPath)) {
+        lastError = file.getLastError();
+        return false;
+    }
+    if (!applyChange(file.view(), delta)) {
+        return false;
+    }
+    snapshot = table;
+    if (fileContent != nullptr) {
+        *fileContent = content;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Update from Supplied Content
+// ------------------------------------------------------------------------------
+bool AliasReloader::update(std::string_view next, AliasDelta& delta, AliasTable& snapshot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    loaded = true;
+    if (!applyChange(next, delta)) {
+        return false;
+    }
+    snapshot = table;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Apply a Content Change
+// ------------------------------------------------------------------------------
+bool AliasReloader::applyChange(std::string_view next, AliasDelta& delta) {
+    const std::string_view old = content;
+    parsedBytes = 0;
+    
+    const size_t prefix = commonPrefix(old, next);
+    if (prefix == old.size() && prefix == next.size()) {
+        return false;
+    }
+    const size_t suffix = commonSuffix(old.substr(prefix), next.substr(prefix));
+    const int64_t shift = static_cast<int64_t>(next.size()) - static_cast<int64_t>(old.size());
+    
+    // Index of the first definition whose statement ends after pos
+    auto statementAfter = [this](size_t pos) {
+        return static_cast<size_t>(std::partition_point(
+            locations.begin(), locations.end(),
+            [pos](const CachedDefinition& loc) { return loc.statementEnd <= pos; }) -
+            locations.begin());
+    };
+    
+    // Move pos back to a statement boundary of the old text
+    size_t start = AliasTokenizer::previousLineBoundary(old, prefix);
+    if (size_t i = statementAfter(start);
+        i < locations.size() && locations[i].statementOffset < start) {
+        start = static_cast<size_t>(locations[i].statementOffset);
+    }
+    
+    // A statement left open at the end of the old text (an unclosed quote,
+    // a trailing continuation) takes in whatever now follows it
+    if (!locations.empty() && locations.back().statementEnd == old.size() &&
+        locations.back().statementOffset < start) {
+        start = static_cast<size_t>(locations.back().statementOffset);
+    }
+    
+    // Move pos forward to a statement boundary of the old text
+    auto boundaryAfter = [&](size_t pos) {
+        for (;;) {
+            size_t next = AliasTokenizer::nextLineBoundary(old, pos);
+            size_t i = statementAfter(next);
+            if (i < locations.size() && locations[i].statementOffset < next) {
+                next = static_cast<size_t>(locations[i].statementEnd);
+            }
+            if (next == pos) {
+                return pos;
+            }
+            pos = next;
+        }
+    };
+    size_t end = boundaryAfter(old.size() - suffix);
+    
+    // Rows before the region, and the line the region starts on
+    const size_t firstRow = static_cast<size_t>(std::partition_point(
+        locations.begin(), locations.end(),
+        [start](const CachedDefinition& loc) { return loc.offset < start; }) - locations.begin());
+    size_t line = 1 + countLines(old, 0, start);
+    if (firstRow > 0) {
+        const size_t anchor = static_cast<size_t>(locations[firstRow - 1].offset);
+        line = table.lineNumber(firstRow - 1) + countLines(old, anchor, start);
+    }
+    
+    // Tokenize the new text of the region, growing it while a statement
+    // runs past its end
+    std::vector<AliasDefinition> definitions;
+    size_t pos = start;
+    size_t lineAtPos = line;
+    for (;;) {
+        const size_t regionEnd = static_cast<size_t>(static_cast<int64_t>(end) + shift);
+        while (pos < regionEnd) {
+            const size_t stop = AliasTokenizer::tokenizeStatement(shell, next, pos, lineAtPos,
+                                                                  definitions);
+            lineAtPos += countLines(next, pos, stop);
+            pos = stop;
+        }
+        if (pos == regionEnd) {
+            break;
+        }
+        end = boundaryAfter(static_cast<size_t>(static_cast<int64_t>(pos) - shift));
+    }
+    parsedBytes = pos - start;
+    
+    const size_t lastRow = static_cast<size_t>(std::partition_point(
+        locations.begin(), locations.end(),
+        [end](const CachedDefinition& loc) { return loc.offset < end; }) - locations.begin());
+    const int64_t lineShift = static_cast<int64_t>(lineAtPos - line) -
+                              static_cast<int64_t>(countLines(old, start, end));
+    
+    // Splice: rows before, re-parsed rows, shifted rows after
+    AliasTable rebuilt;
+    std::vector<CachedDefinition> relocated;
+    const size_t rows = firstRow + definitions.size() + (locations.size() - lastRow);
+    rebuilt.reserve(rows, table.arenaSize() + next.size() - std::min(next.size(), old.size()));
+    relocated.reserve(rows);
+    
+    for (size_t row = 0; row < firstRow; ++row) {
+        rebuilt.append(table, row, table.lineNumber(row));
+        relocated.push_back(locations[row]);
+    }
+    for (const AliasDefinition& def : definitions) {
+        rebuilt.append(def.view, def.lineNumber);
+        relocated.push_back({def.offset, def.length, def.statementOffset, def.statementEnd});
+    }
+    for (size_t row = lastRow; row < locations.size(); ++row) {
+        rebuilt.append(table, row, static_cast<size_t>(
+            static_cast<int64_t>(table.lineNumber(row)) + lineShift));
+        CachedDefinition loc = locations[row];
+        loc.offset = static_cast<uint64_t>(static_cast<int64_t>(loc.offset) + shift);
+        loc.statementOffset = static_cast<uint64_t>(static_cast<int64_t>(loc.statementOffset) + shift);
+        loc.statementEnd = static_cast<uint64_t>(static_cast<int64_t>(loc.statementEnd) + shift);
+        relocated.push_back(loc);
+    }
+    
+    // Trim re-parsed rows that came out unchanged from both ends
+    size_t removed = lastRow - firstRow;
+    size_t inserted = definitions.size();
+    size_t first = firstRow;
+    auto same = [&](size_t oldRow, size_t newRow) {
+        return table.name(oldRow) == rebuilt.name(newRow) &&
+               table.command(oldRow) == rebuilt.command(newRow);
+    };
+    while (removed > 0 && inserted > 0 && same(first, first)) {
+        ++first;
+        --removed;
+        --inserted;
+    }
+    while (removed > 0 && inserted > 0 &&
+           same(first + removed - 1, first + inserted - 1)) {
+        --removed;
+        --inserted;
+    }
+    
+    content.assign(next);
+    table = std::move(rebuilt);
+    locations = std::move(relocated);
+    
+    // Still a new version when no row changed: line numbers, locations and
+    // the content the caller holds are all different now
+    if (removed == 0 && inserted == 0) {
+        first = 0;
+    }
+    delta = {currentGeneration, currentGeneration + 1, first, removed, inserted};
+    ++currentGeneration;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Accessors
+// ------------------------------------------------------------------------------
+uint64_t AliasReloader::generation() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return currentGeneration;
+}
+
+size_t AliasReloader::lastParsedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return parsedBytes;
+}
+
+std::string AliasReloader::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
@@ -0,0 +1,87 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Reloader Component Header
+//
+// This header defines the AliasReloader class, which keeps an in-memory
+// alias table in step with a configuration file that changes underneath
+// it. On each refresh the new content is compared with the previous one,
+// only the statements around the bytes that differ are tokenized again,
+// and the result is reported as a single row-range replacement that a view
+// can apply without rebuilding itself.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASRELOADER_HPP
+#define ALIASRELOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aliascache.hpp"
+#include "aliastable.hpp"
+#include "configfilehandler.hpp"
+#include "shelldetector.hpp"
+
+// ------------------------------------------------------------------------------
+// Structure: AliasDelta
+// Purpose: How one refresh changed the table. Rows [firstRow, firstRow +
+// removedRows) of the previous table became rows [firstRow, firstRow +
+// insertedRows) of the new one; every other row kept its name and command
+// (an edit outside alias definitions replaces no rows).
+// ------------------------------------------------------------------------------
+struct AliasDelta {
+    uint64_t baseGeneration = 0;    // Table version the delta applies to
+    uint64_t generation = 0;        // Table version it produces
+    size_t firstRow = 0;            // First replaced row
+    size_t removedRows = 0;         // Rows of the old table replaced
+    size_t insertedRows = 0;        // Rows of the new table inserted
+};
+
+class AliasReloader {
+public:
+    // Track the configuration file at configPath
+    AliasReloader(const std::string& configPath, ShellDetector::Shell shell);
+    
+    // Re-read the file and bring the table up to date. The first call
+    // loads the whole file (through the parse cache); later calls re-parse
+    // only what changed. Safe to call from several threads.
+    // snapshot: receives a copy of the updated table
+    // fileContent: if given, receives the file content the snapshot describes
+    // Returns: true if the content changed (delta, snapshot and fileContent
+    // are set; the delta replaces no rows if only other text changed)
+    bool refresh(AliasDelta& delta, AliasTable& snapshot, std::string* fileContent = nullptr);
+    
+    // Same, with the new file content supplied by the caller
+    bool update(std::string_view content, AliasDelta& delta, AliasTable& snapshot);
+    
+    // Version of the current table (0 before the first refresh)
+    uint64_t generation() const;
+    
+    // Bytes tokenized by the last refresh or update
+    size_t lastParsedBytes() const;
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    // Replace content with next, re-parsing only around the difference
+    // (mutex held). Returns: true if the content changed
+    bool applyChange(std::string_view next, AliasDelta& delta);
+    
+    mutable std::mutex mutex;       // Guards everything below
+    std::string configPath;         // Tracked file
+    ConfigFileHandler handler;      // Initial full load
+    ShellDetector::Shell shell;     // Grammar for re-parsing
+    std::string content;            // File content the table describes
+    AliasTable table;               // Current table
+    std::vector<CachedDefinition> locations;  // Definition of each row
+    uint64_t currentGeneration = 0; // Bumped on every change
+    bool loaded = false;            // Initial load done
+    size_t parsedBytes = 0;         // Bytes tokenized by the last change
+    std::string lastError;          // Last error message
+};
+
+#endif // ALIASRELOADER_HPP
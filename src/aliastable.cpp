@@ -0,0 +1,327 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Table Component Implementation
+//
+// This file implements the AliasTable class. Text is appended to the arena
+// and never moved relative to its start, so rows only hold 32-bit offsets.
+// The name map uses linear probing over a power-of-two slot array that is
+// kept at most half full.
+// ------------------------------------------------------------------------------
+
+#include "aliastable.hpp"
+#include "hash.hpp"      // Name hashing for the interning map
+#include <algorithm>     // For std::fill
+#include <cstring>       // For std::memcpy
+#include <limits>        // Arena offset limit
+#include <stdexcept>     // For std::length_error
+
+// Minimum number of map slots once the map is in use
+static constexpr size_t kMinSlots = 16;
+
+// ------------------------------------------------------------------------------
+// Reserve Rows and Arena Bytes
+// ------------------------------------------------------------------------------
+void AliasTable::reserve(size_t rows, size_t arenaBytes) {
+    arena.reserve(arenaBytes);
+    names.reserve(rows);
+    commands.reserve(rows);
+    descriptions.reserve(rows);
+    createdDates.reserve(rows);
+    lastUsedDates.reserve(rows);
+    enabledFlags.reserve(rows);
+    lineNumbers.reserve(rows);
+    
+    // Size the map so that rows distinct names fit without rehashing
+    while (slots.size() < 2 * rows) {
+        growMap();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Clear All Rows
+// ------------------------------------------------------------------------------
+void AliasTable::clear() {
+    arena.clear();
+    names.clear();
+    commands.clear();
+    descriptions.clear();
+    createdDates.clear();
+    lastUsedDates.clear();
+    enabledFlags.clear();
+    lineNumbers.clear();
+    std::fill(slots.begin(), slots.end(), 0);
+    distinctNames = 0;
+}
+
+// ------------------------------------------------------------------------------
+// Copy Text into the Arena
+// ------------------------------------------------------------------------------
+AliasTable::Slice AliasTable::store(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    if (arena.size() + text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("AliasTable arena exceeds 4 GiB");
+    }
+    
+    Slice s{static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(text.size())};
+    arena.append(text);
+    return s;
+}
+
+// ------------------------------------------------------------------------------
+// Probe the Name Map
+// Returns the slot holding name, or the first empty slot on its probe path
+// ------------------------------------------------------------------------------
+size_t AliasTable::probe(std::string_view name, uint64_t h) const {
+    const uint32_t tag = static_cast<uint32_t>(h >> 32);
+    const size_t mask = slots.size() - 1;
+    
+    for (size_t i = static_cast<size_t>(h) & mask;; i = (i + 1) & mask) {
+        const uint32_t slot = slots[i];
+        if (slot == 0) {
+            return i;
+        }
+        if (tags[i] == tag && this->name(slot - 1) == name) {
+            return i;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Grow the Name Map
+// ------------------------------------------------------------------------------
+void AliasTable::growMap() {
+    std::vector<uint32_t> oldSlots = std::move(slots);
+    
+    const size_t capacity = oldSlots.empty() ? kMinSlots : oldSlots.size() * 2;
+    slots.assign(capacity, 0);
+    tags.assign(capacity, 0);
+    
+    for (uint32_t slot : oldSlots) {
+        if (slot == 0) continue;
+        const uint64_t h = hash::bytes(name(slot - 1));
+        const size_t i = probe(name(slot - 1), h);
+        slots[i] = slot;
+        tags[i] = static_cast<uint32_t>(h >> 32);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Intern a Name
+// A redefined name reuses the arena bytes of its first definition and the
+// map is pointed at the newest row, matching shell semantics (last wins)
+// ------------------------------------------------------------------------------
+AliasTable::Slice AliasTable::internName(std::string_view name, size_t row) {
+    if ((distinctNames + 1) * 2 > slots.size()) {
+        growMap();
+    }
+    
+    const uint64_t h = hash::bytes(name);
+    const size_t i = probe(name, h);
+    
+    Slice s;
+    if (slots[i] != 0) {
+        s = names[slots[i] - 1];
+    } else {
+        s = store(name);
+        tags[i] = static_cast<uint32_t>(h >> 32);
+        ++distinctNames;
+    }
+    slots[i] = static_cast<uint32_t>(row + 1);
+    return s;
+}
+
+// ------------------------------------------------------------------------------
+// Append a Row
+// ------------------------------------------------------------------------------
+size_t AliasTable::appendRow(std::string_view name, Slice command,
+                             std::string_view description, bool enabled,
+                             std::string_view createdDate, std::string_view lastUsed,
+                             size_t lineNumber) {
+    const size_t row = names.size();
+    
+    names.push_back(internName(name, row));
+    commands.push_back(command);
+    descriptions.push_back(store(description));
+    createdDates.push_back(store(createdDate));
+    lastUsedDates.push_back(store(lastUsed));
+    enabledFlags.push_back(enabled ? 1 : 0);
+    lineNumbers.push_back(static_cast<uint32_t>(lineNumber));
+    return row;
+}
+
+size_t AliasTable::append(std::string_view name, std::string_view command,
+                          std::string_view description, bool enabled,
+                          std::string_view createdDate, std::string_view lastUsed) {
+    return appendRow(name, store(command), description, enabled, createdDate, lastUsed, 0);
+}
+
+size_t AliasTable::append(const Alias& alias) {
+    return append(alias.name, alias.command, alias.description, alias.enabled,
+                  alias.created_date, alias.last_used);
+}
+
+// ------------------------------------------------------------------------------
+// Append a Parsed View
+// Plain commands are copied straight from the source buffer; escaped or
+// quoted ones are resolved through a reused scratch buffer
+// ------------------------------------------------------------------------------
+size_t AliasTable::append(const AliasView& view, size_t lineNumber) {
+    Slice command;
+    if (view.hasEscapes || view.hasQuotes) {
+        view.materializeCommand(scratch);
+        command = store(scratch);
+    } else {
+        command = store(view.command);
+    }
+    return appendRow(view.name, command, {}, true, {}, {}, lineNumber);
+}
+
+// ------------------------------------------------------------------------------
+// Copy a Row from Another Table
+// ------------------------------------------------------------------------------
+size_t AliasTable::append(const AliasTable& source, size_t row, size_t lineNumber) {
+    return appendRow(source.name(row), store(source.command(row)), source.description(row),
+                     source.enabled(row), source.createdDate(row), source.lastUsed(row),
+                     lineNumber);
+}
+
+// ------------------------------------------------------------------------------
+// Find a Name
+// ------------------------------------------------------------------------------
+size_t AliasTable::find(std::string_view name) const {
+    if (slots.empty()) {
+        return npos;
+    }
+    
+    const uint32_t slot = slots[probe(name, hash::bytes(name))];
+    return slot == 0 ? npos : slot - 1;
+}
+
+// ------------------------------------------------------------------------------
+// Materialize Rows
+// ------------------------------------------------------------------------------
+Alias AliasTable::toAlias(size_t row) const {
+    Alias alias;
+    alias.name.assign(name(row));
+    alias.command.assign(command(row));
+    alias.description.assign(description(row));
+    alias.enabled = enabled(row);
+    alias.created_date.assign(createdDate(row));
+    alias.last_used.assign(lastUsed(row));
+    return alias;
+}
+
+std::vector<Alias> AliasTable::toAliases() const {
+    std::vector<Alias> aliases;
+    aliases.reserve(size());
+    for (size_t row = 0; row < size(); ++row) {
+        aliases.push_back(toAlias(row));
+    }
+    return aliases;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Copy a Column into an Image
+// Columns are padded to 8 bytes so every count field stays aligned
+// ------------------------------------------------------------------------------
+template <typename T>
+static void putColumn(std::string& out, const T* data, size_t count) {
+    out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Copy a Column out of an Image
+// Returns false if the image is too short
+// ------------------------------------------------------------------------------
+template <typename T>
+static bool getColumn(std::string_view& in, std::vector<T>& column, size_t count) {
+    const size_t bytes = count * sizeof(T);
+    const size_t padded = (bytes + 7) & ~size_t(7);
+    if (count > in.size() / sizeof(T) || padded > in.size()) {
+        return false;
+    }
+    column.resize(count);
+    if (bytes != 0) {
+        std::memcpy(column.data(), in.data(), bytes);
+    }
+    in.remove_prefix(padded);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Serialize
+// Layout: rows, arena bytes, map slots, distinct names (uint64 each), then
+// the arena and every column, each padded to 8 bytes
+// ------------------------------------------------------------------------------
+void AliasTable::serialize(std::string& out) const {
+    const uint64_t counts[4] = {names.size(), arena.size(), slots.size(), distinctNames};
+    out.reserve(out.size() + sizeof(counts) + arena.size() + 8 +
+                names.size() * (5 * sizeof(Slice) + sizeof(uint32_t) + 1) + 16 +
+                slots.size() * 2 * sizeof(uint32_t));
+    
+    putColumn(out, counts, 4);
+    putColumn(out, arena.data(), arena.size());
+    putColumn(out, names.data(), names.size());
+    putColumn(out, commands.data(), commands.size());
+    putColumn(out, descriptions.data(), descriptions.size());
+    putColumn(out, createdDates.data(), createdDates.size());
+    putColumn(out, lastUsedDates.data(), lastUsedDates.size());
+    putColumn(out, lineNumbers.data(), lineNumbers.size());
+    putColumn(out, enabledFlags.data(), enabledFlags.size());
+    putColumn(out, slots.data(), slots.size());
+    putColumn(out, tags.data(), tags.size());
+}
+
+// ------------------------------------------------------------------------------
+// Deserialize
+// Every slice and map slot is bounds-checked, so a damaged image is
+// rejected instead of producing out-of-range views
+// ------------------------------------------------------------------------------
+bool AliasTable::deserialize(std::string_view data) {
+    clear();
+    
+    std::vector<uint64_t> counts;
+    if (!getColumn(data, counts, 4)) {
+        return false;
+    }
+    const uint64_t rows = counts[0];
+    const uint64_t arenaBytes = counts[1];
+    const uint64_t slotCount = counts[2];
+    if (arenaBytes > data.size() || rows > data.size() || slotCount > data.size() ||
+        (slotCount & (slotCount - 1)) != 0 || counts[3] > slotCount / 2) {
+        return false;
+    }
+    
+    arena.assign(data.data(), static_cast<size_t>(arenaBytes));
+    data.remove_prefix(std::min<size_t>(data.size(), (arenaBytes + 7) & ~uint64_t(7)));
+    
+    const size_t n = static_cast<size_t>(rows);
+    bool ok = getColumn(data, names, n) && getColumn(data, commands, n) &&
+              getColumn(data, descriptions, n) && getColumn(data, createdDates, n) &&
+              getColumn(data, lastUsedDates, n) && getColumn(data, lineNumbers, n) &&
+              getColumn(data, enabledFlags, n) &&
+              getColumn(data, slots, static_cast<size_t>(slotCount)) &&
+              getColumn(data, tags, static_cast<size_t>(slotCount)) && data.empty();
+    
+    auto inArena = [this](const std::vector<Slice>& column) {
+        return std::all_of(column.begin(), column.end(), [this](Slice s) {
+            return uint64_t(s.offset) + s.length <= arena.size();
+        });
+    };
+    ok = ok && inArena(names) && inArena(commands) && inArena(descriptions) &&
+         inArena(createdDates) && inArena(lastUsedDates) &&
+         std::all_of(slots.begin(), slots.end(), [n](uint32_t slot) { return slot <= n; });
+    
+    if (!ok) {
+        clear();
+        slots.clear();
+        tags.clear();
+        return false;
+    }
+    distinctNames = static_cast<size_t>(counts[3]);
+    return true;
+}
@@ -0,0 +1,154 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Table Component Header
+//
+// This header defines the AliasTable class, a compact container for a whole
+// set of aliases. All text (names, commands and metadata) lives in a single
+// bump arena and each row stores offset/length pairs into it, one column
+// per field (struct-of-arrays). Names are interned through an open
+// addressing hash map, so repeated definitions share one name and lookups
+// by name are O(1). Dropping the table releases the arena in one free.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASTABLE_HPP
+#define ALIASTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aliasmanager.hpp"
+
+class AliasTable {
+public:
+    // Returned by find when no alias has the name
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    // --------------------------------------------------------------------------
+    // Capacity
+    // --------------------------------------------------------------------------
+    
+    // Number of rows (every definition, including redefinitions)
+    size_t size() const { return names.size(); }
+    
+    // Check whether the table has no rows
+    bool empty() const { return names.empty(); }
+    
+    // Reserve room for rows and arena bytes up front
+    void reserve(size_t rows, size_t arenaBytes);
+    
+    // Remove all rows, keeping the allocated capacity
+    void clear();
+    
+    // Bytes of text held by the arena
+    size_t arenaSize() const { return arena.size(); }
+    
+    // --------------------------------------------------------------------------
+    // Insertion
+    // --------------------------------------------------------------------------
+    
+    // Append a row with plain text fields
+    // Returns: Index of the new row
+    size_t append(std::string_view name, std::string_view command,
+                  std::string_view description = {}, bool enabled = true,
+                  std::string_view createdDate = {}, std::string_view lastUsed = {});
+    
+    // Append a row from an owning alias
+    size_t append(const Alias& alias);
+    
+    // Append a parsed view, resolving quotes and escapes into the arena
+    // lineNumber records where the definition was found (0 if unknown)
+    size_t append(const AliasView& view, size_t lineNumber = 0);
+    
+    // Copy one row of another table, recording lineNumber for it
+    size_t append(const AliasTable& source, size_t row, size_t lineNumber);
+    
+    // --------------------------------------------------------------------------
+    // Access
+    // --------------------------------------------------------------------------
+    
+    // Field accessors; views stay valid until the next append or clear
+    std::string_view name(size_t row) const { return slice(names[row]); }
+    std::string_view command(size_t row) const { return slice(commands[row]); }
+    std::string_view description(size_t row) const { return slice(descriptions[row]); }
+    std::string_view createdDate(size_t row) const { return slice(createdDates[row]); }
+    std::string_view lastUsed(size_t row) const { return slice(lastUsedDates[row]); }
+    bool enabled(size_t row) const { return enabledFlags[row] != 0; }
+    size_t lineNumber(size_t row) const { return lineNumbers[row]; }
+    
+    // Find the row that defines name (the last one if redefined)
+    // Returns: Row index, or npos if there is none
+    size_t find(std::string_view name) const;
+    
+    // Build an owning Alias from one row
+    Alias toAlias(size_t row) const;
+    
+    // Build owning Aliases for all rows, in row order
+    std::vector<Alias> toAliases() const;
+    
+    // --------------------------------------------------------------------------
+    // Binary Image
+    // --------------------------------------------------------------------------
+    
+    // Append a binary image of the table (arena, columns and name map) to
+    // out. The image is only meant to be read back by the same build.
+    void serialize(std::string& out) const;
+    
+    // Replace the table with an image written by serialize; the arena and
+    // columns are copied in bulk and the name map is not rebuilt
+    // Returns: false (leaving the table empty) if data is not a valid image
+    bool deserialize(std::string_view data);
+
+private:
+    // Location of a string inside the arena
+    struct Slice {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+    
+    std::string_view slice(Slice s) const {
+        return std::string_view(arena.data() + s.offset, s.length);
+    }
+    
+    // Copy text into the arena
+    Slice store(std::string_view text);
+    
+    // Find or add the interned name and point it at row
+    Slice internName(std::string_view name, size_t row);
+    
+    // Map slot holding name (hash h), or the empty slot where it would go
+    size_t probe(std::string_view name, uint64_t h) const;
+    
+    // Double the map capacity and reinsert every interned name
+    void growMap();
+    
+    // Append a row whose command is already in the arena
+    size_t appendRow(std::string_view name, Slice command,
+                     std::string_view description, bool enabled,
+                     std::string_view createdDate, std::string_view lastUsed,
+                     size_t lineNumber);
+    
+    std::string arena;                  // Bump arena holding all text
+    
+    // Columns, one entry per row
+    std::vector<Slice> names;
+    std::vector<Slice> commands;
+    std::vector<Slice> descriptions;
+    std::vector<Slice> createdDates;
+    std::vector<Slice> lastUsedDates;
+    std::vector<uint8_t> enabledFlags;
+    std::vector<uint32_t> lineNumbers;
+    
+    // Open addressing name map: slot = latest row + 1 (0 = empty), with the
+    // high hash bits kept alongside to skip most string comparisons
+    std::vector<uint32_t> slots;
+    std::vector<uint32_t> tags;
+    size_t distinctNames = 0;
+    
+    // Scratch buffer for resolving escaped commands
+    std::string scratch;
+};
+
+#endif // ALIASTABLE_HPP
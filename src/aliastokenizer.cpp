@@ -0,0 +1,363 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Tokenizer Component Implementation
+//
+// This file implements the tokenizer driver. The driver handles the
+// statement keyword check and the bulk skipping of non-alias lines and
+// comments itself (memchr to the next newline); every byte of an alias
+// statement goes through one table lookup, whose actions record the name,
+// value and flag boundaries as the state machine moves forward.
+// ------------------------------------------------------------------------------
+
+#include "aliastokenizer.hpp"
+#include <algorithm> // For std::min
+#include <cstring>   // For std::memchr, std::memcmp
+
+// ------------------------------------------------------------------------------
+// Utility: Check for an Escaped Newline
+// Returns true if the newline at pos is preceded by an odd number of
+// backslashes, i.e. it is a line continuation
+// ------------------------------------------------------------------------------
+static bool isContinuation(const char* data, size_t pos) {
+    size_t backslashes = 0;
+    while (pos > backslashes && data[pos - backslashes - 1] == '\\') {
+        ++backslashes;
+    }
+    return (backslashes & 1) != 0;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Check for a Quote Character
+// ------------------------------------------------------------------------------
+static bool isQuote(char c) {
+    return c == '\'' || c == '"';
+}
+
+// ------------------------------------------------------------------------------
+// Tokenizer Driver
+// Walks the buffer from pos. In single-statement mode it stops as soon as
+// the first statement has ended (the machine is back at a line start).
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+size_t ShellTokenizer<S>::run(std::string_view buffer, size_t pos, size_t lineNumber,
+                              bool singleStatement, std::vector<AliasDefinition>& out) {
+    constexpr size_t npos = std::string_view::npos;
+    
+    const char* data = buffer.data();
+    const size_t size = buffer.size();
+    TokState state = TokState::LineStart;
+    bool started = false;
+    
+    // Boundaries of the statement and definition being tokenized
+    size_t flagBegin = npos;
+    size_t flagEnd = 0;
+    size_t nameBegin = 0;
+    size_t nameEnd = 0;
+    size_t nameLine = 0;
+    size_t valueBegin = 0;
+    size_t lastQuoteClose = npos;
+    unsigned quoteCount = 0;
+    bool escapes = false;
+    size_t statementBegin = pos;
+    size_t statementFirst = out.size();
+    
+    // Record the end of the statement on all of its definitions
+    auto finishStatement = [&](size_t end) {
+        for (size_t i = statementFirst; i < out.size(); ++i) {
+            out[i].statementOffset = statementBegin;
+            out[i].statementEnd = end;
+        }
+        statementFirst = out.size();
+        statementBegin = end;
+    };
+    
+    // Emit the current definition with its value ending at end
+    auto emit = [&](size_t end, TokState from) {
+        std::string_view raw = buffer.substr(valueBegin, end - valueBegin);
+        
+        // Fish values keep inner blanks but not trailing ones
+        if (from == TokState::FishGap) {
+            size_t last = raw.find_last_not_of(" \t");
+            raw = raw.substr(0, last == std::string_view::npos ? 0 : last + 1);
+        }
+        
+        AliasDefinition def;
+        def.view.name = buffer.substr(nameBegin, nameEnd - nameBegin);
+        def.view.hasEscapes = escapes;
+        
+        bool unclosed = from == TokState::SingleQuote || from == TokState::SqEscape ||
+                        from == TokState::DoubleQuote || from == TokState::DqEscape;
+        bool startsQuoted = !raw.empty() && isQuote(raw.front());
+        
+        if (quoteCount == 0) {
+            // Plain word
+            def.view.command = raw;
+        } else if (quoteCount == 1 && startsQuoted && unclosed) {
+            // Unclosed quote - take everything after opening quote
+            def.view.command = raw.substr(1);
+        } else if (quoteCount == 1 && startsQuoted &&
+                   lastQuoteClose == valueBegin + raw.size() - 1) {
+            // Exactly one quoted segment: strip the quotes
+            def.view.command = raw.substr(1, raw.size() - 2);
+        } else {
+            // Concatenated segments: resolved when materialized
+            def.view.command = raw;
+            def.view.hasQuotes = true;
+        }
+        
+        if (flagBegin != npos) {
+            def.flags = buffer.substr(flagBegin, flagEnd - flagBegin);
+        }
+        def.lineNumber = nameLine;
+        def.offset = nameBegin;
+        def.length = valueBegin + raw.size() - nameBegin;
+        out.push_back(def);
+    };
+    
+    while (pos < size) {
+        switch (state) {
+            case TokState::LineStart: {
+                finishStatement(pos);
+                
+                // A single statement is complete once we are back here
+                if (singleStatement && started) {
+                    return pos;
+                }
+                started = true;
+                
+                // Skip indentation and check for the keyword
+                while (pos < size && charclass::has(data[pos], charclass::kBlank)) {
+                    ++pos;
+                }
+                if (size - pos >= 5 && std::memcmp(data + pos, "alias", 5) == 0 &&
+                    (size - pos == 5 ||
+                     kTokClassTable[static_cast<unsigned char>(data[pos + 5])] == TokClass::Blank ||
+                     data[pos + 5] == '\n')) {
+                    state = TokState::Args;
+                    pos += 5;
+                    flagBegin = npos;
+                } else {
+                    state = TokState::Skip;
+                }
+                break;
+            }
+            
+            case TokState::Skip: {
+                // Jump to the next newline that is not a continuation
+                const void* nl = std::memchr(data + pos, '\n', size - pos);
+                if (nl == nullptr) {
+                    pos = size;
+                    break;
+                }
+                size_t at = static_cast<size_t>(static_cast<const char*>(nl) - data);
+                ++lineNumber;
+                pos = at + 1;
+                if (!isContinuation(data, at)) {
+                    state = TokState::LineStart;
+                }
+                break;
+            }
+            
+            case TokState::Comment: {
+                // Comments always end at the next newline
+                const void* nl = std::memchr(data + pos, '\n', size - pos);
+                if (nl == nullptr) {
+                    pos = size;
+                    break;
+                }
+                ++lineNumber;
+                pos = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+                state = TokState::LineStart;
+                break;
+            }
+            
+            default: {
+                // Skip bytes that keep the machine where it is
+                const auto& loop = loops[static_cast<size_t>(state)];
+                while (pos < size && loop[static_cast<unsigned char>(data[pos])]) {
+                    ++pos;
+                }
+                if (pos == size) {
+                    break;
+                }
+                
+                // One table lookup per state-changing byte
+                TokClass cls = kTokClassTable[static_cast<unsigned char>(data[pos])];
+                const TokTransition& tr = table[static_cast<size_t>(state)][static_cast<size_t>(cls)];
+                uint16_t act = tr.actions;
+                
+                if (act != kActNone) {
+                    if (act & kActEndFlag) {
+                        flagEnd = pos;
+                    }
+                    if (act & kActEndName) {
+                        nameEnd = pos;
+                    }
+                    if (act & kActEmit) {
+                        emit(pos, state);
+                    }
+                    if ((act & kActMarkFlag) && flagBegin == npos) {
+                        flagBegin = pos;
+                    }
+                    if (act & kActMarkName) {
+                        nameBegin = pos;
+                        nameLine = lineNumber;
+                        quoteCount = 0;
+                        lastQuoteClose = npos;
+                        escapes = false;
+                    }
+                    if (act & kActMarkValue) {
+                        valueBegin = pos;
+                    }
+                    if (act & kActValueNext) {
+                        valueBegin = pos + 1;
+                    }
+                    if (act & kActQuote) {
+                        ++quoteCount;
+                    }
+                    if (act & kActQuoteClose) {
+                        lastQuoteClose = pos;
+                    }
+                    if (act & kActEscape) {
+                        escapes = true;
+                    }
+                }
+                
+                if (cls == TokClass::Newline) {
+                    ++lineNumber;
+                }
+                state = tr.next;
+                ++pos;
+                break;
+            }
+        }
+    }
+    
+    // End of buffer: finish a value that runs up to it
+    switch (state) {
+        case TokState::ValueStart:
+        case TokState::Unquoted:
+        case TokState::UnqEscape:
+        case TokState::FishGap:
+        case TokState::SingleQuote:
+        case TokState::SqEscape:
+        case TokState::DoubleQuote:
+        case TokState::DqEscape:
+            emit(size, state);
+            break;
+        default:
+            break;
+    }
+    finishStatement(size);
+    
+    return size;
+}
+
+// ------------------------------------------------------------------------------
+// Tokenize Whole Buffer
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+void ShellTokenizer<S>::tokenize(std::string_view buffer, std::vector<AliasDefinition>& out) {
+    run(buffer, 0, 1, false, out);
+}
+
+// ------------------------------------------------------------------------------
+// Tokenize One Statement
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+size_t ShellTokenizer<S>::tokenizeStatement(std::string_view buffer, size_t offset,
+                                            size_t lineNumber,
+                                            std::vector<AliasDefinition>& out) {
+    return run(buffer, offset, lineNumber, true, out);
+}
+
+// Explicit instantiations for all supported shells
+template class ShellTokenizer<ShellDetector::Shell::BASH>;
+template class ShellTokenizer<ShellDetector::Shell::ZSH>;
+template class ShellTokenizer<ShellDetector::Shell::FISH>;
+
+// ------------------------------------------------------------------------------
+// Runtime Dispatch: Whole Buffer
+// ------------------------------------------------------------------------------
+void AliasTokenizer::tokenize(ShellDetector::Shell shell, std::string_view buffer,
+                              std::vector<AliasDefinition>& out) {
+    switch (shell) {
+        case ShellDetector::Shell::ZSH:
+            ShellTokenizer<ShellDetector::Shell::ZSH>::tokenize(buffer, out);
+            break;
+        case ShellDetector::Shell::FISH:
+            ShellTokenizer<ShellDetector::Shell::FISH>::tokenize(buffer, out);
+            break;
+        case ShellDetector::Shell::BASH:
+        case ShellDetector::Shell::UNKNOWN:
+        default:
+            ShellTokenizer<ShellDetector::Shell::BASH>::tokenize(buffer, out);
+            break;
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Runtime Dispatch: Single Statement
+// ------------------------------------------------------------------------------
+size_t AliasTokenizer::tokenizeStatement(ShellDetector::Shell shell, std::string_view buffer,
+                                         size_t offset, size_t lineNumber,
+                                         std::vector<AliasDefinition>& out) {
+    switch (shell) {
+        case ShellDetector::Shell::ZSH:
+            return ShellTokenizer<ShellDetector::Shell::ZSH>::tokenizeStatement(
+                buffer, offset, lineNumber, out);
+        case ShellDetector::Shell::FISH:
+            return ShellTokenizer<ShellDetector::Shell::FISH>::tokenizeStatement(
+                buffer, offset, lineNumber, out);
+        case ShellDetector::Shell::BASH:
+        case ShellDetector::Shell::UNKNOWN:
+        default:
+            return ShellTokenizer<ShellDetector::Shell::BASH>::tokenizeStatement(
+                buffer, offset, lineNumber, out);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Next Safe Line Boundary
+// ------------------------------------------------------------------------------
+size_t AliasTokenizer::nextLineBoundary(std::string_view buffer, size_t pos) {
+    const char* data = buffer.data();
+    const size_t size = buffer.size();
+    
+    // Already at a line start
+    if (pos == 0 || (pos < size && data[pos - 1] == '\n' && !isContinuation(data, pos - 1))) {
+        return pos;
+    }
+    
+    while (pos < size) {
+        const void* nl = std::memchr(data + pos, '\n', size - pos);
+        if (nl == nullptr) {
+            break;
+        }
+        size_t at = static_cast<size_t>(static_cast<const char*>(nl) - data);
+        if (!isContinuation(data, at)) {
+            return at + 1;
+        }
+        pos = at + 1;
+    }
+    return size;
+}
+
+// ------------------------------------------------------------------------------
+// Previous Safe Line Boundary
+// ------------------------------------------------------------------------------
+size_t AliasTokenizer::previousLineBoundary(std::string_view buffer, size_t pos) {
+    pos = std::min(pos, buffer.size());
+    while (pos > 0) {
+        const size_t at = buffer.rfind('\n', pos - 1);
+        if (at == std::string_view::npos) {
+            return 0;
+        }
+        if (!isContinuation(buffer.data(), at)) {
+            return at + 1;
+        }
+        pos = at;
+    }
+    return 0;
+}
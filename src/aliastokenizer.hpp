@@ -0,0 +1,279 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Alias Tokenizer Component Header
+//
+// This header defines a table-driven tokenizer for alias statements. Each
+// supported shell gets its own compile-time transition table (state x
+// character class -> next state + actions), and a single forward pass over
+// the buffer extracts every alias definition, including fish syntax,
+// multi-definition lines, option flags and backslash-newline continuations.
+// The tokenizer never backtracks; each byte is classified and consumed once.
+// ------------------------------------------------------------------------------
+
+#ifndef ALIASTOKENIZER_HPP
+#define ALIASTOKENIZER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "aliasmanager.hpp"
+#include "charclass.hpp"
+#include "shelldetector.hpp"
+
+// ------------------------------------------------------------------------------
+// Structure: AliasDefinition
+// Purpose: One alias definition found by the tokenizer, with its location.
+// ------------------------------------------------------------------------------
+struct AliasDefinition {
+    AliasView view;            // Name and command slices of the buffer
+    std::string_view flags;    // Option words before the name (e.g. "-g")
+    size_t lineNumber = 0;     // 1-based line on which the name appears
+    size_t offset = 0;         // Byte offset of the name
+    size_t length = 0;         // Bytes from the name to the end of the value
+    size_t statementOffset = 0;  // Start of the line holding the statement
+    size_t statementEnd = 0;     // Just past the statement's final newline
+};
+
+// ------------------------------------------------------------------------------
+// Tokenizer States (character classes live in charclass.hpp)
+// ------------------------------------------------------------------------------
+enum class TokState : uint8_t {
+    LineStart,    // Start of a line, keyword check pending (driver handled)
+    Skip,         // Rest of a non-alias line
+    Comment,      // Comment up to the end of the line
+    Args,         // Between words of an alias statement
+    ArgsEscape,   // Backslash between words (continuation if newline follows)
+    Flag,         // Option word such as -g or --
+    Junk,         // Word that is neither a flag nor a valid definition
+    Name,         // Alias name
+    FishSep,      // Blanks between name and value (fish syntax)
+    ValueStart,   // Directly after '='
+    Unquoted,     // Unquoted part of a value
+    UnqEscape,    // Backslash in an unquoted value
+    FishGap,      // Blanks inside a fish value (may be trailing)
+    SingleQuote,  // Inside '...'
+    SqEscape,     // Backslash inside '...' (fish only)
+    DoubleQuote,  // Inside "..."
+    DqEscape,     // Backslash inside "..."
+    Count
+};
+
+// Actions attached to a transition (bit flags, applied in this order)
+enum TokAction : uint16_t {
+    kActNone       = 0,
+    kActEndFlag    = 1 << 0,   // Flag word ends before this byte
+    kActEndName    = 1 << 1,   // Name ends before this byte
+    kActEmit       = 1 << 2,   // Value ends before this byte; emit definition
+    kActMarkFlag   = 1 << 3,   // Flag word starts at this byte
+    kActMarkName   = 1 << 4,   // Name starts at this byte
+    kActMarkValue  = 1 << 5,   // Value starts at this byte
+    kActValueNext  = 1 << 6,   // Value starts after this byte
+    kActQuote      = 1 << 7,   // A quoted segment opens at this byte
+    kActQuoteClose = 1 << 8,   // A quoted segment closes at this byte
+    kActEscape     = 1 << 9    // Value contains a backslash escape
+};
+
+struct TokTransition {
+    TokState next = TokState::Skip;
+    uint16_t actions = kActNone;
+};
+
+inline constexpr size_t kTokStates = static_cast<size_t>(TokState::Count);
+inline constexpr size_t kTokClasses = static_cast<size_t>(TokClass::Count);
+
+using TokTable = std::array<std::array<TokTransition, kTokClasses>, kTokStates>;
+
+// ------------------------------------------------------------------------------
+// Transition Table Builder
+// BASH and ZSH share one grammar; FISH differs in three places:
+// - 'alias name value' is accepted (blank after the name starts the value)
+// - the value runs to the end of the line, blanks included
+// - backslash escapes are recognised inside single quotes
+// ------------------------------------------------------------------------------
+constexpr TokTable buildTokTable(ShellDetector::Shell shell) {
+    const bool fish = (shell == ShellDetector::Shell::FISH);
+    TokTable t{};
+    
+    auto set = [&t](TokState s, TokClass c, TokState next, uint16_t actions = kActNone) {
+        t[static_cast<size_t>(s)][static_cast<size_t>(c)] = {next, actions};
+    };
+    auto setAll = [&t](TokState s, TokState next, uint16_t actions = kActNone) {
+        for (auto& entry : t[static_cast<size_t>(s)]) {
+            entry = {next, actions};
+        }
+    };
+    
+    using S = TokState;
+    using C = TokClass;
+    
+    // Non-alias lines and comments run to the newline
+    setAll(S::Skip, S::Skip);
+    set(S::Skip, C::Newline, S::LineStart);
+    setAll(S::Comment, S::Comment);
+    set(S::Comment, C::Newline, S::LineStart);
+    setAll(S::LineStart, S::Skip);
+    
+    // Between words: flags, names, comments, continuations
+    setAll(S::Args, S::Junk);
+    set(S::Args, C::Blank, S::Args);
+    set(S::Args, C::Newline, S::LineStart);
+    set(S::Args, C::Hash, S::Comment);
+    set(S::Args, C::Separator, S::Skip);
+    set(S::Args, C::Backslash, S::ArgsEscape);
+    set(S::Args, C::Dash, S::Flag, kActMarkFlag);
+    set(S::Args, C::Other, S::Name, kActMarkName);
+    setAll(S::ArgsEscape, S::Junk);
+    set(S::ArgsEscape, C::Newline, S::Args);
+    
+    // Flag and junk words end at a blank
+    setAll(S::Flag, S::Flag);
+    set(S::Flag, C::Blank, S::Args, kActEndFlag);
+    set(S::Flag, C::Newline, S::LineStart, kActEndFlag);
+    set(S::Flag, C::Separator, S::Skip, kActEndFlag);
+    setAll(S::Junk, S::Junk);
+    set(S::Junk, C::Blank, S::Args);
+    set(S::Junk, C::Newline, S::LineStart);
+    set(S::Junk, C::Separator, S::Skip);
+    
+    // Name: '=' starts the value; a name without one is a query and is dropped
+    // (in fish a blank after the name starts the value instead)
+    setAll(S::Name, S::Junk);
+    set(S::Name, C::Other, S::Name);
+    set(S::Name, C::Dash, S::Name);
+    set(S::Name, C::Equals, S::ValueStart, kActEndName | kActValueNext);
+    set(S::Name, C::Newline, S::LineStart);
+    set(S::Name, C::Separator, S::Skip);
+    if (fish) {
+        set(S::Name, C::Blank, S::FishSep, kActEndName);
+    } else {
+        set(S::Name, C::Blank, S::Args);
+    }
+    
+    // Fish: blanks between name and value
+    setAll(S::FishSep, S::Unquoted, kActMarkValue);
+    set(S::FishSep, C::Blank, S::FishSep);
+    set(S::FishSep, C::Newline, S::LineStart);
+    set(S::FishSep, C::Hash, S::Comment);
+    set(S::FishSep, C::Separator, S::Skip);
+    set(S::FishSep, C::SingleQuote, S::SingleQuote, kActMarkValue | kActQuote);
+    set(S::FishSep, C::DoubleQuote, S::DoubleQuote, kActMarkValue | kActQuote);
+    set(S::FishSep, C::Backslash, S::UnqEscape, kActMarkValue | kActEscape);
+    
+    // Value body shared by ValueStart, Unquoted and FishGap
+    const uint16_t endOfWord = fish ? kActNone : kActEmit;
+    for (S s : {S::ValueStart, S::Unquoted, S::FishGap}) {
+        setAll(s, S::Unquoted);
+        set(s, C::Blank, fish ? S::FishGap : S::Args, endOfWord);
+        set(s, C::Newline, S::LineStart, kActEmit);
+        set(s, C::Separator, S::Skip, kActEmit);
+        set(s, C::SingleQuote, S::SingleQuote, kActQuote);
+        set(s, C::DoubleQuote, S::DoubleQuote, kActQuote);
+        set(s, C::Backslash, S::UnqEscape, kActEscape);
+    }
+    // A '#' after a blank starts a comment only where blanks are kept
+    set(S::FishGap, C::Hash, S::Comment, kActEmit);
+    if (fish) {
+        set(S::ValueStart, C::Blank, S::Args, kActEmit);
+    }
+    
+    // Escaped byte in an unquoted value (newline = continuation)
+    setAll(S::UnqEscape, S::Unquoted);
+    
+    // Single quotes: literal in bash/zsh, \' and \\ escapes in fish
+    setAll(S::SingleQuote, S::SingleQuote);
+    set(S::SingleQuote, C::SingleQuote, S::Unquoted, kActQuoteClose);
+    set(S::SingleQuote, C::Backslash, fish ? S::SqEscape : S::SingleQuote, kActEscape);
+    setAll(S::SqEscape, S::SingleQuote);
+    
+    // Double quotes with backslash escapes
+    setAll(S::DoubleQuote, S::DoubleQuote);
+    set(S::DoubleQuote, C::DoubleQuote, S::Unquoted, kActQuoteClose);
+    set(S::DoubleQuote, C::Backslash, S::DqEscape, kActEscape);
+    setAll(S::DqEscape, S::DoubleQuote);
+    
+    return t;
+}
+
+// ------------------------------------------------------------------------------
+// Self-Loop Table Builder
+// For every state, marks the bytes that leave the machine in the same state
+// with no action (and are not newlines, which are counted). The driver skips
+// runs of such bytes without consulting the transition table.
+// ------------------------------------------------------------------------------
+using TokLoopTable = std::array<std::array<bool, 256>, kTokStates>;
+
+constexpr TokLoopTable buildTokLoopTable(const TokTable& table) {
+    TokLoopTable loops{};
+    for (size_t s = 0; s < kTokStates; ++s) {
+        for (size_t c = 0; c < 256; ++c) {
+            TokClass cls = kTokClassTable[c];
+            const TokTransition& tr = table[s][static_cast<size_t>(cls)];
+            loops[s][c] = static_cast<size_t>(tr.next) == s && tr.actions == kActNone &&
+                          cls != TokClass::Newline;
+        }
+    }
+    return loops;
+}
+
+// ------------------------------------------------------------------------------
+// Class Template: ShellTokenizer
+// Purpose: Tokenizer specialised for one shell at compile time.
+// ------------------------------------------------------------------------------
+template <ShellDetector::Shell S>
+class ShellTokenizer {
+public:
+    // Tokenize a whole buffer, appending every definition to out
+    static void tokenize(std::string_view buffer, std::vector<AliasDefinition>& out);
+    
+    // Tokenize the single statement that starts at offset (line lineNumber)
+    // Follows continuations and multi-definition lines
+    // Returns: Offset just past the end of the statement
+    static size_t tokenizeStatement(std::string_view buffer, size_t offset,
+                                    size_t lineNumber,
+                                    std::vector<AliasDefinition>& out);
+
+private:
+    // Shared driver for both entry points
+    static size_t run(std::string_view buffer, size_t pos, size_t lineNumber,
+                      bool singleStatement, std::vector<AliasDefinition>& out);
+    
+    static constexpr TokTable table = buildTokTable(S);
+    static constexpr TokLoopTable loops = buildTokLoopTable(table);
+};
+
+extern template class ShellTokenizer<ShellDetector::Shell::BASH>;
+extern template class ShellTokenizer<ShellDetector::Shell::ZSH>;
+extern template class ShellTokenizer<ShellDetector::Shell::FISH>;
+
+// ------------------------------------------------------------------------------
+// Class: AliasTokenizer
+// Purpose: Runtime entry points that dispatch to the matching ShellTokenizer.
+// UNKNOWN shells use the BASH grammar.
+// ------------------------------------------------------------------------------
+class AliasTokenizer {
+public:
+    // Tokenize a whole buffer for the given shell
+    static void tokenize(ShellDetector::Shell shell, std::string_view buffer,
+                         std::vector<AliasDefinition>& out);
+    
+    // Tokenize the statement starting at offset for the given shell
+    // Returns: Offset just past the end of the statement
+    static size_t tokenizeStatement(ShellDetector::Shell shell, std::string_view buffer,
+                                    size_t offset, size_t lineNumber,
+                                    std::vector<AliasDefinition>& out);
+    
+    // Find the first line start at or after pos whose previous line does
+    // not end in a continuation (a safe place to split the buffer)
+    // Returns: Offset of that line start, or buffer.size() if there is none
+    static size_t nextLineBoundary(std::string_view buffer, size_t pos);
+    
+    // Find the start of the line holding pos, moving further back while the
+    // line before ends in a continuation
+    // Returns: Offset of that line start (0 at the beginning of the buffer)
+    static size_t previousLineBoundary(std::string_view buffer, size_t pos);
+};
+
+#endif // ALIASTOKENIZER_HPP
@@ -0,0 +1,366 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Atomic File Writer Component Implementation
+//
+// This file implements AtomicWriter and SyncGroup. The order of operations
+// is what makes the replacement crash-safe: data is flushed before the
+// rename, and the directory is flushed after it, so after a crash the
+// target name refers to either the complete old or the complete new file.
+// ------------------------------------------------------------------------------
+
+#include "atomicwriter.hpp"
+#include <algorithm>       // For std::find, std::min
+#include <atomic>          // Unique temporary names
+#include <cerrno>          // For errno
+#include <cstring>         // For std::strerror
+#include <fcntl.h>         // For open, openat, O_TMPFILE
+#include <filesystem>      // Symlink resolution
+#include "syscalls.hpp"    // Counted open, stat, chmod, link, rename, xattr
+#include <unistd.h>        // For fsync, fdatasync, close
+#include <utility>         // For std::pair
+
+namespace fs = std::filesystem;
+
+// Chunk size when copy_file_range is unavailable
+static constexpr size_t kCopyChunk = 64 * 1024;
+
+// ------------------------------------------------------------------------------
+// Utility: Describe errno
+// ------------------------------------------------------------------------------
+static std::string errnoText(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Temporary Name for a Target
+// Hidden sibling of the target, unique within this process
+// ------------------------------------------------------------------------------
+static std::string makeTempName(const std::string& baseName) {
+    static std::atomic<unsigned> counter{0};
+    return "." + baseName + ".aliacan-" + std::to_string(getpid()) + "-" +
+           std::to_string(counter.fetch_add(1));
+}
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+AtomicWriter::AtomicWriter(const std::string& targetPath) : target(targetPath) {
+    // Replace the file a symlink points to, not the link itself
+    std::error_code ec;
+    fs::path resolved = fs::canonical(targetPath, ec);
+    if (!ec) {
+        target = resolved.string();
+    }
+    baseName = fs::path(target).filename().string();
+}
+
+AtomicWriter::AtomicWriter(int dirFd, const std::string& name, int sourceFd)
+    : target(name), baseName(name), dirFd(dirFd), ownsDir(false), sourceFd(sourceFd) {
+}
+
+// ------------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------------
+AtomicWriter::~AtomicWriter() {
+    abort();
+    if (fileFd >= 0) close(fileFd);
+    if (dirFd >= 0 && ownsDir) close(dirFd);
+}
+
+// ------------------------------------------------------------------------------
+// Open the Temporary File
+// ------------------------------------------------------------------------------
+bool AtomicWriter::open() {
+    if (ownsDir) {
+        fs::path dir = fs::path(target).parent_path();
+        if (dir.empty()) dir = ".";
+        
+        dirFd = syscalls::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd < 0) {
+            lastError = errnoText("Cannot open directory " + dir.string());
+            return false;
+        }
+    }
+
+#ifdef O_TMPFILE
+    // Unnamed file: invisible until it is complete
+    fileFd = syscalls::openat(dirFd, ".", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fileFd >= 0) {
+        unnamed = true;
+        return true;
+    }
+#endif
+    
+    // Filesystem without O_TMPFILE: hidden sibling
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        tempName = makeTempName(baseName);
+        fileFd = syscalls::openat(dirFd, tempName.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fileFd >= 0) {
+            return true;
+        }
+        if (errno != EEXIST) break;
+    }
+    tempName.clear();
+    lastError = errnoText("Cannot create temporary file for " + target);
+    return false;
+}
+
+// ------------------------------------------------------------------------------
+// Append Bytes
+// ------------------------------------------------------------------------------
+bool AtomicWriter::write(std::string_view data) {
+    while (!data.empty()) {
+        ssize_t n = ::write(fileFd, data.data(), data.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            lastError = errnoText("Cannot write temporary file");
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Append a Range of Another File
+// ------------------------------------------------------------------------------
+bool AtomicWriter::copyRange(int srcFd, uint64_t offset, uint64_t length) {
+    off_t in = static_cast<off_t>(offset);
+    
+    while (length > 0) {
+        ssize_t n = copy_file_range(srcFd, &in, fileFd, nullptr, static_cast<size_t>(length), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;  // Unsupported here, or source ended early
+        length -= static_cast<uint64_t>(n);
+    }
+    
+    // Fallback: copy through a buffer
+    std::string chunk;
+    while (length > 0) {
+        chunk.resize(static_cast<size_t>(std::min<uint64_t>(length, kCopyChunk)));
+        ssize_t n = pread(srcFd, chunk.data(), chunk.size(), in);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            lastError = n == 0 ? "Source file ended early" : errnoText("Cannot read source file");
+            return false;
+        }
+        if (!write(std::string_view(chunk.data(), static_cast<size_t>(n)))) {
+            return false;
+        }
+        in += n;
+        length -= static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Copy Metadata from the Target
+// A new target gets mode 0644. Owner and attribute copies that need
+// privileges (e.g. security.* attributes) are best effort.
+// ------------------------------------------------------------------------------
+bool AtomicWriter::copyMetadata() {
+    struct stat st;
+    const int statResult = sourceFd >= 0
+        ? syscalls::fstat(sourceFd, &st)
+        : syscalls::fstatat(dirFd, baseName.c_str(), &st, 0);
+    if (statResult != 0) {
+        if (errno != ENOENT) {
+            lastError = errnoText("Cannot stat " + target);
+            return false;
+        }
+        syscalls::fchmod(fileFd, 0644);
+        return true;
+    }
+    
+    if (syscalls::fchmod(fileFd, st.st_mode & 07777) != 0) {
+        lastError = errnoText("Cannot set mode on temporary file");
+        return false;
+    }
+    
+    struct stat own;
+    if (syscalls::fstat(fileFd, &own) == 0 &&
+        (own.st_uid != st.st_uid || own.st_gid != st.st_gid)) {
+        if (syscalls::fchown(fileFd, st.st_uid, st.st_gid) == 0) {
+            syscalls::fchmod(fileFd, st.st_mode & 07777);  // chown clears setuid/setgid
+        }
+    }
+    
+    // Extended attributes, read through a descriptor of the current file
+    const int source = sourceFd >= 0
+        ? sourceFd
+        : syscalls::openat(dirFd, baseName.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (source < 0) {
+        return true;
+    }
+    ssize_t listSize = syscalls::flistxattr(source, nullptr, 0);
+    if (listSize > 0) {
+        std::string names(static_cast<size_t>(listSize), '\0');
+        listSize = syscalls::flistxattr(source, names.data(), names.size());
+        std::string value;
+        for (size_t pos = 0; listSize > 0 && pos < static_cast<size_t>(listSize);) {
+            const char* name = names.c_str() + pos;
+            pos += std::strlen(name) + 1;
+            
+            ssize_t valueSize = syscalls::fgetxattr(source, name, nullptr, 0);
+            if (valueSize < 0) continue;
+            value.resize(static_cast<size_t>(valueSize));
+            valueSize = syscalls::fgetxattr(source, name, value.data(), value.size());
+            if (valueSize < 0) continue;
+            syscalls::fsetxattr(fileFd, name, value.data(), static_cast<size_t>(valueSize), 0);
+        }
+    }
+    if (source != sourceFd) {
+        close(source);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Publish Under the Target Name
+// An O_TMPFILE file is first linked under a temporary name (rename needs a
+// name to move); then the temporary name is renamed over the target
+// ------------------------------------------------------------------------------
+bool AtomicWriter::publish() {
+    if (unnamed) {
+        const std::string procPath = "/proc/self/fd/" + std::to_string(fileFd);
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            tempName = makeTempName(baseName);
+            if (syscalls::linkat(fileFd, "", dirFd, tempName.c_str(), AT_EMPTY_PATH) == 0 ||
+                syscalls::linkat(AT_FDCWD, procPath.c_str(), dirFd, tempName.c_str(),
+                       AT_SYMLINK_FOLLOW) == 0) {
+                unnamed = false;
+                break;
+            }
+            if (errno != EEXIST) break;
+        }
+        if (unnamed) {
+            tempName.clear();
+            lastError = errnoText("Cannot link temporary file for " + target);
+            return false;
+        }
+    }
+    
+    if (syscalls::renameat(dirFd, tempName.c_str(), dirFd, baseName.c_str()) != 0) {
+        lastError = errnoText("Cannot replace " + target);
+        return false;
+    }
+    tempName.clear();
+    committed = true;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Commit
+// ------------------------------------------------------------------------------
+bool AtomicWriter::commit() {
+    if (fileFd < 0) {
+        lastError = "Writer is not open";
+        return false;
+    }
+    if (!copyMetadata()) {
+        return false;
+    }
+    if (fsync(fileFd) != 0) {
+        lastError = errnoText("Cannot flush temporary file");
+        return false;
+    }
+    if (!publish()) {
+        return false;
+    }
+    fsync(dirFd);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Abort
+// ------------------------------------------------------------------------------
+void AtomicWriter::abort() {
+    if (committed) return;
+    
+    // An unnamed file disappears with its descriptor; a named one is removed
+    if (!tempName.empty() && dirFd >= 0) {
+        syscalls::unlinkat(dirFd, tempName.c_str(), 0);
+        tempName.clear();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// SyncGroup: Add a Writer
+// ------------------------------------------------------------------------------
+AtomicWriter* SyncGroup::add(const std::string& path) {
+    auto writer = std::make_unique<AtomicWriter>(path);
+    if (!writer->open()) {
+        lastError = writer->getLastError();
+        return nullptr;
+    }
+    writers.push_back(writer.get());
+    owned.push_back(std::move(writer));
+    return writers.back();
+}
+
+void SyncGroup::add(AtomicWriter& writer) {
+    writers.push_back(&writer);
+}
+
+// ------------------------------------------------------------------------------
+// SyncGroup: Add a Step Run After the Commit
+// ------------------------------------------------------------------------------
+void SyncGroup::afterCommit(std::function<void()> step) {
+    steps.push_back(std::move(step));
+}
+
+// ------------------------------------------------------------------------------
+// SyncGroup: Commit All Writers
+// Only the files' data and size must be durable before the renames; their
+// mode and owner reach the disk with the directory sync that follows. So
+// fdatasync suffices, and no other file on the filesystem is flushed
+// ------------------------------------------------------------------------------
+bool SyncGroup::commit() {
+    // Writers not yet published are discarded on failure
+    auto reset = [this] {
+        writers.clear();
+        owned.clear();
+        steps.clear();
+    };
+    auto fail = [this, &reset](const std::string& error) {
+        lastError = error;
+        reset();
+        return false;
+    };
+    
+    for (AtomicWriter* writer : writers) {
+        if (writer->fd() < 0) {
+            return fail("Writer is not open");
+        }
+        if (!writer->copyMetadata()) {
+            return fail(writer->getLastError());
+        }
+        if (fdatasync(writer->fd()) != 0) {
+            return fail(errnoText("Cannot flush " + writer->targetPath()));
+        }
+    }
+    
+    // Publish, then sync every distinct directory once
+    std::vector<std::pair<dev_t, ino_t>> dirs;
+    for (AtomicWriter* writer : writers) {
+        if (!writer->publish()) {
+            return fail(writer->getLastError());
+        }
+        if (writers.size() > 1) {
+            struct stat st;
+            if (syscalls::fstat(writer->dirFd, &st) != 0) continue;
+            std::pair<dev_t, ino_t> id{st.st_dev, st.st_ino};
+            if (std::find(dirs.begin(), dirs.end(), id) != dirs.end()) continue;
+            dirs.push_back(id);
+        }
+        fsync(writer->dirFd);
+    }
+    
+    std::vector<std::function<void()>> done = std::move(steps);
+    reset();
+    for (const std::function<void()>& step : done) {
+        step();
+    }
+    return true;
+}
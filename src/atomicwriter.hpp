@@ -0,0 +1,139 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Atomic File Writer Component Header
+//
+// This header defines the AtomicWriter and SyncGroup classes, which replace
+// files crash-safely. New content is written to an unnamed O_TMPFILE (or a
+// hidden temporary sibling where that is unsupported), flushed, given the
+// target's mode, owner and extended attributes, and renamed over the target.
+// Readers therefore see either the old or the new file, never a partial one.
+// A SyncGroup commits several writers together, syncing each directory once.
+// ------------------------------------------------------------------------------
+
+#ifndef ATOMICWRITER_HPP
+#define ATOMICWRITER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class AtomicWriter {
+public:
+    // --------------------------------------------------------------------------
+    // Constructor & Destructor
+    // --------------------------------------------------------------------------
+    
+    // Prepare to replace targetPath (a symlink is replaced at its destination)
+    explicit AtomicWriter(const std::string& targetPath);
+    
+    // Prepare to replace name inside the open directory dirFd (borrowed, not
+    // closed; no path is resolved). Mode, owner and attributes are taken
+    // from sourceFd, an open descriptor of the current file, when given
+    AtomicWriter(int dirFd, const std::string& name, int sourceFd = -1);
+    
+    // Discards the temporary file unless the write was committed
+    ~AtomicWriter();
+    
+    AtomicWriter(const AtomicWriter&) = delete;
+    AtomicWriter& operator=(const AtomicWriter&) = delete;
+    
+    // --------------------------------------------------------------------------
+    // Writing
+    // --------------------------------------------------------------------------
+    
+    // Create the temporary file next to the target
+    // Returns: true if the writer is ready for content
+    bool open();
+    
+    // Append bytes to the new content
+    bool write(std::string_view data);
+    
+    // Append length bytes of srcFd starting at offset (copy_file_range,
+    // so the kernel can share or copy the blocks without a user buffer)
+    bool copyRange(int srcFd, uint64_t offset, uint64_t length);
+    
+    // Flush the content and atomically put it in place of the target
+    // Returns: true once the new file is durable under the target name
+    bool commit();
+    
+    // Drop the new content and leave the target untouched
+    void abort();
+    
+    // --------------------------------------------------------------------------
+    // Accessors
+    // --------------------------------------------------------------------------
+    
+    // Descriptor of the new file (still valid after commit)
+    int fd() const { return fileFd; }
+    
+    // Path that is replaced (symlinks resolved)
+    const std::string& targetPath() const { return target; }
+    
+    // Get the last error message
+    std::string getLastError() const { return lastError; }
+
+private:
+    friend class SyncGroup;
+    
+    // Copy mode, owner and extended attributes from the current target
+    bool copyMetadata();
+    
+    // Give the temporary file a name (if unnamed) and rename it over the target
+    bool publish();
+    
+    std::string target;          // Resolved target path
+    std::string baseName;        // Target file name inside its directory
+    std::string tempName;        // Temporary name once linked or created
+    int dirFd = -1;              // Directory holding the target
+    bool ownsDir = true;         // dirFd is closed with the writer
+    int sourceFd = -1;           // Open current target (metadata source)
+    int fileFd = -1;             // New content
+    bool unnamed = false;        // Created with O_TMPFILE and not yet linked
+    bool committed = false;      // Rename done
+    std::string lastError;       // Last error message
+};
+
+// ------------------------------------------------------------------------------
+// Class: SyncGroup
+// Purpose: Commit several atomic writes together. Every new file's data is
+// flushed (fdatasync) before any is renamed; the renames happen in the
+// order the writers were added, then each distinct directory is synced
+// once. Each target may appear only once.
+// ------------------------------------------------------------------------------
+class SyncGroup {
+public:
+    // Start a new atomic write of path in this group
+    // Returns: The opened writer, or nullptr on failure (see getLastError)
+    AtomicWriter* add(const std::string& path);
+    
+    // Add an opened writer owned by the caller; it must outlive the commit
+    // and is still usable (fd) afterwards
+    void add(AtomicWriter& writer);
+    
+    // Run step after a successful commit, once every write is durable
+    void afterCommit(std::function<void()> step);
+    
+    // Number of pending writers
+    size_t size() const { return writers.size(); }
+    
+    // Flush and publish every writer, then run the afterCommit steps; the
+    // group is empty afterwards
+    // Returns: true if all writes were committed (on failure, writes not
+    // yet published are discarded and no step runs)
+    bool commit();
+    
+    // Get the last error message
+    std::string getLastError() const { return lastError; }
+
+private:
+    std::vector<AtomicWriter*> writers;                 // Pending writes, in order
+    std::vector<std::unique_ptr<AtomicWriter>> owned;   // Writers created by add(path)
+    std::vector<std::function<void()>> steps;           // Run after the commit
+    std::string lastError;                              // Last error message
+};
+
+#endif // ATOMICWRITER_HPP
@@ -5,159 +5,528 @@
 // 
 // This file implements the BackupManager class, providing comprehensive
 // backup management with compression, rotation, and restoration features.
-// It uses XZ compression for space efficiency and maintains backup
-// organization in ~/.shellbackup/ directory.
+// It uses XZ compression (in-process, through XzCodec) for space
+// efficiency and maintains backup organization in ~/.shellbackup/ directory.
+// The asynchronous worker processes snapshots in the order they were taken
+// and does its rotation through a private BackupManager, so errors it hits
+// never touch the caller's state until flush hands them over. Storing a
+// snapshot and rotating the store happen under the store lock, since the
+// store is shared with the backup managers of other files. Each manager
+// keeps one BackupStore, so the manifest is parsed once and then only
+// followed.
 // ------------------------------------------------------------------------------
 
 #include "backupmanager.hpp"
-#include <cstdlib>    // For std::system
+#include "backupstore.hpp"   // Content-addressed backup objects
+#include "hash.hpp"          // Store names
+#include "filelock.hpp"  // Restores are serialised with other writers
+#include "xzcodec.hpp"   // In-process .xz compression
+#include "atomicwriter.hpp"  // Restored objects
+#include "mappedfile.hpp"    // Snapshot of the original
+#include <cstdio>     // For std::snprintf
+#include <cstdlib>    // For std::getenv
+#include <condition_variable>  // Worker queue signalling
+#include <deque>      // Worker queue
+#include <fcntl.h>    // For open
+#include <mutex>      // Worker queue lock
+#include <unordered_set>  // States kept uncompressed
+#include <thread>     // Worker thread
+#include <unistd.h>   // For close
 #include <filesystem> // For filesystem operations
 #include <fstream>    // For file I/O
 #include <chrono>     // For timestamps
 #include <algorithm>  // For sorting
 #include <vector>     // For backup lists
-#include <sstream>    // For string formatting
-#include <iomanip>    // For timestamp formatting
 
 // Alias for convenience
 namespace fs = std::filesystem;
 
+// Backups kept by the rotation after each new backup
+static constexpr int kMaxBackups = 20;
+
+// ------------------------------------------------------------------------------
+// Structure: BackupManager::Worker
+// Purpose: Snapshot queue and background thread of the asynchronous mode.
+// ------------------------------------------------------------------------------
+struct BackupManager::Worker {
+    // One snapshot waiting to be stored
+    struct Job {
+        std::string hash;          // Object name of bytes
+        std::string bytes;         // Content of the original when taken
+        int64_t timeNs = 0;        // When it was taken
+        int level = 9;             // Compression settings for the rotation
+        bool extreme = true;
+    };
+    
+    std::mutex mutex;                  // Guards everything below
+    std::condition_variable changed;   // Signals new jobs, progress and stop
+    std::deque<Job> jobs;              // Snapshots in the order taken
+    bool busy = false;                 // A job is being written
+    bool stopping = false;             // Set by the destructor
+    std::string error;                 // First failure since the last flush
+    std::thread thread;                // Runs workerLoop
+};
+
 // ------------------------------------------------------------------------------
 // Constructor
 // ------------------------------------------------------------------------------
 BackupManager::BackupManager(const std::string& originalFilePath) 
     : originalFilePath(originalFilePath) {
     // Store the path to the file we'll be backing up
+    storeName = getStoreName();
+}
+
+// ------------------------------------------------------------------------------
+// Destructor
+// The worker drains the queue before it exits, so no snapshot is lost
+// ------------------------------------------------------------------------------
+BackupManager::~BackupManager() {
+    if (!worker) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->stopping = true;
+    }
+    worker->changed.notify_all();
+    worker->thread.join();
 }
 
 // ------------------------------------------------------------------------------
 // Create Backup
 // Steps:
 // 1. Validate original file exists
-// 2. Generate backup path with timestamp
-// 3. Copy file to backup location
+// 2. Read its bytes and name them by their hash
+// 3. Store the object and record the state in the manifest
 // 4. Trigger cleanup/compression of old backups
+// In asynchronous mode steps 3 and 4 are queued for the worker after the
+// file's bytes have been read
 // ------------------------------------------------------------------------------
-std::string BackupManager::createBackup() {
+std::string BackupManager::createBackup(SyncGroup* group) {
     // Check if original file exists
     if (!fs::exists(originalFilePath)) {
         lastError = "Original file does not exist: " + originalFilePath;
         return "";
     }
     
-    // Generate backup path: ~/.shellbackup/filename.bakYYYYMMDD_HHMMSS
-    std::string backupDir = getBackupDirectory();
-    std::string backupFilename = fs::path(originalFilePath).filename().string() + 
-                                 ".bak" + generateTimestamp();
-    std::string backupPath = fs::path(backupDir) / backupFilename;
+    // Snapshot the bytes; the object name follows from them
+    MappedFile file;
+    if (!file.open(originalFilePath)) {
+        lastError = "Failed to create backup: cannot read " + originalFilePath;
+        return "";
+    }
+    const std::string_view bytes = file.view();
+    const std::string hash = BackupStore::hashOf(bytes);
+    const int64_t timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
     
-    try {
-        // Create backup by copying the file
-        fs::copy_file(originalFilePath, backupPath, 
-                     fs::copy_options::overwrite_existing);
+    if (async) {
+        // Everything slow happens on the worker
+        Worker::Job job;
+        job.hash = hash;
+        job.bytes.assign(bytes);
+        job.timeNs = timeNs;
+        job.level = compressionLevel;
+        job.extreme = compressionExtreme;
         
-        // Clean up old backups to prevent unlimited growth
-        cleanupAndCompressOldBackups(20);
+        // Where the object is, or will be once the worker has stored it
+        // (restoreFromBackup also finds it there if it becomes a delta)
+        BackupStore& store = backupStore();
+        std::string backupPath = store.objectPath(hash);
+        if (backupPath.empty()) {
+            backupPath = store.rawPath(hash);
+        }
         
-        return backupPath;
+        if (!worker) {
+            worker = std::make_unique<Worker>();
+            worker->thread = std::thread(&BackupManager::workerLoop, this);
+        }
         
-    } catch (const std::exception& e) {
-        lastError = std::string("Failed to create backup: ") + e.what();
+        // Back-pressure: wait for room rather than queue without bound
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->changed.wait(lock, [this] { return worker->jobs.size() < kMaxPendingBackups; });
+        worker->jobs.push_back(std::move(job));
+        worker->changed.notify_all();
+        return backupPath;
+    }
+    
+    if (!storeSnapshot(hash, bytes, timeNs, group)) {
         return "";
     }
+    
+    // A write still pending in the group appears at the raw path (or as
+    // its delta, which restoreFromBackup also finds)
+    BackupStore& store = backupStore();
+    const std::string backupPath = store.objectPath(hash);
+    return backupPath.empty() ? store.rawPath(hash) : backupPath;
+}
+
+// ------------------------------------------------------------------------------
+// Store a Snapshot
+// A state equal to the latest one adds nothing; any other state costs one
+// manifest line, plus one object if no file has been in that state before.
+// With a group the line is only written once the object is in place
+// ------------------------------------------------------------------------------
+bool BackupManager::storeSnapshot(const std::string& hash, std::string_view bytes,
+                                  int64_t timeNs, SyncGroup* group) {
+    BackupStore& store = backupStore();
+    if (!store.lock()) {
+        lastError = "Failed to create backup: " + store.getLastError();
+        return false;
+    }
+    
+    // The latest state is the delta base: consecutive states differ little
+    const BackupStore::Entry* latest = store.latest(storeName);
+    const std::string base = latest != nullptr ? latest->hash : "";
+    bool ok = store.put(hash, bytes, base, group);
+    if (ok && group == nullptr) {
+        ok = recordSnapshot(hash, bytes.size(), timeNs);
+    }
+    store.unlock();
+    if (!ok) {
+        lastError = "Failed to create backup: " + store.getLastError();
+        return false;
+    }
+    
+    if (group != nullptr) {
+        group->afterCommit([this, hash, size = bytes.size(), timeNs] {
+            BackupStore& store = backupStore();
+            if (!store.lock()) {
+                lastError = "Failed to create backup: " + store.getLastError();
+                return;
+            }
+            const bool recorded = recordSnapshot(hash, size, timeNs);
+            store.unlock();
+            if (!recorded) {
+                lastError = "Failed to create backup: " + store.getLastError();
+                return;
+            }
+            cleanupAndCompressOldBackups(kMaxBackups);
+        });
+        return true;
+    }
+    
+    // Clean up old backups to prevent unlimited growth
+    cleanupAndCompressOldBackups(kMaxBackups);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Record a Stored State
+// ------------------------------------------------------------------------------
+bool BackupManager::recordSnapshot(const std::string& hash, uint64_t size, int64_t timeNs) {
+    BackupStore& store = backupStore();
+    const BackupStore::Entry* latest = store.latest(storeName);
+    if (latest != nullptr && latest->hash == hash) {
+        return true;
+    }
+    BackupStore::Entry entry;
+    entry.timeNs = timeNs;
+    entry.size = size;
+    entry.hash = hash;
+    entry.codec = BackupStore::codecOf(store.objectPath(hash));
+    entry.file = storeName;
+    return store.append(entry);
 }
 
 // ------------------------------------------------------------------------------
 // Cleanup and Compress Old Backups
 // Strategy:
 // - Keep 10 most recent backups uncompressed
-// - Compress backups 11-20 with XZ
+// - Compress backups 11-20 with XZ (in-process, no external xz)
 // - Delete backups beyond 20
+// Works from the manifest alone; it is rewritten once if anything changed.
+// A stored object is only deleted once no manifest entry needs it
 // ------------------------------------------------------------------------------
 int BackupManager::cleanupAndCompressOldBackups(int maxBackups) {
     // Ensure reasonable maximum
-    if (maxBackups <= 0) maxBackups = 20;
-    
-    // Get all backups for this file
-    std::vector<std::string> backups = listBackups();
+    if (maxBackups <= 0) maxBackups = kMaxBackups;
     
-    // Pair backups with their modification times for sorting
-    std::vector<std::pair<std::string, fs::file_time_type>> backupsWithTime;
-    for (const auto& backup : backups) {
-        try {
-            backupsWithTime.emplace_back(backup, fs::last_write_time(backup));
-        } catch (...) {
-            continue; // Skip if we can't get file time
+    BackupStore& store = backupStore();
+    if (!store.lock()) {
+        lastError = "Failed to rotate backups: " + store.getLastError();
+        return 0;
+    }
+    std::vector<BackupStore::Entry> entries = store.entries();
+    std::vector<size_t> mine;  // Positions of this file's states, oldest first
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].file == storeName) {
+            mine.push_back(i);
         }
     }
+    const size_t dropCount = mine.size() > static_cast<size_t>(maxBackups)
+                                 ? mine.size() - static_cast<size_t>(maxBackups) : 0;
+    const size_t rawFrom = mine.size() > 10 ? mine.size() - 10 : 0;
     
-    // Sort by modification time (newest first)
-    std::sort(backupsWithTime.begin(), backupsWithTime.end(),
-              [](const auto& a, const auto& b) { 
-                  return a.second > b.second; 
-              });
-    
-    int deleted = 0;
+    // Compress each object once, unless one of the 10 newest states uses
+    // it, directly or as the keyframe of its chain
+    std::unordered_set<std::string> done;
+    for (size_t k = rawFrom; k < mine.size(); ++k) {
+        for (std::string& hash : store.chainOf(entries[mine[k]].hash)) {
+            done.insert(std::move(hash));
+        }
+    }
+    std::unordered_set<std::string> compressed;
+    for (size_t k = dropCount; k < rawFrom; ++k) {
+        const BackupStore::Entry& entry = entries[mine[k]];
+        if (entry.codec != "raw" || !done.insert(entry.hash).second) continue;
+        if (store.compress(entry.hash, compressionLevel, compressionExtreme)) {
+            compressed.insert(entry.hash);
+        } else {
+            lastError = store.getLastError();
+        }
+    }
     
-    // Process backups from oldest to newest
-    for (size_t i = 0; i < backupsWithTime.size(); ++i) {
-        const std::string& path = backupsWithTime[i].first;
-        
-        if (i >= static_cast<size_t>(maxBackups)) {
-            // Delete backups beyond maximum limit
-            try {
-                fs::remove(path);
-                deleted++;
-            } catch (...) {
-                continue; // Skip if deletion fails
-            }
-        } 
-        else if (i >= 10 && path.substr(path.size() - 3) != ".xz") {
-            // Compress backups beyond the 10 most recent (if not already compressed)
-            // Using XZ compression with maximum compression level (-9e)
-            std::string cmd = "xz -9e " + path;
-            if (std::system(cmd.c_str()) != 0) {
-                lastError = "Failed to compress backup: " + path;
+    // Drop the oldest states and record the compressed objects
+    std::vector<std::string> dropped;
+    if (dropCount > 0 || !compressed.empty()) {
+        std::vector<bool> drop(entries.size(), false);
+        for (size_t k = 0; k < dropCount; ++k) {
+            drop[mine[k]] = true;
+            dropped.push_back(entries[mine[k]].hash);
+        }
+        std::vector<BackupStore::Entry> kept;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (drop[i]) continue;
+            kept.push_back(std::move(entries[i]));
+            if (compressed.count(kept.back().hash) != 0) {
+                kept.back().codec = "xz";
             }
         }
+        if (!store.rewrite(kept)) {
+            lastError = "Failed to rotate backups: " + store.getLastError();
+            dropped.clear();  // Still listed: keep their objects
+        }
     }
+    const int deleted = static_cast<int>(store.removeUnreferenced(dropped));
+    store.unlock();
     
     return deleted;
 }
 
+// ------------------------------------------------------------------------------
+// Backup Store
+// Opened on first use. The first use also moves the .bak files of earlier
+// versions into the store, so nothing scans the backup directory later
+// ------------------------------------------------------------------------------
+BackupStore& BackupManager::backupStore() const {
+    if (!store) {
+        store = std::make_unique<BackupStore>(getBackupDirectory());
+        importLegacyBackups();
+    }
+    return *store;
+}
+
+// ------------------------------------------------------------------------------
+// Import Legacy Backups
+// Each .bak file (oldest first) becomes a state with the file's time, and
+// is removed once it is stored, in the manifest and noted as imported (so
+// restoreFromBackup still accepts its path)
+// ------------------------------------------------------------------------------
+void BackupManager::importLegacyBackups() const {
+    const std::vector<std::string> legacy = listLegacyBackups();
+    if (legacy.empty() || !store->lock()) {
+        return;
+    }
+    for (const std::string& path : legacy) {
+        std::error_code ec;
+        const fs::file_time_type time = fs::last_write_time(path, ec);
+        if (ec) {
+            continue;  // Imported meanwhile by another manager
+        }
+        
+        std::string content;
+        bool ok;
+        if (path.size() > 3 && path.substr(path.size() - 3) == ".xz") {
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            XzCodec codec;
+            ok = fd >= 0 && codec.decompress(fd, [&content](std::string_view data) {
+                content.append(data);
+                return true;
+            });
+            if (fd >= 0) close(fd);
+        } else {
+            MappedFile file;
+            ok = file.open(path);
+            content.assign(file.view());
+        }
+        
+        const BackupStore::Entry* latest = store->latest(storeName);
+        const std::string base = latest != nullptr ? latest->hash : "";
+        const std::string hash = BackupStore::hashOf(content);
+        if (!ok || !store->put(hash, content, base)) {
+            lastError = "Failed to import backup " + path;
+            continue;
+        }
+        BackupStore::Entry entry;
+        entry.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            fs::file_time_type::clock::to_sys(time).time_since_epoch()).count();
+        entry.size = content.size();
+        entry.hash = hash;
+        entry.codec = BackupStore::codecOf(store->objectPath(hash));
+        entry.file = storeName;
+        if ((base == hash || store->append(entry)) &&
+            store->recordLegacy(fs::absolute(path, ec).string(), hash)) {
+            fs::remove(path, ec);
+        }
+    }
+    store->unlock();
+}
+
+// ------------------------------------------------------------------------------
+// Asynchronous Mode
+// ------------------------------------------------------------------------------
+void BackupManager::setAsync(bool enabled) {
+    if (!enabled) {
+        flush();
+    }
+    async = enabled;
+}
+
+bool BackupManager::flush() {
+    if (!worker) {
+        return true;
+    }
+    waitIdle();
+    
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (worker->error.empty()) {
+        return true;
+    }
+    lastError = std::move(worker->error);
+    worker->error.clear();
+    return false;
+}
+
+size_t BackupManager::pendingBackups() const {
+    if (!worker) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    return worker->jobs.size() + (worker->busy ? 1 : 0);
+}
+
+void BackupManager::waitIdle() const {
+    if (!worker) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    worker->changed.wait(lock, [this] { return worker->jobs.empty() && !worker->busy; });
+}
+
+// ------------------------------------------------------------------------------
+// Worker Loop
+// Stores each snapshot, then runs the rotation. Exits once stopping is set
+// and the queue is empty.
+// ------------------------------------------------------------------------------
+void BackupManager::workerLoop() {
+    // Stores through a private manager, whose errors stay here; it keeps
+    // its view of the manifest from job to job
+    BackupManager writer(originalFilePath);
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    for (;;) {
+        worker->changed.wait(lock, [this] { return !worker->jobs.empty() || worker->stopping; });
+        if (worker->jobs.empty()) {
+            return;
+        }
+        Worker::Job job = std::move(worker->jobs.front());
+        worker->jobs.pop_front();
+        worker->busy = true;
+        worker->changed.notify_all();  // Room in the queue
+        lock.unlock();
+        
+        writer.lastError.clear();
+        writer.setCompressionLevel(job.level, job.extreme);
+        writer.storeSnapshot(job.hash, job.bytes, job.timeNs);
+        std::string error = writer.getLastError();
+        
+        lock.lock();
+        if (worker->error.empty()) {
+            worker->error = std::move(error);
+        }
+        worker->busy = false;
+        worker->changed.notify_all();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Set Compression Level
+// ------------------------------------------------------------------------------
+void BackupManager::setCompressionLevel(int level, bool extreme) {
+    compressionLevel = level;
+    compressionExtreme = extreme;
+}
+
 // ------------------------------------------------------------------------------
 // Restore From Specific Backup
-// Supports both regular and .xz compressed backups
+// Supports stored objects and legacy regular and .xz compressed backups
 // ------------------------------------------------------------------------------
 bool BackupManager::restoreFromBackup(const std::string& backupPath) {
-    std::string actualBackupPath = backupPath;
+    // The backup may still be queued
+    waitIdle();
     
-    // Handle compressed backups
-    if (backupPath.substr(backupPath.size() - 3) == ".xz") {
-        // Remove .xz extension for decompressed file
-        actualBackupPath = backupPath.substr(0, backupPath.size() - 3);
+    // Stored object, raw or compressed by now, or a .bak file of an earlier
+    // version that was imported into the store (and removed) meanwhile
+    BackupStore& store = backupStore();
+    std::string hash;
+    if (!store.isObjectPath(backupPath, hash)) {
+        std::error_code ec;
+        hash = store.legacyHash(fs::absolute(backupPath, ec).string());
+    }
+    if (!hash.empty()) {
+        FileLock lock;
+        if (!lock.lock(originalFilePath)) {
+            lastError = lock.getLastError();
+            return false;
+        }
         
-        // Decompress using xz command
-        // -d: decompress, -k: keep original, -f: force overwrite
-        std::string cmd = "xz -d -k -f " + backupPath;
-        if (std::system(cmd.c_str()) != 0) {
-            lastError = "Failed to decompress backup: " + backupPath;
+        // The rotation must not compress the object while it is read
+        std::string content;
+        bool loaded = store.lock();
+        loaded = loaded && store.load(hash, content);
+        store.unlock();
+        if (!loaded) {
+            lastError = "Failed to restore from backup: " + store.getLastError();
             return false;
         }
+        
+        AtomicWriter writer(originalFilePath);
+        if (!writer.open() || !writer.write(content) || !writer.commit()) {
+            lastError = "Failed to restore from backup: " + writer.getLastError();
+            return false;
+        }
+        return true;
+    }
+    
+    // Verify backup file exists
+    if (!fs::exists(backupPath)) {
+        lastError = "Backup file does not exist: " + backupPath;
+        return false;
     }
     
-    // Verify decompressed file exists
-    if (!fs::exists(actualBackupPath)) {
-        lastError = "Backup file does not exist: " + actualBackupPath;
+    // Other writers must not interleave with the copy
+    FileLock lock;
+    if (!lock.lock(originalFilePath)) {
+        lastError = lock.getLastError();
         return false;
     }
     
+    // Handle compressed backups: decompress straight over the original
+    if (backupPath.size() > 3 && backupPath.substr(backupPath.size() - 3) == ".xz") {
+        XzCodec codec;
+        if (!codec.decompressFile(backupPath, originalFilePath)) {
+            lastError = "Failed to decompress backup: " + backupPath + ": " + codec.getLastError();
+            return false;
+        }
+        return true;
+    }
+    
     try {
         // Restore by copying backup over original
-        fs::copy_file(actualBackupPath, originalFilePath, 
+        fs::copy_file(backupPath, originalFilePath, 
                      fs::copy_options::overwrite_existing);
         return true;
-        
+    
     } catch (const std::exception& e) {
         lastError = std::string("Failed to restore from backup: ") + e.what();
         return false;
@@ -166,9 +535,52 @@ bool BackupManager::restoreFromBackup(const std::string& backupPath) {
 
 // ------------------------------------------------------------------------------
 // List All Backups
-// Scans backup directory for files matching the backup pattern
+// The objects of the file's manifest entries; no directory walk. A state
+// reached more than once is listed at its latest position; states whose
+// object has been deleted are skipped
 // ------------------------------------------------------------------------------
 std::vector<std::string> BackupManager::listBackups() const {
+    // Queued backups count as existing
+    waitIdle();
+    
+    BackupStore& store = backupStore();
+    const std::vector<BackupStore::Entry> entries = store.entriesOf(storeName);
+    std::unordered_set<std::string> listed;
+    std::vector<std::string> backups;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (!listed.insert(it->hash).second) continue;
+        std::string path = store.objectPath(it->hash);
+        if (!path.empty()) {
+            backups.push_back(std::move(path));
+        }
+    }
+    std::reverse(backups.begin(), backups.end());
+    return backups;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Legacy Backup Name
+// base followed by a timestamp (digits and '_'), optionally with .xz
+// ------------------------------------------------------------------------------
+static bool isLegacyBackupName(std::string_view name, std::string_view base) {
+    if (!name.starts_with(base)) {
+        return false;
+    }
+    std::string_view stamp = name.substr(base.size());
+    if (stamp.ends_with(".xz")) {
+        stamp.remove_suffix(3);
+    }
+    return !stamp.empty() && std::all_of(stamp.begin(), stamp.end(), [](char c) {
+        return (c >= '0' && c <= '9') || c == '_';
+    });
+}
+
+// ------------------------------------------------------------------------------
+// List Legacy Backups
+// Scans backup directory for files matching the backup pattern (only done
+// once, to import them)
+// ------------------------------------------------------------------------------
+std::vector<std::string> BackupManager::listLegacyBackups() const {
     std::vector<std::string> backups;
     std::string backupPattern = getBackupBaseName();
     std::string backupDir = getBackupDirectory();
@@ -179,9 +591,9 @@ std::vector<std::string> BackupManager::listBackups() const {
             if (entry.is_regular_file()) {
                 std::string filename = entry.path().filename().string();
                 
-                // Match files that start with the backup base name
-                // (e.g., ".bashrc.bak" for .bashrc file)
-                if (filename.find(backupPattern) != std::string::npos) {
+                // Match the base name and a timestamp, optionally
+                // compressed (e.g., ".bashrc.bak20240115_143025.xz")
+                if (isLegacyBackupName(filename, backupPattern)) {
                     backups.push_back(entry.path().string());
                 }
             }
@@ -191,6 +603,17 @@ std::vector<std::string> BackupManager::listBackups() const {
         lastError = std::string("Failed to list backups: ") + e.what();
     }
     
+    // Oldest first
+    std::vector<std::pair<fs::file_time_type, std::string>> byTime;
+    for (std::string& backup : backups) {
+        std::error_code ec;
+        byTime.emplace_back(fs::last_write_time(backup, ec), std::move(backup));
+    }
+    std::sort(byTime.begin(), byTime.end());
+    backups.clear();
+    for (auto& entry : byTime) {
+        backups.push_back(std::move(entry.second));
+    }
     return backups;
 }
 
@@ -198,8 +621,16 @@ std::vector<std::string> BackupManager::listBackups() const {
 // Get Backup Directory
 // Default: ~/.shellbackup/
 // Fallback: Same directory as original file
+// Resolved (and created) on the first call only
 // ------------------------------------------------------------------------------
 std::string BackupManager::getBackupDirectory() const {
+    if (backupDirectory.empty()) {
+        backupDirectory = resolveBackupDirectory();
+    }
+    return backupDirectory;
+}
+
+std::string BackupManager::resolveBackupDirectory() const {
     // Try to use HOME directory
     const char* homeDir = std::getenv("HOME");
     if (!homeDir) {
@@ -221,7 +652,7 @@ std::string BackupManager::getBackupDirectory() const {
                            fs::perm_options::replace);
         }
         return backupDir.string();
-        
+    
     } catch (const std::exception& e) {
         // If creation fails, fallback to original directory
         lastError = std::string("Failed to create backup directory: ") + e.what();
@@ -231,36 +662,26 @@ std::string BackupManager::getBackupDirectory() const {
 
 // ------------------------------------------------------------------------------
 // Get Most Recent Backup
-// Returns the path to the newest backup file
+// The file's latest manifest entry, or the newest one whose object still
+// exists if that one has been deleted
 // ------------------------------------------------------------------------------
 std::string BackupManager::getLastBackupPath() const {
-    std::vector<std::string> backups = listBackups();
-    if (backups.empty()) {
-        return ""; // No backups available
-    }
+    waitIdle();
     
-    // Get modification times for all backups
-    std::vector<std::pair<std::string, fs::file_time_type>> backupsWithTime;
-    for (const auto& backup : backups) {
-        try {
-            backupsWithTime.emplace_back(backup, fs::last_write_time(backup));
-        } catch (...) {
-            continue; // Skip if we can't get file time
-        }
+    BackupStore& store = backupStore();
+    const BackupStore::Entry* latest = store.latest(storeName);
+    if (latest == nullptr) {
+        return "";  // No backups available
     }
-    
-    if (backupsWithTime.empty()) {
-        return "";
+    std::string path = store.objectPath(latest->hash);
+    if (!path.empty()) {
+        return path;
     }
-    
-    // Sort by modification time (newest first)
-    std::sort(backupsWithTime.begin(), backupsWithTime.end(),
-              [](const auto& a, const auto& b) { 
-                  return a.second > b.second; 
-              });
-    
-    // Return the newest backup
-    return backupsWithTime[0].first;
+    const std::vector<BackupStore::Entry> entries = store.entriesOf(storeName);
+    for (auto it = entries.rbegin(); it != entries.rend() && path.empty(); ++it) {
+        path = store.objectPath(it->hash);
+    }
+    return path;
 }
 
 // ------------------------------------------------------------------------------
@@ -283,22 +704,6 @@ std::string BackupManager::getOriginalFilePath() const {
     return originalFilePath;
 }
 
-// ------------------------------------------------------------------------------
-// Generate Timestamp
-// Format: YYYYMMDD_HHMMSS
-// Example: 20240115_143025
-// ------------------------------------------------------------------------------
-std::string BackupManager::generateTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    
-    std::stringstream ss;
-    // Format: YearMonthDay_HourMinuteSecond
-    ss << std::put_time(std::localtime(&time), "%Y%m%d_%H%M%S");
-    
-    return ss.str();
-}
-
 // ------------------------------------------------------------------------------
 // Get Backup Base Name
 // Example: For "/home/user/.bashrc" returns ".bashrc.bak"
@@ -307,6 +712,24 @@ std::string BackupManager::getBackupBaseName() const {
     return fs::path(originalFilePath).filename().string() + ".bak";
 }
 
+// ------------------------------------------------------------------------------
+// Get Store Name
+// Example: For "/home/user/.bashrc" returns ".bashrc-" and 16 hex digits;
+// the digits keep files of the same name in different directories apart.
+// Computed once, by the constructor
+// ------------------------------------------------------------------------------
+std::string BackupManager::getStoreName() const {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(originalFilePath, ec);
+    if (ec) {
+        absolute = originalFilePath;
+    }
+    char digits[17];
+    std::snprintf(digits, sizeof(digits), "%016llx",
+                  static_cast<unsigned long long>(hash::bytes(absolute.lexically_normal().string())));
+    return fs::path(originalFilePath).filename().string() + "-" + digits;
+}
+
 // ------------------------------------------------------------------------------
 // Get Last Error Message
 // Useful for debugging failed operations
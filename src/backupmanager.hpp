@@ -6,7 +6,17 @@
 // This header defines the BackupManager class, which provides robust
 // backup and restoration functionality for shell configuration files.
 // It handles automatic backup creation, compression, rotation, and
-// restoration with comprehensive error handling and management.
+// restoration with comprehensive error handling and management. Older
+// backups are compressed to .xz in-process (see XzCodec). In asynchronous
+// mode a backup is only a snapshot of the file's bytes on the caller's
+// thread; writing it out, rotation and compression run on a background
+// worker fed by a bounded queue. Backups are kept in the content-addressed
+// store under the backup directory (see BackupStore), shared by all
+// configuration files, with an append-only manifest of every state; .bak
+// files written by earlier versions are imported into it on first use.
+// Each state is stored as a line delta against the previous one where
+// that is small, with a full keyframe at least every
+// BackupStore::kMaxChain objects.
 // ------------------------------------------------------------------------------
 
 #ifndef BACKUPMANAGER_HPP
@@ -15,8 +25,15 @@
 #include <string>
 #include <filesystem>
 #include <ctime>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
 #include <vector>
 
+class BackupStore;
+class SyncGroup;
+
 class BackupManager {
 public:
     // --------------------------------------------------------------------------
@@ -26,20 +43,54 @@ public:
     // Initialize with path to the file that needs backup protection
     explicit BackupManager(const std::string& originalFilePath);
     
+    // Writes out every queued backup, then stops the worker
+    ~BackupManager();
+    
+    BackupManager(const BackupManager&) = delete;
+    BackupManager& operator=(const BackupManager&) = delete;
+    
     // --------------------------------------------------------------------------
     // Backup Operations
     // --------------------------------------------------------------------------
     
-    // Create a timestamped backup of the original file
-    // Returns: Path to created backup, empty string on failure
-    std::string createBackup();
+    // Back up the current content of the original file. Content that is
+    // already stored (by this file or another) is not written again, and
+    // is only recorded as a new state if it differs from the latest one.
+    // In asynchronous mode the file is only read here; the backup appears
+    // once the worker has written it (see flush). Otherwise, given a group,
+    // the object is written into it and recorded once the group commits, so
+    // it is made durable together with the caller's own writes
+    // Returns: Path of the backup object, empty string on failure
+    std::string createBackup(SyncGroup* group = nullptr);
+    
+    // --------------------------------------------------------------------------
+    // Asynchronous Mode
+    // --------------------------------------------------------------------------
+    
+    // Most snapshots waiting for the worker; createBackup blocks while the
+    // queue is full
+    static constexpr size_t kMaxPendingBackups = 8;
+    
+    // Hand writing, rotation and compression of backups to a background
+    // worker (off by default). Turning it off flushes first
+    void setAsync(bool enabled);
+    
+    // Wait until every queued backup is written and rotated
+    // Returns: false if background work failed since the last flush (the
+    // first failure is in getLastError)
+    bool flush();
+    
+    // Number of backups queued or being written
+    size_t pendingBackups() const;
     
     // Get path to the most recent backup
     // Returns: Path to latest backup, empty if no backups exist
     std::string getLastBackupPath() const;
     
     // List all available backups for the original file
-    // Returns: Vector of backup file paths, sorted by creation time
+    // Returns: Vector of backup file paths, oldest first, each stored
+    // state once (at its latest position). A .delta object is only
+    // readable through restoreFromBackup
     std::vector<std::string> listBackups() const;
     
     // --------------------------------------------------------------------------
@@ -51,7 +102,8 @@ public:
     bool restoreFromLastBackup();
     
     // Restore original file from a specific backup file
-    // Parameters: backupPath - Path to backup file (supports .xz compressed)
+    // Parameters: backupPath - Path to backup file or object (supports .xz
+    // compressed; an object may be given by its raw or its .xz path)
     // Returns: true if restoration successful, false otherwise
     bool restoreFromBackup(const std::string& backupPath);
     
@@ -62,7 +114,7 @@ public:
     // Get the original file path being backed up
     std::string getOriginalFilePath() const;
     
-    // Get the directory where backups are stored
+    // Get the directory where backups are stored (resolved once)
     // Default: ~/.shellbackup/
     std::string getBackupDirectory() const;
     
@@ -83,29 +135,72 @@ public:
     // Returns: Number of backups deleted
     int cleanupAndCompressOldBackups(int maxBackups);
     
+    // Select how older backups are compressed
+    // Parameters: level - 0 (fastest) to 9 (smallest); extreme - as xz -e
+    // Default: level 9, extreme (as xz -9e)
+    void setCompressionLevel(int level, bool extreme = false);
+
 private:
     // --------------------------------------------------------------------------
     // Private Methods
     // --------------------------------------------------------------------------
     
-    // Generate timestamp string for backup filenames
-    // Format: YYYYMMDD_HHMMSS
-    static std::string generateTimestamp();
-    
     // Get base backup filename without timestamp
     // Format: original_filename.bak
     std::string getBackupBaseName() const;
     
+    // Name of the original in the store's manifest
+    // Format: original_filename-<hash of the absolute path>
+    std::string getStoreName() const;
+    
+    // Find (and create) the backup directory
+    std::string resolveBackupDirectory() const;
+    
+    // The store in the backup directory, opened on first use
+    BackupStore& backupStore() const;
+    
+    // .bak files left by earlier versions, oldest first
+    std::vector<std::string> listLegacyBackups() const;
+    
+    // Move the .bak files of earlier versions into the store
+    void importLegacyBackups() const;
+    
+    // Store a snapshot and record it as the latest state, then rotate (after
+    // group commits, if given)
+    // Returns: false if the snapshot could not be stored
+    bool storeSnapshot(const std::string& hash, std::string_view bytes, int64_t timeNs,
+                       SyncGroup* group = nullptr);
+    
+    // Add a stored state to the manifest unless it equals the latest one;
+    // the store must be locked
+    bool recordSnapshot(const std::string& hash, uint64_t size, int64_t timeNs);
+    
     // Compare file modification times
     // Returns: true if file1 is newer than file2
     static bool isNewer(const std::string& file1, const std::string& file2);
     
+    // Wait until the worker is idle (no effect in synchronous mode)
+    void waitIdle() const;
+    
+    // Worker thread main loop
+    void workerLoop();
+    
+    // Queue, thread and state shared with the worker
+    struct Worker;
+    
     // --------------------------------------------------------------------------
     // Member Variables
     // --------------------------------------------------------------------------
     
     std::string originalFilePath;  // Path to file being backed up
     mutable std::string lastError; // Last error message (thread-safe mutable)
+    int compressionLevel = 9;      // XZ preset level for older backups
+    bool compressionExtreme = true; // XZ extreme preset variant
+    bool async = false;            // Backups go through the worker
+    std::unique_ptr<Worker> worker; // Started by the first queued backup
+    std::string storeName;         // Name of the original in the store
+    mutable std::string backupDirectory;          // Resolved on first use
+    mutable std::unique_ptr<BackupStore> store;   // Opened on first use
 };
 
 #endif // BACKUPMANAGER_HPP
\ No newline at end of file
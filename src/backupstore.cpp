@@ -0,0 +1,625 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Backup Store Component Implementation
+//
+// This file implements the BackupStore class. Objects live at
+// objects/<first two hex digits>/<remaining digits>, optionally compressed
+// to a .xz sibling. The manifest is text, one line per state, appended
+// with O_APPEND and only rewritten as a whole (atomically) when rotation
+// drops states or compresses objects. A delta object starts with a
+// "delta <base hash>" line followed by the hunks of LineMerge::diff against
+// the base, each with the replacement lines inline. Objects are never modified once written,
+// so a reader only needs the store lock when an object might be
+// compressed or removed.
+// ------------------------------------------------------------------------------
+
+#include "backupstore.hpp"
+#include "atomicwriter.hpp"  // Objects and the rewritten manifest are replaced whole
+#include "hash.hpp"          // Object names
+#include "linemerge.hpp"     // Line deltas between states
+#include "mappedfile.hpp"    // Raw object reads
+#include "xzcodec.hpp"       // Compressed objects
+#include <cerrno>            // For errno
+#include <charconv>          // Delta record parsing
+#include <cstdio>            // For std::snprintf
+#include <cstring>           // For std::strerror
+#include <fcntl.h>           // For open
+#include <filesystem>        // Directory creation, path handling
+#include <fstream>           // Delta reads
+#include <iterator>          // For std::istreambuf_iterator
+#include <sstream>           // Manifest parsing
+#include <sys/stat.h>        // For stat
+#include <system_error>      // For std::error_code
+#include <unordered_set>     // Referenced hashes
+#include <unistd.h>          // For pread, write, close
+
+namespace fs = std::filesystem;
+
+// Seed of the second half of an object name
+static constexpr uint64_t kSecondSeed = 0x9e3779b97f4a7c15ULL;
+
+// Length of an object name in hex digits
+static constexpr size_t kHashDigits = 32;
+
+// ------------------------------------------------------------------------------
+// Utility: Check for an Object Name
+// ------------------------------------------------------------------------------
+static bool isHashName(std::string_view name) {
+    if (name.size() != kHashDigits) return false;
+    for (char c : name) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Line Starts
+// Offset of every line of text, plus text.size() at the end. A line ends
+// after its newline; bytes after the last newline form one more line
+// ------------------------------------------------------------------------------
+static std::vector<size_t> lineStarts(std::string_view text) {
+    std::vector<size_t> starts{0};
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n' && i + 1 < text.size()) {
+            starts.push_back(i + 1);
+        }
+    }
+    if (!text.empty()) {
+        starts.push_back(text.size());
+    }
+    return starts;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Encode a Delta
+// One record per hunk: "<base begin> <base end> <byte count>\n" and the
+// bytes of the lines replacing base lines [begin, end)
+// ------------------------------------------------------------------------------
+static std::string encodeDelta(std::string_view base, std::string_view content) {
+    const std::vector<size_t> lines = lineStarts(content);
+    std::string delta;
+    for (const LineMerge::Hunk& hunk : LineMerge::diff(base, content)) {
+        const size_t begin = lines[hunk.otherBegin];
+        const size_t end = lines[hunk.otherEnd];
+        delta += std::to_string(hunk.baseBegin) + " " + std::to_string(hunk.baseEnd) + " " +
+                 std::to_string(end - begin) + "\n";
+        delta.append(content.substr(begin, end - begin));
+    }
+    return delta;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Apply a Delta
+// Returns: false if the records do not fit base (a damaged object)
+// ------------------------------------------------------------------------------
+static bool applyDelta(std::string_view base, std::string_view delta, std::string& out) {
+    const std::vector<size_t> lines = lineStarts(base);
+    const size_t lineCount = lines.size() - 1;
+    out.clear();
+    size_t cursor = 0;  // Next base line to copy
+    size_t pos = 0;
+    while (pos < delta.size()) {
+        size_t fields[3];
+        for (size_t& field : fields) {
+            const char* first = delta.data() + pos;
+            const char* last = delta.data() + delta.size();
+            auto [next, ec] = std::from_chars(first, last, field);
+            if (ec != std::errc() || next == last || (*next != ' ' && *next != '\n')) {
+                return false;
+            }
+            pos = static_cast<size_t>(next - delta.data()) + 1;
+        }
+        const auto [begin, end, bytes] = fields;
+        if (begin < cursor || end < begin || end > lineCount || bytes > delta.size() - pos) {
+            return false;
+        }
+        out.append(base.substr(lines[cursor], lines[begin] - lines[cursor]));
+        out.append(delta.substr(pos, bytes));
+        pos += bytes;
+        cursor = end;
+    }
+    out.append(base.substr(lines[cursor]));
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Read a Delta Object
+// The first line is "delta <base hash>"; the records follow. body may be
+// null when only the base is wanted
+// ------------------------------------------------------------------------------
+static bool readDeltaFile(const std::string& path, std::string& base, std::string* body) {
+    std::ifstream file(path, std::ios::binary);
+    std::string header;
+    if (!std::getline(file, header) || header.size() != 6 + kHashDigits ||
+        header.compare(0, 6, "delta ") != 0 || !isHashName(std::string_view(header).substr(6))) {
+        return false;
+    }
+    base = header.substr(6);
+    if (body != nullptr) {
+        body->assign(std::istreambuf_iterator<char>(file), {});
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Manifest Lines
+// "<seq> <time ns> <size> <hash> <codec> <file>"; the file name is the
+// rest of the line
+// ------------------------------------------------------------------------------
+static std::string formatEntry(const BackupStore::Entry& entry) {
+    return std::to_string(entry.seq) + " " + std::to_string(entry.timeNs) + " " +
+           std::to_string(entry.size) + " " + entry.hash + " " + entry.codec + " " +
+           entry.file + "\n";
+}
+
+static bool parseEntry(std::string_view line, BackupStore::Entry& entry) {
+    std::istringstream fields{std::string(line)};
+    if (!(fields >> entry.seq >> entry.timeNs >> entry.size >> entry.hash >> entry.codec) ||
+        !isHashName(entry.hash) ||
+        (entry.codec != "raw" && entry.codec != "xz" && entry.codec != "delta")) {
+        return false;
+    }
+    std::getline(fields >> std::ws, entry.file);
+    return !entry.file.empty();
+}
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+BackupStore::BackupStore(const std::string& root)
+    : root(root),
+      manifestPath((fs::path(root) / "manifest").string()),
+      legacyPath((fs::path(root) / "legacy").string()) {
+}
+
+// ------------------------------------------------------------------------------
+// Object Names and Paths
+// ------------------------------------------------------------------------------
+std::string BackupStore::hashOf(std::string_view content) {
+    char name[kHashDigits + 1];
+    std::snprintf(name, sizeof(name), "%016llx%016llx",
+                  static_cast<unsigned long long>(hash::bytes(content)),
+                  static_cast<unsigned long long>(hash::bytes(content, kSecondSeed)));
+    return name;
+}
+
+std::string BackupStore::rawPath(const std::string& hash) const {
+    return (fs::path(root) / "objects" / hash.substr(0, 2) / hash.substr(2)).string();
+}
+
+std::string BackupStore::objectPath(const std::string& hash) const {
+    const std::string raw = rawPath(hash);
+    struct stat st;
+    if (stat(raw.c_str(), &st) == 0) {
+        return raw;
+    }
+    if (stat((raw + ".xz").c_str(), &st) == 0) {
+        return raw + ".xz";
+    }
+    if (stat((raw + ".delta").c_str(), &st) == 0) {
+        return raw + ".delta";
+    }
+    return "";
+}
+
+std::string BackupStore::codecOf(const std::string& path) {
+    const fs::path extension = fs::path(path).extension();
+    return extension == ".xz" ? "xz" : extension == ".delta" ? "delta" : "raw";
+}
+
+bool BackupStore::isObjectPath(const std::string& path, std::string& hash) const {
+    fs::path object(path);
+    if (object.extension() == ".xz" || object.extension() == ".delta") {
+        object.replace_extension();
+    }
+    const fs::path fanout = object.parent_path();
+    const std::string name = fanout.filename().string() + object.filename().string();
+    if (!isHashName(name) ||
+        fanout.parent_path().lexically_normal() != (fs::path(root) / "objects").lexically_normal()) {
+        return false;
+    }
+    hash = name;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Store an Object
+// An existing raw object of another size means two contents share a name;
+// that is reported rather than silently keeping the wrong bytes
+// ------------------------------------------------------------------------------
+bool BackupStore::put(const std::string& hash, std::string_view content, const std::string& base,
+                      SyncGroup* group) {
+    const std::string existing = objectPath(hash);
+    if (!existing.empty()) {
+        struct stat st;
+        if (existing == rawPath(hash) && stat(existing.c_str(), &st) == 0 &&
+            static_cast<uint64_t>(st.st_size) != content.size()) {
+            lastError = "Object name collision: " + hash;
+            return false;
+        }
+        return true;
+    }
+    
+    const std::string path = rawPath(hash);
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    
+    // A delta when it is small and the base is readable within the chain
+    std::string previous;
+    if (!base.empty() && base != hash && chainOf(base).size() < kMaxChain &&
+        load(base, previous)) {
+        const std::string delta = "delta " + base + "\n" + encodeDelta(previous, content);
+        if (delta.size() < content.size() / 2) {
+            return writeObject(path + ".delta", delta, group);
+        }
+    }
+    return writeObject(path, content, group);
+}
+
+// ------------------------------------------------------------------------------
+// Write an Object File
+// ------------------------------------------------------------------------------
+bool BackupStore::writeObject(const std::string& path, std::string_view bytes, SyncGroup* group) {
+    if (group != nullptr) {
+        AtomicWriter* writer = group->add(path);
+        if (writer == nullptr || !writer->write(bytes)) {
+            lastError = "Cannot store object: " +
+                        (writer != nullptr ? writer->getLastError() : group->getLastError());
+            return false;
+        }
+        return true;
+    }
+    
+    AtomicWriter writer(path);
+    if (!writer.open() || !writer.write(bytes) || !writer.commit()) {
+        lastError = "Cannot store object: " + writer.getLastError();
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Read an Object
+// Deltas are collected down to the keyframe, then applied oldest first
+// ------------------------------------------------------------------------------
+bool BackupStore::load(const std::string& hash, std::string& content) {
+    content.clear();
+    std::vector<std::string> deltas;
+    std::string current = hash;
+    std::string path;
+    for (;;) {
+        path = objectPath(current);
+        if (path.empty()) {
+            lastError = "Backup object missing: " + current;
+            return false;
+        }
+        if (fs::path(path).extension() != ".delta") {
+            break;
+        }
+        std::string body;
+        if (deltas.size() + 1 >= kMaxChain || !readDeltaFile(path, current, &body)) {
+            lastError = "Backup object damaged: " + path;
+            return false;
+        }
+        deltas.push_back(std::move(body));
+    }
+    
+    if (!loadKeyframe(path, content)) {
+        return false;
+    }
+    std::string next;
+    for (auto it = deltas.rbegin(); it != deltas.rend(); ++it) {
+        if (!applyDelta(content, *it, next)) {
+            lastError = "Backup object damaged: " + hash;
+            content.clear();
+            return false;
+        }
+        content.swap(next);
+    }
+    if (hashOf(content) != hash) {
+        lastError = "Backup object damaged: " + hash;
+        content.clear();
+        return false;
+    }
+    return true;
+}
+
+bool BackupStore::loadKeyframe(const std::string& path, std::string& content) {
+    if (fs::path(path).extension() != ".xz") {
+        MappedFile file;
+        if (!file.open(path)) {
+            lastError = file.getLastError();
+            return false;
+        }
+        content.assign(file.view());
+        return true;
+    }
+    
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        lastError = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    XzCodec codec;
+    const bool ok = codec.decompress(fd, [&content](std::string_view data) {
+        content.append(data);
+        return true;
+    });
+    close(fd);
+    if (!ok) {
+        lastError = path + ": " + codec.getLastError();
+        content.clear();
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Object Chain
+// ------------------------------------------------------------------------------
+std::vector<std::string> BackupStore::chainOf(const std::string& hash) const {
+    std::vector<std::string> chain;
+    std::string current = hash;
+    while (chain.size() < kMaxChain) {
+        const std::string path = objectPath(current);
+        if (path.empty()) {
+            break;
+        }
+        chain.push_back(current);
+        if (fs::path(path).extension() != ".delta" || !readDeltaFile(path, current, nullptr)) {
+            break;
+        }
+    }
+    return chain;
+}
+
+// ------------------------------------------------------------------------------
+// Compress an Object
+// ------------------------------------------------------------------------------
+bool BackupStore::compress(const std::string& hash, int level, bool extreme) {
+    const std::string raw = rawPath(hash);
+    if (objectPath(hash) != raw) {
+        return true;  // Already compressed, or gone
+    }
+    XzCodec codec(level, extreme);
+    if (!codec.compressFile(raw, raw + ".xz")) {
+        lastError = "Failed to compress backup object " + hash + ": " + codec.getLastError();
+        return false;
+    }
+    std::error_code ec;
+    fs::remove(raw, ec);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Read the Manifest
+// Nothing changed since the last call costs one stat. Appends are read
+// from where the last call stopped; a manifest replaced by rewrite (a new
+// inode) is read again from the start. Malformed lines are skipped, and a
+// line without its newline yet is left for the next call
+// ------------------------------------------------------------------------------
+bool BackupStore::refresh() {
+    struct stat st;
+    if (stat(manifestPath.c_str(), &st) != 0) {
+        manifest.clear();
+        latestOf.clear();
+        manifestDevice = manifestInode = manifestRead = 0;
+        if (errno == ENOENT) {
+            return true;  // Nothing backed up yet
+        }
+        lastError = "Cannot read backup manifest: " + std::string(std::strerror(errno));
+        return false;
+    }
+    if (static_cast<uint64_t>(st.st_dev) == manifestDevice &&
+        static_cast<uint64_t>(st.st_ino) == manifestInode &&
+        static_cast<uint64_t>(st.st_size) == manifestRead) {
+        return true;
+    }
+    
+    // Identity and size of the file actually opened
+    int fd = open(manifestPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        lastError = "Cannot read backup manifest: " + std::string(std::strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    if (static_cast<uint64_t>(st.st_dev) != manifestDevice ||
+        static_cast<uint64_t>(st.st_ino) != manifestInode ||
+        static_cast<uint64_t>(st.st_size) < manifestRead) {
+        manifest.clear();
+        latestOf.clear();
+        manifestDevice = static_cast<uint64_t>(st.st_dev);
+        manifestInode = static_cast<uint64_t>(st.st_ino);
+        manifestRead = 0;
+    }
+    
+    std::string text(static_cast<size_t>(st.st_size) - manifestRead, '\0');
+    size_t got = 0;
+    while (got < text.size()) {
+        ssize_t n = pread(fd, text.data() + got, text.size() - got,
+                          static_cast<off_t>(manifestRead + got));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    close(fd);
+    text.resize(got);
+    
+    size_t pos = 0;
+    for (size_t end; (end = text.find('\n', pos)) != std::string::npos; pos = end + 1) {
+        Entry entry;
+        if (parseEntry(std::string_view(text).substr(pos, end - pos), entry)) {
+            latestOf[entry.file] = manifest.size();
+            manifest.push_back(std::move(entry));
+        }
+    }
+    manifestRead += pos;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Manifest Queries
+// ------------------------------------------------------------------------------
+const std::vector<BackupStore::Entry>& BackupStore::entries() {
+    refresh();
+    return manifest;
+}
+
+std::vector<BackupStore::Entry> BackupStore::entriesOf(const std::string& file) {
+    std::vector<Entry> result;
+    for (const Entry& entry : entries()) {
+        if (entry.file == file) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+const BackupStore::Entry* BackupStore::latest(const std::string& file) {
+    refresh();
+    auto it = latestOf.find(file);
+    return it == latestOf.end() ? nullptr : &manifest[it->second];
+}
+
+// ------------------------------------------------------------------------------
+// Append to the Manifest
+// One write of one line; the lock keeps sequence numbers unique
+// ------------------------------------------------------------------------------
+bool BackupStore::append(Entry& entry) {
+    if (!refresh()) {
+        return false;
+    }
+    entry.seq = manifest.empty() ? 1 : manifest.back().seq + 1;
+    
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    int fd = open(manifestPath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        lastError = "Cannot open backup manifest: " + std::string(std::strerror(errno));
+        return false;
+    }
+    const std::string line = formatEntry(entry);
+    const bool ok = write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+    if (!ok) {
+        lastError = "Cannot write backup manifest: " + std::string(std::strerror(errno));
+    }
+    close(fd);
+    return ok && refresh();
+}
+
+// ------------------------------------------------------------------------------
+// Rewrite the Manifest
+// ------------------------------------------------------------------------------
+bool BackupStore::rewrite(const std::vector<Entry>& entries) {
+    std::string text;
+    for (const Entry& entry : entries) {
+        text += formatEntry(entry);
+    }
+    AtomicWriter writer(manifestPath);
+    if (!writer.open() || !writer.write(text) || !writer.commit()) {
+        lastError = "Cannot rewrite backup manifest: " + writer.getLastError();
+        return false;
+    }
+    return refresh();
+}
+
+// ------------------------------------------------------------------------------
+// Legacy Backup Names
+// Appended once per imported file and only read when such a path is
+// restored, so the list is scanned rather than indexed
+// ------------------------------------------------------------------------------
+bool BackupStore::recordLegacy(const std::string& path, const std::string& hash) {
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    int fd = open(legacyPath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        lastError = "Cannot open legacy backup list: " + std::string(std::strerror(errno));
+        return false;
+    }
+    const std::string line = hash + " " + path + "\n";
+    const bool ok = write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+    if (!ok) {
+        lastError = "Cannot write legacy backup list: " + std::string(std::strerror(errno));
+    }
+    close(fd);
+    return ok;
+}
+
+std::string BackupStore::legacyHash(const std::string& path) const {
+    std::ifstream in(legacyPath, std::ios::binary);
+    std::string line;
+    std::string hash;
+    while (std::getline(in, line)) {
+        if (line.size() > kHashDigits + 1 && line[kHashDigits] == ' ' &&
+            line.compare(kHashDigits + 1, std::string::npos, path) == 0) {
+            hash = line.substr(0, kHashDigits);
+        }
+    }
+    return hash;
+}
+
+// ------------------------------------------------------------------------------
+// Remove Unreferenced Objects
+// Every manifest entry counts, so a state another file still refers to
+// survives, and so does every object below it in its chain
+// ------------------------------------------------------------------------------
+size_t BackupStore::removeUnreferenced(const std::vector<std::string>& hashes) {
+    if (hashes.empty()) {
+        return 0;
+    }
+    
+    // A chain below an object already seen is already in the set
+    std::unordered_set<std::string> referenced;
+    for (const Entry& entry : entries()) {
+        if (referenced.count(entry.hash) != 0) continue;
+        for (std::string& hash : chainOf(entry.hash)) {
+            referenced.insert(std::move(hash));
+        }
+    }
+    
+    // Candidates: the given objects and their bases, read before any goes
+    std::vector<std::string> candidates;
+    for (const std::string& hash : hashes) {
+        for (std::string& object : chainOf(hash)) {
+            candidates.push_back(std::move(object));
+        }
+    }
+    
+    std::error_code ec;
+    size_t removed = 0;
+    for (const std::string& hash : candidates) {
+        if (referenced.count(hash) != 0) continue;
+        const std::string raw = rawPath(hash);
+        const bool gone = fs::remove(raw, ec) | fs::remove(raw + ".xz", ec) |
+                          fs::remove(raw + ".delta", ec);
+        if (gone) {
+            ++removed;
+        }
+        referenced.insert(hash);  // Listed twice: look at it once
+    }
+    return removed;
+}
+
+// ------------------------------------------------------------------------------
+// Store Lock
+// ------------------------------------------------------------------------------
+bool BackupStore::lock() {
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (!storeLock.lock((fs::path(root) / "store").string())) {
+        lastError = storeLock.getLastError();
+        return false;
+    }
+    return true;
+}
+
+void BackupStore::unlock() {
+    storeLock.unlock();
+}
+
+// ------------------------------------------------------------------------------
+// Get Last Error Message
+// ------------------------------------------------------------------------------
+std::string BackupStore::getLastError() const {
+    return lastError;
+}
@@ -0,0 +1,170 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Backup Store Component Header
+//
+// This header defines the BackupStore class, a content-addressed store for
+// backups shared by every configuration file. Each distinct file content
+// is kept once, as an object named by its hash under objects/. An
+// append-only manifest lists the states every backed up file went
+// through, oldest first; backing up a state that is already stored costs
+// one manifest line, whichever file (.bashrc, .zshrc, config.fish)
+// stored it. The manifest is read once and then only its new lines, so
+// the latest state of a file is one stat away and listing needs no
+// directory walk.
+// A new state may be stored as a line delta against the previous one, so
+// a one-line edit of a large file costs about one line; every kMaxChain
+// objects a full keyframe bounds the replay needed to read a state back.
+// ------------------------------------------------------------------------------
+
+#ifndef BACKUPSTORE_HPP
+#define BACKUPSTORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "filelock.hpp"
+
+class SyncGroup;
+
+class BackupStore {
+public:
+    // --------------------------------------------------------------------------
+    // Structure: Entry
+    // Purpose: One backed up state of a file: one line of the manifest,
+    // "<seq> <time ns> <size> <hash> <codec> <file>".
+    // --------------------------------------------------------------------------
+    struct Entry {
+        uint64_t seq = 0;       // Position in the manifest, from 1
+        int64_t timeNs = 0;     // When the state was captured (Unix time)
+        uint64_t size = 0;      // Bytes of content
+        std::string hash;       // Object holding the content
+        std::string codec;      // How the object is stored: raw, xz or delta
+        std::string file;       // Name of the backed up file in the store
+    };
+    
+    // Longest chain of objects read to rebuild one state: a keyframe and up
+    // to kMaxChain - 1 deltas on top of it
+    static constexpr size_t kMaxChain = 16;
+    
+    // --------------------------------------------------------------------------
+    // Constructor
+    // --------------------------------------------------------------------------
+    
+    // Use the store under root (directories are created on first write)
+    explicit BackupStore(const std::string& root);
+    
+    // --------------------------------------------------------------------------
+    // Objects
+    // --------------------------------------------------------------------------
+    
+    // Object name of content: 128 bits of hash as 32 hex digits
+    static std::string hashOf(std::string_view content);
+    
+    // Path put stores hash at (the object need not exist)
+    std::string rawPath(const std::string& hash) const;
+    
+    // Path of the object as stored (raw, compressed with a .xz suffix, or
+    // a delta with a .delta suffix); empty if it is not stored
+    std::string objectPath(const std::string& hash) const;
+    
+    // Check whether path names an object of this store
+    // Returns: true with hash set if it does
+    bool isObjectPath(const std::string& path, std::string& hash) const;
+    
+    // Store content under hash unless an object of that name exists. Given
+    // the object of the previous state as base, content is stored as a
+    // delta against it if the delta is under half the size of content and
+    // the chain stays within kMaxChain; otherwise as a keyframe. Given a
+    // group, the object is written into it and appears when it commits
+    // Returns: true if the object is stored (or queued in group)
+    bool put(const std::string& hash, std::string_view content, const std::string& base = "",
+             SyncGroup* group = nullptr);
+    
+    // Read the content of an object (replaying deltas and decompressing as
+    // needed). The result is checked against hash
+    bool load(const std::string& hash, std::string& content);
+    
+    // Replace a raw keyframe with its .xz form (no effect on compressed
+    // keyframes and deltas)
+    bool compress(const std::string& hash, int level, bool extreme);
+    
+    // Objects needed to read hash: hash itself, then each delta's base down
+    // to the keyframe. Stops early at a missing or unreadable object
+    std::vector<std::string> chainOf(const std::string& hash) const;
+    
+    // Codec of an object path: raw, xz or delta
+    static std::string codecOf(const std::string& path);
+    
+    // --------------------------------------------------------------------------
+    // Manifest
+    // --------------------------------------------------------------------------
+    
+    // Every entry, oldest first, brought up to date with the manifest
+    const std::vector<Entry>& entries();
+    
+    // Entries of file, oldest first
+    std::vector<Entry> entriesOf(const std::string& file);
+    
+    // Latest entry of file; null if it has none
+    const Entry* latest(const std::string& file);
+    
+    // Add entry at the end of the manifest, numbering it (store lock held)
+    bool append(Entry& entry);
+    
+    // Replace the manifest with entries in one step (store lock held)
+    bool rewrite(const std::vector<Entry>& entries);
+    
+    // Note that the legacy backup file at path was imported as hash, so
+    // the path can still be restored once the file is gone (store lock held)
+    bool recordLegacy(const std::string& path, const std::string& hash);
+    
+    // Object a legacy backup file was imported as; empty if it was not
+    std::string legacyHash(const std::string& path) const;
+    
+    // Delete the objects of hashes, and the bases below them, that no
+    // manifest entry needs any more
+    // Returns: Number of objects deleted
+    size_t removeUnreferenced(const std::vector<std::string>& hashes);
+    
+    // --------------------------------------------------------------------------
+    // Locking
+    // --------------------------------------------------------------------------
+    
+    // Serialise changes with other users of the store (other files, other
+    // processes); held around put-and-append and rewrite-and-remove
+    bool lock();
+    void unlock();
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    // Read a keyframe stored at path
+    bool loadKeyframe(const std::string& path, std::string& content);
+    
+    // Replace path with bytes now, or as part of group
+    bool writeObject(const std::string& path, std::string_view bytes, SyncGroup* group);
+    
+    // Read what was added to the manifest since the last call (all of it
+    // if it was replaced)
+    bool refresh();
+    
+    std::string root;           // Store directory
+    std::string manifestPath;   // root/manifest
+    std::string legacyPath;     // root/legacy: "<hash> <imported path>" lines
+    FileLock storeLock;         // Lock shared by all users of the store
+    std::string lastError;      // Last error message
+    
+    // Manifest as read so far
+    std::vector<Entry> manifest;                        // Entries in order
+    std::unordered_map<std::string, size_t> latestOf;   // File -> its last entry
+    uint64_t manifestDevice = 0;    // Identity of the manifest read
+    uint64_t manifestInode = 0;
+    uint64_t manifestRead = 0;      // Bytes of it parsed (whole lines)
+};
+
+#endif // BACKUPSTORE_HPP
@@ -0,0 +1,104 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Character Classification Tables Header
+//
+// This header holds the compile-time 256-entry byte tables shared by alias
+// validation, command escaping and the alias tokenizer. Every table is built
+// by a constexpr function, so classifying a byte is a single indexed load
+// with no locale lookups and no comparison chains.
+// ------------------------------------------------------------------------------
+
+#ifndef CHARCLASS_HPP
+#define CHARCLASS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace charclass {
+
+// ------------------------------------------------------------------------------
+// Byte Properties (bit flags)
+// ------------------------------------------------------------------------------
+enum Prop : uint8_t {
+    kNameStart = 1 << 0,   // May start an alias name: letter, digit, '_'
+    kNameChar  = 1 << 1,   // May appear in an alias name: kNameStart or '-'
+    kEscape    = 1 << 2,   // Escaped by escapeCommand: ' " \ $ ` ! * ?
+    kBlank     = 1 << 3    // Space or tab
+};
+
+// Bytes that escapeCommand prefixes with a backslash
+inline constexpr std::string_view kEscapedChars = "'\"\\$`!*?";
+
+inline constexpr std::array<uint8_t, 256> kProps = [] {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        bool alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || 
+                     (c >= '0' && c <= '9');
+        if (alnum || c == '_') {
+            table[c] |= kNameStart | kNameChar;
+        }
+        if (c == '-') {
+            table[c] |= kNameChar;
+        }
+        if (c == ' ' || c == '\t') {
+            table[c] |= kBlank;
+        }
+    }
+    for (char c : kEscapedChars) {
+        table[static_cast<unsigned char>(c)] |= kEscape;
+    }
+    return table;
+}();
+
+// Get the property bits of a byte
+constexpr uint8_t props(char c) {
+    return kProps[static_cast<unsigned char>(c)];
+}
+
+// Check whether a byte has any of the given property bits
+constexpr bool has(char c, uint8_t prop) {
+    return (props(c) & prop) != 0;
+}
+
+} // namespace charclass
+
+// ------------------------------------------------------------------------------
+// Tokenizer Character Classes
+// Partition of all bytes into the columns of the tokenizer transition table
+// ------------------------------------------------------------------------------
+enum class TokClass : uint8_t {
+    Other,        // Any byte without special meaning
+    Blank,        // Space or tab
+    Newline,      // '\n'
+    Equals,       // '='
+    SingleQuote,  // '\''
+    DoubleQuote,  // '"'
+    Backslash,    // '\\'
+    Hash,         // '#'
+    Dash,         // '-'
+    Separator,    // ';', '&', '|', '(', ')', '<', '>'
+    Count
+};
+
+inline constexpr std::array<TokClass, 256> kTokClassTable = [] {
+    std::array<TokClass, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = (charclass::kProps[c] & charclass::kBlank) ? TokClass::Blank 
+                                                               : TokClass::Other;
+    }
+    table[static_cast<unsigned char>('\n')] = TokClass::Newline;
+    table[static_cast<unsigned char>('=')] = TokClass::Equals;
+    table[static_cast<unsigned char>('\'')] = TokClass::SingleQuote;
+    table[static_cast<unsigned char>('"')] = TokClass::DoubleQuote;
+    table[static_cast<unsigned char>('\\')] = TokClass::Backslash;
+    table[static_cast<unsigned char>('#')] = TokClass::Hash;
+    table[static_cast<unsigned char>('-')] = TokClass::Dash;
+    for (char c : {';', '&', '|', '(', ')', '<', '>'}) {
+        table[static_cast<unsigned char>(c)] = TokClass::Separator;
+    }
+    return table;
+}();
+
+#endif // CHARCLASS_HPP
@@ -10,13 +10,48 @@
 // ------------------------------------------------------------------------------
 
 #include "configfilehandler.hpp"
-#include <fstream>        // File stream operations
+#include "linescanner.hpp"  // Bulk alias line detection
+#include "aliastokenizer.hpp" // Shell-specific alias statement tokenizer
+#include "threadpool.hpp"   // Parallel parsing of large files
+#include "mappedfile.hpp"   // Zero-copy file access
+#include "atomicwriter.hpp" // Crash-safe file replacement
+#include "backupmanager.hpp" // Backups taken by transactions
+#include "hash.hpp"         // Content hash for the parse cache
+#include "filelock.hpp"     // Writer lock shared with other processes
+#include "linemerge.hpp"    // Three-way merge against the merge base
+#include "syscalls.hpp"     // Counted metadata calls
+#include <algorithm>      // For std::any_of, std::count, std::min, std::max
+#include <chrono>         // Commit retry back-off
+#include <memory>         // For std::unique_ptr
+#include <optional>       // Alias presence in conflict checks
+#include <random>         // Back-off jitter
+#include <thread>         // For std::this_thread::sleep_for
+#include <unordered_map>  // Transaction name lookup
 #include <filesystem>     // Filesystem path operations
+#include <cerrno>         // For errno
+#include <fcntl.h>        // For O_* flags
 #include <sys/stat.h>     // File permission handling
+#include <system_error>   // For std::error_code
+#include <unistd.h>       // For pread, pwrite, write, ftruncate, close
 
 // Alias for convenience
 namespace fs = std::filesystem;
 
+// Commit attempts that read without the writer lock, and in total
+static constexpr int kOptimisticAttempts = 4;
+static constexpr int kCommitAttempts = 8;
+
+// ------------------------------------------------------------------------------
+// Structure: LockRelease
+// Purpose: Releases a held FileLock at scope exit (its lock file stays open).
+// ------------------------------------------------------------------------------
+namespace {
+struct LockRelease {
+    FileLock& lock;
+    ~LockRelease() { lock.unlock(); }
+};
+}
+
 // ------------------------------------------------------------------------------
 // Constructor
 // Initializes with configuration file path and shell type
@@ -30,42 +65,653 @@ ConfigFileHandler::ConfigFileHandler(const std::string& configFilePath,
     // Initialize alias manager with the specified shell type
 }
 
+// ------------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------------
+ConfigFileHandler::~ConfigFileHandler() {
+    if (dirFd >= 0) {
+        close(dirFd);
+    }
+}
+
 // ------------------------------------------------------------------------------
 // Load Aliases from Configuration File
 // Parses the configuration file and extracts all alias definitions
 // ------------------------------------------------------------------------------
 std::vector<Alias> ConfigFileHandler::loadAliases() {
-    std::vector<Alias> aliases;
+    return loadAliasTable().toAliases();
+}
+
+// ------------------------------------------------------------------------------
+// Load Aliases into a Table
+// The file is mapped, alias statements are tokenized in place and the
+// definitions are copied once into the table's arena. With the cache on,
+// an unchanged file (same identity and content hash) is not parsed at all:
+// the table and the definition index come straight from the cache entry.
+// The file is opened once, relative to the held directory, and stat once.
+// ------------------------------------------------------------------------------
+AliasTable ConfigFileHandler::loadAliasTable() {
+    return loadTable(nullptr, nullptr);
+}
+
+AliasTable ConfigFileHandler::loadAliasTable(std::string& content,
+                                             std::vector<CachedDefinition>& locations) {
+    return loadTable(&content, &locations);
+}
+
+AliasTable ConfigFileHandler::loadTable(std::string* content,
+                                        std::vector<CachedDefinition>* locations) {
+    syscalls::Tally tally(lastSyscalls);
+    AliasTable table;
+    if (content != nullptr) {
+        content->clear();
+        locations->clear();
+    }
     
     // Check if file exists
-    if (!configFileExists()) {
-        lastError = "Config file does not exist: " + configFilePath;
-        return aliases;  // Return empty vector
+    int fd = openConfig(O_RDONLY, false);
+    if (fd < 0) {
+        lastError = (errno == ENOENT ? "Config file does not exist: "
+                                     : "Cannot open config file for reading: ") + configFilePath;
+        return table;  // Return empty table
     }
     
-    // Open file for reading
-    std::ifstream file(configFilePath);
-    if (!file.is_open()) {
+    // Map the whole file; it is read front to back, so prefault it
+    struct stat sb;
+    MappedFile file;
+    if (syscalls::fstat(fd, &sb) != 0 ||
+        !(S_ISREG(sb.st_mode) ? file.openRegular(fd, static_cast<size_t>(sb.st_size), true)
+                              : file.open(fd, true))) {
         lastError = "Cannot open config file for reading: " + configFilePath;
-        return aliases;
+        close(fd);
+        return table;
+    }
+    close(fd);
+    const FileStamp stamp = toStamp(sb);
+    if (content != nullptr) {
+        content->assign(file.view());
     }
     
-    // Read file line by line
-    std::string line;
-    while (std::getline(file, line)) {
-        // Check if line contains an alias definition
-        if (AliasManager::isAliasLine(line)) {
-            // Parse the alias line
-            Alias parsed = AliasManager::parseAliasLine(line);
-            
-            // Add to list if parsing succeeded
-            if (!parsed.name.empty()) {
-                aliases.push_back(std::move(parsed));
+    // Unchanged since the last parse: take the cached result
+    AliasCache cache(configFilePath);
+    CacheKey key;
+    std::vector<CachedDefinition> cached;
+    if (cacheEnabled) {
+        key = {stamp.device, stamp.inode, stamp.size, stamp.mtimeNs,
+               hash::bytes(file.view()), static_cast<uint32_t>(shell)};
+        if (cache.load(key, table, cached)) {
+            setIndex(table, cached, stamp);
+            if (locations != nullptr) {
+                *locations = std::move(cached);
+            }
+            return table;
+        }
+    }
+    
+    std::vector<AliasDefinition> definitions;
+    tokenizeBuffer(file.view(), definitions);
+    
+    // Remember where every definition is for later edits
+    setIndex(definitions, stamp);
+    
+    // Size the arena from the raw slices (resolved text is never longer)
+    size_t arenaBytes = 0;
+    for (const AliasDefinition& def : definitions) {
+        arenaBytes += def.view.name.size() + def.view.command.size();
+    }
+    table.reserve(definitions.size(), arenaBytes);
+    
+    for (const AliasDefinition& def : definitions) {
+        table.append(def.view, def.lineNumber);
+    }
+    
+    if (cacheEnabled || locations != nullptr) {
+        cached.reserve(definitions.size());
+        for (const AliasDefinition& def : definitions) {
+            cached.push_back({def.offset, def.length, def.statementOffset, def.statementEnd});
+        }
+    }
+    
+    // Save the result for the next load (a failure only costs a re-parse)
+    if (cacheEnabled) {
+        cache.store(key, table, cached);
+    }
+    if (locations != nullptr) {
+        *locations = std::move(cached);
+    }
+    
+    return table;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Tokenize the Statements at Scanner Hits
+// hits carry absolute offsets and line numbers relative to the text they
+// were scanned in; hits inside a statement that ends past them are skipped.
+// Returns the end of the last statement (at least statementEnd).
+// ------------------------------------------------------------------------------
+static size_t tokenizeHits(ShellDetector::Shell shell, std::string_view text,
+                           const std::vector<LineRef>& hits, size_t statementEnd,
+                           std::vector<AliasDefinition>& out) {
+    for (const LineRef& ref : hits) {
+        // Lines already consumed as continuations of a previous statement
+        if (ref.offset < statementEnd) continue;
+        
+        statementEnd = AliasTokenizer::tokenizeStatement(shell, text, ref.offset,
+                                                         ref.lineNumber, out);
+    }
+    return statementEnd;
+}
+
+// ------------------------------------------------------------------------------
+// Structure: ParseChunk
+// Purpose: Input and output of one chunk of a parallel parse.
+// ------------------------------------------------------------------------------
+namespace {
+struct ParseChunk {
+    size_t begin = 0;                        // First byte (a line start)
+    size_t end = 0;                          // One past the last byte
+    std::vector<LineRef> hits;               // Alias lines, chunk-relative lines
+    std::vector<AliasDefinition> defs;       // Definitions found in the chunk
+    size_t statementEnd = 0;                 // End of the chunk's last statement
+    size_t newlines = 0;                     // Newlines inside [begin, end)
+};
+}
+
+// Minimum chunk size; smaller chunks cost more in scheduling than they save
+static constexpr size_t kMinChunkBytes = size_t(256) << 10;
+
+// Chunks per pool thread, so that uneven chunks still balance out
+static constexpr size_t kChunksPerThread = 4;
+
+// ------------------------------------------------------------------------------
+// Tokenize a Whole Buffer
+// Large buffers are cut at line boundaries (never inside a continuation)
+// and each chunk is scanned and tokenized on the shared thread pool. The
+// chunks are merged in file order, shifting line numbers by the newlines
+// of the chunks before them. A statement may still run past its chunk
+// (a quoted value spanning lines); the next chunk was parsed without
+// knowing that, so it is then re-tokenized from the statement's end.
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::tokenizeBuffer(std::string_view text,
+                                       std::vector<AliasDefinition>& out) const {
+    ThreadPool& pool = ThreadPool::shared();
+    const size_t maxChunks = std::min(pool.size() * kChunksPerThread,
+                                      text.size() / kMinChunkBytes);
+    
+    // Small inputs: one pass on this thread
+    if (parallelThreshold == 0 || text.size() < parallelThreshold || maxChunks < 2) {
+        std::vector<LineRef> hits = LineScanner::findAliasLines(text);
+        out.reserve(out.size() + hits.size());
+        tokenizeHits(shell, text, hits, 0, out);
+        return;
+    }
+    
+    // Cut the buffer into roughly equal chunks at safe line boundaries
+    std::vector<ParseChunk> chunks;
+    chunks.reserve(maxChunks);
+    size_t begin = 0;
+    for (size_t k = 1; k <= maxChunks && begin < text.size(); ++k) {
+        size_t end = (k == maxChunks) ? text.size()
+                   : AliasTokenizer::nextLineBoundary(text, text.size() / maxChunks * k);
+        if (end <= begin) continue;
+        chunks.push_back({});
+        chunks.back().begin = begin;
+        chunks.back().end = end;
+        begin = end;
+    }
+    
+    // Scan and tokenize every chunk independently
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        ParseChunk& chunk = chunks[i];
+        std::string_view part = text.substr(chunk.begin, chunk.end - chunk.begin);
+        
+        chunk.hits = LineScanner::findAliasLines(part);
+        for (LineRef& ref : chunk.hits) {
+            ref.offset += chunk.begin;
+        }
+        chunk.defs.reserve(chunk.hits.size());
+        chunk.statementEnd = tokenizeHits(shell, text, chunk.hits, 0, chunk.defs);
+        chunk.newlines = static_cast<size_t>(std::count(part.begin(), part.end(), '\n'));
+    });
+    
+    // Merge in file order
+    size_t total = 0;
+    for (const ParseChunk& chunk : chunks) {
+        total += chunk.defs.size();
+    }
+    out.reserve(out.size() + total);
+    
+    size_t statementEnd = 0;
+    size_t linesBefore = 0;
+    for (ParseChunk& chunk : chunks) {
+        if (statementEnd > chunk.begin) {
+            // The previous chunk's last statement ran into this one
+            chunk.defs.clear();
+            chunk.statementEnd = tokenizeHits(shell, text, chunk.hits, statementEnd, chunk.defs);
+        }
+        for (AliasDefinition& def : chunk.defs) {
+            def.lineNumber += linesBefore;
+            out.push_back(def);
+        }
+        statementEnd = std::max(statementEnd, chunk.statementEnd);
+        linesBefore += chunk.newlines;
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Write a Whole Buffer at an Offset
+// ------------------------------------------------------------------------------
+static bool pwriteAll(int fd, const char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Read a Whole Range at an Offset
+// ------------------------------------------------------------------------------
+static bool preadAll(int fd, char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) {
+            return false;  // File shorter than expected
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Write a Whole Buffer at the Current Position
+// ------------------------------------------------------------------------------
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Hash the Content of an Open Regular File of size Bytes
+// ------------------------------------------------------------------------------
+static bool contentHash(int fd, uint64_t size, uint64_t& out) {
+    MappedFile file;
+    if (!file.openRegular(fd, static_cast<size_t>(size))) {
+        return false;
+    }
+    out = hash::bytes(file.view());
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Aliases Both Sides of a Merge Conflict Set Differently
+// Compares the last definition of every name in the three versions of the
+// region (absent counts as a value, so removed-here, changed-there is a
+// conflict too); names is appended to
+// ------------------------------------------------------------------------------
+static void conflictingAliases(ShellDetector::Shell shell, const LineMerge::Conflict& conflict,
+                               std::vector<std::string>& names) {
+    using Definitions = std::unordered_map<std::string_view, std::string_view>;
+    auto parse = [shell](std::string_view text) {
+        std::vector<AliasDefinition> definitions;
+        AliasTokenizer::tokenize(shell, text, definitions);
+        Definitions last;
+        for (const AliasDefinition& def : definitions) {
+            last[def.view.name] = def.view.command;
+        }
+        return last;
+    };
+    const Definitions base = parse(conflict.base);
+    const Definitions theirs = parse(conflict.theirs);
+    const Definitions ours = parse(conflict.ours);
+    
+    auto lookup = [](const Definitions& set, std::string_view name) {
+        auto it = set.find(name);
+        return it == set.end() ? std::nullopt : std::optional<std::string_view>(it->second);
+    };
+    for (const Definitions* side : {&theirs, &ours}) {
+        for (const auto& [name, command] : *side) {
+            const auto b = lookup(base, name);
+            const auto t = lookup(theirs, name);
+            const auto o = lookup(ours, name);
+            if (t != b && o != b && t != o) {
+                names.emplace_back(name);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Compute Cut Ranges
+// For each definition, the range that removes it alone from its statement:
+// itself up to the next definition, or for the last one, from the end of
+// the previous definition (so no blanks are left dangling)
+// ------------------------------------------------------------------------------
+template <typename Def>
+static void computeCuts(std::vector<Def>& defs) {
+    for (size_t i = 0; i < defs.size(); ++i) {
+        Def& def = defs[i];
+        const bool hasNext = i + 1 < defs.size() &&
+                             defs[i + 1].statementOffset == def.statementOffset;
+        const bool hasPrev = i > 0 && defs[i - 1].statementOffset == def.statementOffset;
+        
+        if (hasNext) {
+            def.cutOffset = def.offset;
+            def.cutEnd = defs[i + 1].offset;
+        } else if (hasPrev) {
+            def.cutOffset = defs[i - 1].offset + defs[i - 1].length;
+            def.cutEnd = def.offset + def.length;
+        } else {
+            def.cutOffset = def.offset;
+            def.cutEnd = def.offset + def.length;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Read File Stamp
+// ------------------------------------------------------------------------------
+ConfigFileHandler::FileStamp ConfigFileHandler::toStamp(const struct stat& sb) {
+    FileStamp stamp;
+    stamp.device = static_cast<uint64_t>(sb.st_dev);
+    stamp.inode = static_cast<uint64_t>(sb.st_ino);
+    stamp.size = static_cast<uint64_t>(sb.st_size);
+    stamp.mtimeNs = int64_t(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+    stamp.ctimeNs = int64_t(sb.st_ctim.tv_sec) * 1000000000 + sb.st_ctim.tv_nsec;
+    return stamp;
+}
+
+bool ConfigFileHandler::readStamp(int fd, FileStamp& stamp) {
+    struct stat sb;
+    if (syscalls::fstat(fd, &sb) != 0) {
+        return false;
+    }
+    stamp = toStamp(sb);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Index Tokenized Definitions
+// ------------------------------------------------------------------------------
+std::vector<ConfigFileHandler::IndexedDefinition>
+ConfigFileHandler::indexDefinitions(const std::vector<AliasDefinition>& definitions) {
+    std::vector<IndexedDefinition> index;
+    index.reserve(definitions.size());
+    for (const AliasDefinition& def : definitions) {
+        IndexedDefinition entry;
+        entry.name.assign(def.view.name);
+        entry.offset = def.offset;
+        entry.length = def.length;
+        entry.statementOffset = def.statementOffset;
+        entry.statementEnd = def.statementEnd;
+        index.push_back(std::move(entry));
+    }
+    computeCuts(index);
+    return index;
+}
+
+// ------------------------------------------------------------------------------
+// Build the Definition Index
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::setIndex(const std::vector<AliasDefinition>& definitions,
+                                 const FileStamp& stamp) {
+    definitionIndex = indexDefinitions(definitions);
+    indexStamp = stamp;
+    indexValid = true;
+}
+
+void ConfigFileHandler::setIndex(const AliasTable& table,
+                                 const std::vector<CachedDefinition>& definitions,
+                                 const FileStamp& stamp) {
+    definitionIndex.clear();
+    definitionIndex.reserve(definitions.size());
+    for (size_t row = 0; row < definitions.size(); ++row) {
+        const CachedDefinition& def = definitions[row];
+        IndexedDefinition entry;
+        entry.name.assign(table.name(row));
+        entry.offset = static_cast<size_t>(def.offset);
+        entry.length = static_cast<size_t>(def.length);
+        entry.statementOffset = static_cast<size_t>(def.statementOffset);
+        entry.statementEnd = static_cast<size_t>(def.statementEnd);
+        definitionIndex.push_back(std::move(entry));
+    }
+    computeCuts(definitionIndex);
+    
+    indexStamp = stamp;
+    indexValid = true;
+}
+
+// ------------------------------------------------------------------------------
+// Refresh the Definition Index
+// Re-parses the file only if it differs from the indexed state
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::refreshIndex(int fd) {
+    FileStamp stamp;
+    if (!readStamp(fd, stamp)) {
+        return false;
+    }
+    if (indexValid && stamp == indexStamp) {
+        return true;
+    }
+    
+    MappedFile file;
+    if (!file.openRegular(fd, static_cast<size_t>(stamp.size))) {
+        return false;
+    }
+    std::vector<AliasDefinition> definitions;
+    tokenizeBuffer(file.view(), definitions);
+    setIndex(definitions, stamp);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Normalize Edits
+// Sorts edits by offset and merges overlapping deletions; other overlaps
+// and edits past fileSize are rejected
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::normalizeEdits(std::vector<FileEdit>& edits, uint64_t fileSize,
+                                       std::string& error) {
+    std::sort(edits.begin(), edits.end(),
+              [](const FileEdit& a, const FileEdit& b) { return a.offset < b.offset; });
+    
+    std::vector<FileEdit> merged;
+    merged.reserve(edits.size());
+    for (FileEdit& edit : edits) {
+        if (edit.offset + edit.length > fileSize) {
+            error = "Edit beyond end of file";
+            return false;
+        }
+        if (!merged.empty() && edit.offset < merged.back().offset + merged.back().length) {
+            FileEdit& last = merged.back();
+            if (!edit.replacement.empty() || !last.replacement.empty()) {
+                error = "Overlapping edits";
+                return false;
+            }
+            last.length = std::max(last.offset + last.length, edit.offset + edit.length) - last.offset;
+            continue;
+        }
+        merged.push_back(std::move(edit));
+    }
+    edits = std::move(merged);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Splice Edits into Text
+// text holds the file from byte origin on; edits are normalized and lie
+// inside it
+// ------------------------------------------------------------------------------
+std::string ConfigFileHandler::spliceEdits(std::string_view text, uint64_t origin,
+                                           const std::vector<FileEdit>& edits) {
+    std::string out;
+    out.reserve(text.size());
+    size_t pos = 0;  // Position within text
+    for (const FileEdit& edit : edits) {
+        const size_t at = static_cast<size_t>(edit.offset - origin);
+        out.append(text, pos, at - pos);
+        out.append(edit.replacement);
+        pos = at + edit.length;
+    }
+    out.append(text, pos, std::string_view::npos);
+    return out;
+}
+
+// ------------------------------------------------------------------------------
+// Write Edits
+// Only the suffix from the first edit is read and rebuilt. In atomic mode
+// a new file is assembled from the unchanged prefix (copy_file_range) and
+// the rebuilt suffix and renamed over the target; in in-place mode the
+// suffix is written back into the live file. Writes the caller queued in
+// group (a backup) are durable before the target changes: in-place mode
+// commits them first, atomic mode commits them with the new file and
+// renames them first. Deleted definitions leave the index and the others
+// are shifted; an edit that inserts text invalidates the index (re-parsed
+// on next use).
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::writeEdits(int fd, uint64_t fileSize, std::vector<FileEdit>& edits,
+                                   SyncGroup* group) {
+    if (!normalizeEdits(edits, fileSize, lastError)) {
+        return false;
+    }
+    SyncGroup single;
+    SyncGroup& sync = group != nullptr ? *group : single;
+    if (writeMode == WriteMode::InPlace && sync.size() > 0 && !sync.commit()) {
+        lastError = "Cannot write config file: " + sync.getLastError();
+        return false;
+    }
+    
+    const uint64_t first = edits.front().offset;
+    bool inserts = false;
+    for (const FileEdit& edit : edits) {
+        inserts |= !edit.replacement.empty();
+    }
+    
+    // Descriptor of the file holding the result (for the new stamp)
+    int resultFd = fd;
+    std::unique_ptr<AtomicWriter> writer;
+    
+    if (writeMode == WriteMode::InPlace && edits.size() == 1 &&
+        edits[0].replacement.size() == edits[0].length) {
+        // Same length: splice the bytes in place
+        const FileEdit& edit = edits[0];
+        if (!pwriteAll(fd, edit.replacement.data(), edit.replacement.size(), edit.offset)) {
+            lastError = "Cannot write config file";
+            indexValid = false;
+            return false;
+        }
+    } else {
+        // Read the suffix and apply the edits to it
+        std::string suffix(static_cast<size_t>(fileSize - first), '\0');
+        if (!preadAll(fd, suffix.data(), suffix.size(), first)) {
+            lastError = "Cannot read config file";
+            return false;
+        }
+        
+        const std::string tail = spliceEdits(suffix, first, edits);
+        
+        if (writeMode == WriteMode::Atomic) {
+            // New file: unchanged prefix copied by the kernel, then the tail
+            writer = std::make_unique<AtomicWriter>(dirFd, fileName, fd);
+            if (!writer->open() || !writer->copyRange(fd, 0, first) || !writer->write(tail)) {
+                lastError = "Cannot write config file: " + writer->getLastError();
+                return false;
+            }
+            sync.add(*writer);
+            if (!sync.commit()) {
+                lastError = "Cannot write config file: " + sync.getLastError();
+                return false;
+            }
+            resultFd = writer->fd();
+        } else if (!pwriteAll(fd, tail.data(), tail.size(), first) ||
+                   (tail.size() < suffix.size() &&
+                    ftruncate(fd, static_cast<off_t>(first + tail.size())) != 0)) {
+            // Rewrite the suffix of the live file
+            lastError = "Cannot write config file";
+            indexValid = false;
+            return false;
+        }
+    }
+    
+    // Bring the index up to date without re-parsing
+    if (inserts || !indexValid) {
+        indexValid = false;
+        return true;
+    }
+    
+    auto shift = [&edits](size_t p) {
+        size_t removed = 0;
+        for (const FileEdit& edit : edits) {
+            if (edit.offset >= p) break;
+            removed += std::min(edit.length, p - edit.offset);
+        }
+        return p - removed;
+    };
+    
+    std::vector<IndexedDefinition> kept;
+    kept.reserve(definitionIndex.size());
+    for (IndexedDefinition& def : definitionIndex) {
+        bool hit = false;
+        for (const FileEdit& edit : edits) {
+            if (edit.offset < def.offset + def.length && def.offset < edit.offset + edit.length) {
+                hit = true;
+                break;
             }
         }
+        if (hit) continue;
+        
+        def.offset = shift(def.offset);
+        def.statementOffset = shift(def.statementOffset);
+        def.statementEnd = shift(def.statementEnd);
+        kept.push_back(std::move(def));
     }
+    definitionIndex = std::move(kept);
+    computeCuts(definitionIndex);
     
-    return aliases;
+    if (!readStamp(resultFd, indexStamp)) {
+        indexValid = false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Set Write Mode
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::setWriteMode(WriteMode mode) {
+    writeMode = mode;
+}
+
+// ------------------------------------------------------------------------------
+// Enable or Disable the Parse Cache
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::setCacheEnabled(bool enabled) {
+    cacheEnabled = enabled;
+}
+
+// ------------------------------------------------------------------------------
+// Set Parallel Parse Threshold
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::setParallelThreshold(size_t bytes) {
+    parallelThreshold = bytes;
 }
 
 // ------------------------------------------------------------------------------
@@ -73,6 +719,8 @@ std::vector<Alias> ConfigFileHandler::loadAliases() {
 // Appends a new alias definition to the end of the file
 // ------------------------------------------------------------------------------
 bool ConfigFileHandler::addAlias(const Alias& alias) {
+    syscalls::Tally tally(lastSyscalls);
+    
     // Validate alias before adding
     if (!AliasManager::validateAliasName(alias.name) || 
         !AliasManager::validateCommand(alias.command)) {
@@ -80,70 +728,513 @@ bool ConfigFileHandler::addAlias(const Alias& alias) {
         return false;
     }
     
-    // Ensure file exists (create if necessary)
-    if (!ensureFileExists()) {
-        lastError = "Cannot create config file";
+    // Append under the writer lock, so the bytes land in the file that
+    // survives a concurrent atomic rewrite
+    if (!writerLock.lock(configFilePath)) {
+        lastError = writerLock.getLastError();
         return false;
     }
+    LockRelease release{writerLock};
     
-    // Open file in append mode
-    std::ofstream file(configFilePath, std::ios::app);
-    if (!file.is_open()) {
+    // Open for appending (create if necessary)
+    int fd = openConfig(O_WRONLY | O_APPEND, true);
+    if (fd < 0) {
         lastError = "Cannot open config file for writing";
         return false;
     }
     
     // Format alias according to shell syntax and append to file
-    file << '\n' << aliasManager.formatAlias(alias);
-    
-    // Ensure proper file permissions
-    setFilePermissions();
-    
-    return true;
+    const std::string line = '\n' + aliasManager.formatAlias(alias);
+    const bool ok = writeAll(fd, line.data(), line.size());
+    close(fd);
+    if (!ok) {
+        lastError = "Cannot write config file";
+    }
+    return ok;
 }
 
 // ------------------------------------------------------------------------------
 // Remove Alias from Configuration File
-// Removes an alias definition by name, preserving other content
+// Removes every definition of the alias, preserving all other bytes. A
+// statement that only defines this alias is removed with its lines; from a
+// statement that defines several, only the name=value word is cut. Only the
+// part of the file after the first removal is rewritten.
 // ------------------------------------------------------------------------------
 bool ConfigFileHandler::removeAlias(const std::string& aliasName) {
-    // Check if file exists
-    if (!configFileExists()) {
-        lastError = "Config file does not exist";
+    Transaction transaction(*this);
+    transaction.remove(aliasName);
+    return transaction.commit();
+}
+
+// ------------------------------------------------------------------------------
+// Update Alias in Place
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::updateAlias(const std::string& aliasName, const std::string& newCommand) {
+    Transaction transaction(*this);
+    transaction.update(aliasName, newCommand);
+    return transaction.commit();
+}
+
+// ------------------------------------------------------------------------------
+// Rename Alias in Place
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::renameAlias(const std::string& oldName, const std::string& newName) {
+    Transaction transaction(*this);
+    transaction.rename(oldName, newName);
+    return transaction.commit();
+}
+
+// ------------------------------------------------------------------------------
+// Apply Byte Edits
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::applyEdits(std::vector<FileEdit> edits) {
+    syscalls::Tally tally(lastSyscalls);
+    if (edits.empty()) {
+        return true;
+    }
+    
+    if (!writerLock.lock(configFilePath)) {
+        lastError = writerLock.getLastError();
+        return false;
+    }
+    LockRelease release{writerLock};
+    int fd = openConfig(O_RDWR, false);
+    if (fd < 0) {
+        lastError = "Cannot open config file for writing";
         return false;
     }
     
-    // Read all lines from file
-    auto lines = readAllLines();
-    if (lines.empty()) {
-        lastError = "Failed to read config file";
+    // Offsets are only meaningful for the indexed version
+    FileStamp stamp;
+    if (!readStamp(fd, stamp) || !indexValid || !(stamp == indexStamp)) {
+        close(fd);
+        lastError = "Config file changed on disk; reload before editing";
         return false;
     }
     
-    bool found = false;
-    std::vector<std::string> newLines;
-    newLines.reserve(lines.size());  // Pre-allocate for efficiency
+    bool ok = writeEdits(fd, stamp.size, edits);
+    close(fd);
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Begin Transaction
+// ------------------------------------------------------------------------------
+ConfigFileHandler::Transaction ConfigFileHandler::beginTransaction() {
+    return Transaction(*this);
+}
+
+// ------------------------------------------------------------------------------
+// Merge Base
+// ------------------------------------------------------------------------------
+void ConfigFileHandler::setMergeBase(std::string content) {
+    mergeBase = std::move(content);
+    hasMergeBase = true;
+}
+
+void ConfigFileHandler::clearMergeBase() {
+    mergeBase.clear();
+    hasMergeBase = false;
+}
+
+const std::vector<std::string>& ConfigFileHandler::getConflicts() const {
+    return conflicts;
+}
+
+// ------------------------------------------------------------------------------
+// Transaction: Constructor and Queue
+// ------------------------------------------------------------------------------
+ConfigFileHandler::Transaction::Transaction(ConfigFileHandler& handler)
+    : handler(handler) {
+}
+
+void ConfigFileHandler::Transaction::add(const Alias& alias) {
+    operations.push_back({OpKind::Add, alias.name, alias.command});
+}
+
+void ConfigFileHandler::Transaction::update(const std::string& name, const std::string& command) {
+    operations.push_back({OpKind::Update, name, command});
+}
+
+void ConfigFileHandler::Transaction::remove(const std::string& name) {
+    operations.push_back({OpKind::Remove, name, {}});
+}
+
+void ConfigFileHandler::Transaction::rename(const std::string& oldName, const std::string& newName) {
+    operations.push_back({OpKind::Rename, oldName, newName});
+}
+
+size_t ConfigFileHandler::Transaction::size() const {
+    return operations.size();
+}
+
+bool ConfigFileHandler::Transaction::empty() const {
+    return operations.empty();
+}
+
+void ConfigFileHandler::Transaction::clear() {
+    operations.clear();
+}
+
+// ------------------------------------------------------------------------------
+// Transaction: Commit
+// Each attempt reads the file without the writer lock and only takes it to
+// check and write. Another writer getting in between makes the attempt a
+// conflict, and it is retried after a short randomised pause; once
+// kOptimisticAttempts have conflicted, the lock is held for the whole
+// attempt so a busy file cannot starve the commit.
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::Transaction::commit(BackupManager* backup) {
+    ConfigFileHandler& h = handler;
+    syscalls::Tally tally(h.lastSyscalls);
+    h.conflicts.clear();
+    if (operations.empty()) {
+        return true;
+    }
+    
+    // Validate every operation before touching the file
+    for (const Operation& op : operations) {
+        bool valid = AliasManager::validateAliasName(op.name);
+        if (op.kind == OpKind::Add || op.kind == OpKind::Update) {
+            valid = valid && AliasManager::validateCommand(op.value);
+        } else if (op.kind == OpKind::Rename) {
+            valid = valid && AliasManager::validateAliasName(op.value);
+        }
+        if (!valid) {
+            h.lastError = "Invalid alias name or command: " + op.name;
+            return false;
+        }
+    }
+    
+    FileLock& lock = h.writerLock;
+    std::minstd_rand jitter(static_cast<unsigned>(getpid()) ^
+        static_cast<unsigned>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    for (int attempt = 0; attempt < kCommitAttempts; ++attempt) {
+        const bool pessimistic = attempt >= kOptimisticAttempts;
+        if (pessimistic && !lock.lock(h.configFilePath)) {
+            h.lastError = lock.getLastError();
+            return false;
+        }
+        
+        const Outcome outcome = tryCommit(backup, lock);
+        if (!pessimistic || outcome != Outcome::Conflict) {
+            lock.unlock();
+        }
+        if (outcome != Outcome::Conflict) {
+            return outcome == Outcome::Written;
+        }
+        
+        // Back off for up to 2^attempt ms so contending writers spread out
+        std::this_thread::sleep_for(std::chrono::microseconds(jitter() % (1000u << attempt)));
+    }
     
-    // Filter out the alias to be removed
-    for (auto& line : lines) {
-        if (AliasManager::isAliasLine(line)) {
-            Alias parsed = AliasManager::parseAliasLine(line);
-            if (parsed.name == aliasName) {
-                found = true;      // Mark as found
-                continue;          // Skip this line (don't add to newLines)
+    lock.unlock();
+    h.lastError = "Config file changed during every commit attempt";
+    return false;
+}
+
+// ------------------------------------------------------------------------------
+// Transaction: Plan Edits
+// The operations are first replayed on a per-name model of the file, then
+// the final state of each name is turned into edits of its definitions:
+// - removed: the whole statement, or just the word if it defines others
+// - new command: the last definition's name=value word is replaced
+// - renamed only: the name bytes of every definition are replaced
+// - new aliases: appended together at the end of the file
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::Transaction::planEdits(const std::vector<IndexedDefinition>& index,
+                                               std::string_view content,
+                                               std::vector<FileEdit>& edits) const {
+    ConfigFileHandler& h = handler;
+    const size_t fileSize = content.size();
+    
+    // One entry per alias name: those in the file, then new ones
+    struct Entry {
+        std::string fileName;    // Name in the file (empty for a new alias)
+        std::string name;        // Name after the operations so far
+        std::string command;     // Replacement command (if changed)
+        bool changed = false;    // Command replaced
+        bool removed = false;    // All definitions deleted
+        size_t last = 0;         // Index of the last definition in the file
+    };
+    std::vector<Entry> entries;
+    std::vector<size_t> owner(index.size());  // Entry of each definition
+    std::unordered_map<std::string, size_t> live;  // Current name -> entry
+    
+    for (size_t i = 0; i < index.size(); ++i) {
+        auto [it, inserted] = live.emplace(index[i].name, entries.size());
+        if (inserted) {
+            entries.push_back({index[i].name, index[i].name, {}, false, false, 0});
+        }
+        owner[i] = it->second;
+        entries[it->second].last = i;
+    }
+    
+    // Replay the operations on the model
+    auto fail = [&h](const std::string& message) {
+        h.lastError = message;
+        return false;
+    };
+    for (const Operation& op : operations) {
+        auto it = live.find(op.name);
+        switch (op.kind) {
+            case OpKind::Add:
+                if (it == live.end()) {
+                    live.emplace(op.name, entries.size());
+                    entries.push_back({{}, op.name, op.value, true, false, 0});
+                    break;
+                }
+                [[fallthrough]];
+            case OpKind::Update:
+                if (it == live.end()) {
+                    return fail("Alias not found: " + op.name);
+                }
+                entries[it->second].command = op.value;
+                entries[it->second].changed = true;
+                break;
+            case OpKind::Remove:
+                if (it == live.end()) {
+                    return fail("Alias not found: " + op.name);
+                }
+                entries[it->second].removed = true;
+                live.erase(it);
+                break;
+            case OpKind::Rename: {
+                if (it == live.end()) {
+                    return fail("Alias not found: " + op.name);
+                }
+                if (op.value == op.name) {
+                    break;
+                }
+                if (live.count(op.value) != 0) {
+                    return fail("Alias already exists: " + op.value);
+                }
+                const size_t entry = it->second;
+                live.erase(it);
+                live.emplace(op.value, entry);
+                entries[entry].name = op.value;
+                break;
+            }
+        }
+    }
+    
+    // The name=value word of a definition in this shell's syntax
+    auto definition = [&h](const std::string& name, const std::string& command) {
+        std::string word = h.aliasManager.formatAlias(Alias{name, command, {}, true, {}, {}});
+        word.erase(0, 6);  // Drop "alias "
+        return word;
+    };
+    
+    // Turn the final state of each name into edits of its definitions
+    bool tailDeleted = false;  // A statement ending at EOF was deleted
+    for (size_t i = 0; i < index.size(); ++i) {
+        const IndexedDefinition& def = index[i];
+        const Entry& entry = entries[owner[i]];
+        
+        if (entry.removed) {
+            // Does the statement keep any definition? (its definitions are adjacent)
+            bool sole = true;
+            for (size_t j = i; sole && j > 0 &&
+                 index[j - 1].statementOffset == def.statementOffset; --j) {
+                sole = entries[owner[j - 1]].removed;
+            }
+            for (size_t j = i + 1; sole && j < index.size() &&
+                 index[j].statementOffset == def.statementOffset; ++j) {
+                sole = entries[owner[j]].removed;
             }
+            
+            if (!sole) {
+                edits.push_back({def.cutOffset, def.cutEnd - def.cutOffset, {}});
+            } else if (edits.empty() || edits.back().offset != def.statementOffset) {
+                edits.push_back({def.statementOffset, def.statementEnd - def.statementOffset, {}});
+                tailDeleted |= def.statementEnd == fileSize;
+            }
+        } else if (entry.changed && i == entry.last) {
+            edits.push_back({def.offset, def.length, definition(entry.name, entry.command)});
+        } else if (entry.name != entry.fileName) {
+            edits.push_back({def.offset, entry.fileName.size(), entry.name});
         }
-        newLines.push_back(std::move(line));  // Keep this line
     }
     
-    // If alias wasn't found, report error
-    if (!found) {
-        lastError = "Alias not found: " + aliasName;
+    // New aliases go to the end of the file, on a line of their own
+    std::string appended;
+    for (const Entry& entry : entries) {
+        if (entry.fileName.empty() && !entry.removed) {
+            appended += h.aliasManager.formatAlias(Alias{entry.name, entry.command, {}, true, {}, {}});
+            appended += '\n';
+        }
+    }
+    if (!appended.empty()) {
+        if (fileSize > 0 && !tailDeleted && content.back() != '\n') {
+            appended.insert(appended.begin(), '\n');
+        }
+        edits.push_back({fileSize, 0, std::move(appended)});
+    }
+    
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Transaction: Merge Edits
+// Our operations are applied to the merge base and the result is merged
+// line by line with the file as it is now. Where both sides changed the
+// same lines, the aliases defined there decide: one that both sides set
+// differently is a conflict; otherwise the lines held neighbouring edits
+// (two appends, two aliases of one statement) and the operations are
+// replayed on the current file, which keeps both.
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::Transaction::mergeEdits(std::string_view current,
+                                                std::vector<FileEdit>& edits) const {
+    ConfigFileHandler& h = handler;
+    const std::string_view base = h.mergeBase;
+    
+    // Our changes, made to the base
+    std::vector<AliasDefinition> definitions;
+    h.tokenizeBuffer(base, definitions);
+    std::vector<FileEdit> ourEdits;
+    if (!planEdits(indexDefinitions(definitions), base, ourEdits) ||
+        !normalizeEdits(ourEdits, base.size(), h.lastError)) {
         return false;
     }
+    const std::string ours = spliceEdits(base, 0, ourEdits);
     
-    // Write filtered lines back to file
-    return writeAllLines(newLines);
+    LineMerge::Result merged = LineMerge::merge(base, current, ours);
+    bool replay = false;
+    for (const LineMerge::Conflict& conflict : merged.conflicts) {
+        conflictingAliases(h.shell, conflict, h.conflicts);
+        replay |= !conflict.base.empty();
+    }
+    if (!h.conflicts.empty()) {
+        std::sort(h.conflicts.begin(), h.conflicts.end());
+        h.conflicts.erase(std::unique(h.conflicts.begin(), h.conflicts.end()), h.conflicts.end());
+        h.lastError = "Changed on disk since it was loaded:";
+        for (const std::string& name : h.conflicts) {
+            h.lastError += (&name == &h.conflicts.front() ? " " : ", ") + name;
+        }
+        return false;
+    }
+    if (replay) {
+        return planEdits(h.definitionIndex, current, edits);
+    }
+    
+    // One edit covering the bytes the merge changed
+    const std::string_view text = merged.text;
+    size_t prefix = 0;
+    const size_t shorter = std::min(text.size(), current.size());
+    while (prefix < shorter && text[prefix] == current[prefix]) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < shorter - prefix &&
+           text[text.size() - 1 - suffix] == current[current.size() - 1 - suffix]) {
+        ++suffix;
+    }
+    if (prefix == text.size() && prefix == current.size()) {
+        return true;
+    }
+    edits.push_back({prefix, current.size() - prefix - suffix,
+                     std::string(text.substr(prefix, text.size() - prefix - suffix))});
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Transaction: One Commit Attempt
+// The edits are computed from the file as read (replayed on it, or merged
+// with the merge base) and only written if, under the lock, the file still
+// has the stamp and content hash it was read with. The file is opened and
+// stat once; the check under the lock is one stat of its name.
+// ------------------------------------------------------------------------------
+ConfigFileHandler::Transaction::Outcome
+ConfigFileHandler::Transaction::tryCommit(BackupManager* backup, FileLock& lock) {
+    ConfigFileHandler& h = handler;
+    
+    // Only additions may create the file
+    const bool adds = std::any_of(operations.begin(), operations.end(),
+                                  [](const Operation& op) { return op.kind == OpKind::Add; });
+    int fd = h.openConfig(O_RDWR, adds);
+    if (fd < 0) {
+        h.lastError = errno == ENOENT ? "Config file does not exist" : "Failed to read config file";
+        return Outcome::Failed;
+    }
+    MappedFile file;
+    if (!h.refreshIndex(fd) || !file.openRegular(fd, static_cast<size_t>(h.indexStamp.size))) {
+        h.lastError = "Failed to read config file";
+        close(fd);
+        return Outcome::Failed;
+    }
+    const FileStamp base = h.indexStamp;
+    const std::string_view content = file.view();
+    const uint64_t baseHash = hash::bytes(content);
+    
+    std::vector<FileEdit> edits;
+    const bool merging = h.hasMergeBase && h.mergeBase != content;
+    if (!(merging ? mergeEdits(content, edits) : planEdits(h.definitionIndex, content, edits))) {
+        close(fd);
+        return Outcome::Failed;
+    }
+    
+    // Edits that put back the bytes already there (an update to the current
+    // value, an add of an identical definition) change nothing
+    edits.erase(std::remove_if(edits.begin(), edits.end(),
+                               [content](const FileEdit& edit) {
+                                   return edit.offset <= content.size() &&
+                                          edit.length <= content.size() - edit.offset &&
+                                          content.compare(edit.offset, edit.length,
+                                                          edit.replacement) == 0;
+                               }),
+                edits.end());
+    
+    // Operations that cancel out, or change nothing, leave nothing to write
+    // and nothing to back up
+    if (edits.empty()) {
+        if (h.hasMergeBase) {
+            h.mergeBase.assign(content);
+        }
+        close(fd);
+        operations.clear();
+        return Outcome::Written;
+    }
+    
+    // Write only over the version that was read: same inode at the path,
+    // same stamp, same bytes
+    if (!lock.lock(h.configFilePath)) {
+        h.lastError = lock.getLastError();
+        close(fd);
+        return Outcome::Failed;
+    }
+    struct stat sb;
+    uint64_t currentHash = 0;
+    if (syscalls::fstatat(h.dirFd, h.fileName.c_str(), &sb, 0) != 0 ||
+        !(toStamp(sb) == base) ||
+        !contentHash(fd, base.size, currentHash) || currentHash != baseHash) {
+        close(fd);
+        return Outcome::Conflict;
+    }
+    
+    // What the file will hold becomes the next merge base
+    std::string written;
+    if (h.hasMergeBase && normalizeEdits(edits, content.size(), h.lastError)) {
+        written = spliceEdits(content, 0, edits);
+    }
+    
+    // The backup object and the new file share one commit
+    SyncGroup group;
+    if (backup != nullptr && backup->createBackup(&group).empty()) {
+        h.lastError = "Failed to create backup: " + backup->getLastError();
+        close(fd);
+        return Outcome::Failed;
+    }
+    
+    bool ok = h.writeEdits(fd, content.size(), edits, &group);
+    close(fd);
+    if (!ok) {
+        return Outcome::Failed;
+    }
+    if (h.hasMergeBase) {
+        h.mergeBase = std::move(written);
+    }
+    operations.clear();
+    return Outcome::Written;
 }
 
 // ------------------------------------------------------------------------------
@@ -154,13 +1245,13 @@ std::string ConfigFileHandler::getConfigFilePath() const {
     switch (shell) {
         case ShellDetector::Shell::BASH:
             return ShellDetector::expandHome("~/.bashrc");
-            
+        
         case ShellDetector::Shell::ZSH:
             return ShellDetector::expandHome("~/.zshrc");
-            
+        
         case ShellDetector::Shell::FISH:
             return ShellDetector::expandHome("~/.config/fish/config.fish");
-            
+        
         default:
             return configFilePath;  // Return explicitly set path
     }
@@ -170,23 +1261,28 @@ std::string ConfigFileHandler::getConfigFilePath() const {
 // Check if Configuration File Exists
 // ------------------------------------------------------------------------------
 bool ConfigFileHandler::configFileExists() const {
-    return fs::exists(configFilePath);
+    struct stat sb;
+    return openDirectory() && syscalls::fstatat(dirFd, fileName.c_str(), &sb, 0) == 0;
 }
 
 // ------------------------------------------------------------------------------
 // Read All Lines from Configuration File
 // ------------------------------------------------------------------------------
 std::vector<std::string> ConfigFileHandler::readAllLines() {
+    syscalls::Tally tally(lastSyscalls);
     std::vector<std::string> lines;
     
-    std::ifstream file(configFilePath);
-    if (!file.is_open()) {
+    int fd = openConfig(O_RDONLY, false);
+    MappedFile file;
+    const bool opened = fd >= 0 && file.open(fd);
+    if (fd >= 0) close(fd);
+    if (!opened) {
         return lines;  // Return empty vector
     }
     
-    std::string line;
-    while (std::getline(file, line)) {
-        lines.push_back(std::move(line));
+    lines.reserve(file.lineCount());
+    for (size_t i = 0; i < file.lineCount(); ++i) {
+        lines.emplace_back(file.line(i));
     }
     
     return lines;
@@ -197,22 +1293,62 @@ std::vector<std::string> ConfigFileHandler::readAllLines() {
 // Replaces entire file content
 // ------------------------------------------------------------------------------
 bool ConfigFileHandler::writeAllLines(const std::vector<std::string>& lines) {
-    std::ofstream file(configFilePath, std::ios::trunc);
-    if (!file.is_open()) {
-        lastError = "Cannot open file for writing";
-        return false;
+    std::vector<std::string_view> views(lines.begin(), lines.end());
+    return writeAllLines(views);
+}
+
+// ------------------------------------------------------------------------------
+// Write All Line Views to Configuration File
+// The content is joined into one buffer before the file is opened, so the
+// views may point into a mapping of the file being replaced
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::writeAllLines(std::span<const std::string_view> lines) {
+    syscalls::Tally tally(lastSyscalls);
+    size_t total = 0;
+    for (std::string_view line : lines) {
+        total += line.size() + 1;
     }
     
-    // Write all lines, adding newline between them
+    // Join lines with newlines (no newline after the last line)
+    std::string content;
+    content.reserve(total);
     for (size_t i = 0; i < lines.size(); ++i) {
-        file << lines[i];
+        content.append(lines[i]);
         if (i < lines.size() - 1) {
-            file << '\n';  // No newline after last line
+            content += '\n';
         }
     }
     
-    // Ensure proper file permissions
-    setFilePermissions();
+    if (!writerLock.lock(configFilePath)) {
+        lastError = writerLock.getLastError();
+        return false;
+    }
+    LockRelease release{writerLock};
+    
+    if (writeMode == WriteMode::Atomic) {
+        // Replace the file as a whole; it is never seen half written
+        if (!openDirectory()) {
+            lastError = "Cannot open directory of " + configFilePath;
+            return false;
+        }
+        AtomicWriter writer(dirFd, fileName);
+        if (!writer.open() || !writer.write(content) || !writer.commit()) {
+            lastError = "Cannot write config file: " + writer.getLastError();
+            return false;
+        }
+    } else {
+        int fd = openConfig(O_WRONLY | O_TRUNC, true);
+        if (fd < 0) {
+            lastError = "Cannot open file for writing";
+            return false;
+        }
+        const bool ok = pwriteAll(fd, content.data(), content.size(), 0);
+        close(fd);
+        if (!ok) {
+            lastError = "Cannot write config file";
+            return false;
+        }
+    }
     
     return true;
 }
@@ -225,7 +1361,7 @@ bool ConfigFileHandler::checkPermissions() const {
     struct stat sb;
     
     // Get file status
-    if (stat(configFilePath.c_str(), &sb) != 0) {
+    if (!openDirectory() || syscalls::fstatat(dirFd, fileName.c_str(), &sb, 0) != 0) {
         return false;  // Can't stat file
     }
     
@@ -244,37 +1380,73 @@ std::string ConfigFileHandler::getLastError() const {
 }
 
 // ------------------------------------------------------------------------------
-// Ensure File Exists
-// Creates the file if it doesn't exist
+// Get Last Syscall Count
 // ------------------------------------------------------------------------------
-bool ConfigFileHandler::ensureFileExists() {
-    if (fs::exists(configFilePath)) {
-        return true;  // File already exists
+uint64_t ConfigFileHandler::getLastSyscallCount() const {
+    return lastSyscalls;
+}
+
+// ------------------------------------------------------------------------------
+// Open the Configuration Directory
+// The path is resolved once; later calls reuse the descriptor, so every
+// file access is one call relative to it
+// ------------------------------------------------------------------------------
+bool ConfigFileHandler::openDirectory() const {
+    if (dirFd >= 0) {
+        return true;
     }
     
-    // Create empty file
-    std::ofstream file(configFilePath);
-    if (!file.is_open()) {
-        return false;  // Failed to create file
+    std::error_code ec;
+    fs::path resolved = fs::weakly_canonical(configFilePath, ec);
+    if (ec) {
+        resolved = configFilePath;
     }
+    fs::path dir = resolved.parent_path();
+    if (dir.empty()) dir = ".";
     
-    // Set appropriate permissions
-    setFilePermissions();
-    
+    dirFd = syscalls::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        return false;
+    }
+    fileName = resolved.filename().string();
     return true;
 }
 
+// ------------------------------------------------------------------------------
+// Open the Configuration File
+// An existing file costs one call; a missing one is created exclusively
+// (never truncating one another writer just created)
+// ------------------------------------------------------------------------------
+int ConfigFileHandler::openConfig(int flags, bool create) {
+    if (!openDirectory()) {
+        return -1;
+    }
+    int fd = syscalls::openat(dirFd, fileName.c_str(), flags | O_CLOEXEC);
+    if (fd >= 0 || errno != ENOENT || !create) {
+        return fd;
+    }
+    
+    fd = syscalls::openat(dirFd, fileName.c_str(), flags | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        return syscalls::openat(dirFd, fileName.c_str(), flags | O_CLOEXEC);
+    }
+    if (fd >= 0) {
+        // Set appropriate permissions
+        setFilePermissions(fd);
+    }
+    return fd;
+}
+
 // ------------------------------------------------------------------------------
 // Set File Permissions
-// Sets permissions to: owner read/write, group read, others read
-// (Unix permissions: 644 or rw-r--r--)
+// Sets read/write for owner, read-only for group and others
 // ------------------------------------------------------------------------------
-bool ConfigFileHandler::setFilePermissions() {
+bool ConfigFileHandler::setFilePermissions(int fd) {
     // Set permissions: owner can read/write, group/others can only read
-    int result = chmod(configFilePath.c_str(), 
-                      S_IRUSR | S_IWUSR |   // User read/write
-                      S_IRGRP |             // Group read
-                      S_IROTH);             // Others read
+    int result = syscalls::fchmod(fd,
+                                  S_IRUSR | S_IWUSR |   // User read/write
+                                  S_IRGRP |             // Group read
+                                  S_IROTH);             // Others read
     
     return result == 0;  // Return true if chmod succeeded
 }
\ No newline at end of file
@@ -7,17 +7,41 @@
 // configuration files (like .bashrc, .zshrc, config.fish). It provides
 // comprehensive operations for loading, adding, removing, and managing
 // aliases within these configuration files with proper shell-specific
-// syntax handling.
+// syntax handling. The file's directory and writer lock are opened once
+// and kept, and files are addressed relative to the directory descriptor,
+// so an edit makes a small, fixed number of metadata calls whatever the
+// file's size (see getLastSyscallCount).
 // ------------------------------------------------------------------------------
 
 #ifndef CONFIGFILEHANDLER_HPP
 #define CONFIGFILEHANDLER_HPP
 
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
+#include <sys/stat.h>
 #include <vector>
 #include "aliasmanager.hpp"
+#include "aliascache.hpp"
+#include "aliastable.hpp"
+#include "aliastokenizer.hpp"
+#include "filelock.hpp"
 #include "shelldetector.hpp"
 
+class BackupManager;
+class SyncGroup;
+
+// ------------------------------------------------------------------------------
+// Structure: FileEdit
+// Purpose: Replace length bytes at offset with replacement (empty = delete).
+// ------------------------------------------------------------------------------
+struct FileEdit {
+    size_t offset = 0;          // Byte offset in the current file
+    size_t length = 0;          // Bytes to replace
+    std::string replacement;    // New bytes
+};
+
 class ConfigFileHandler {
 public:
     // --------------------------------------------------------------------------
@@ -27,6 +51,12 @@ public:
     // Initialize with specific configuration file path and shell type
     ConfigFileHandler(const std::string& configFilePath, ShellDetector::Shell shell);
     
+    // Closes the held directory and lock file
+    ~ConfigFileHandler();
+    
+    ConfigFileHandler(const ConfigFileHandler&) = delete;
+    ConfigFileHandler& operator=(const ConfigFileHandler&) = delete;
+    
     // --------------------------------------------------------------------------
     // Alias Management
     // --------------------------------------------------------------------------
@@ -35,6 +65,26 @@ public:
     // Returns: Vector of Alias objects found in the file
     std::vector<Alias> loadAliases();
     
+    // Load all aliases into an arena-backed table (no per-alias allocation)
+    // Files above the parallel threshold are parsed in chunks on a thread pool
+    // Returns: Table of every definition in file order
+    AliasTable loadAliasTable();
+    
+    // Same, also returning the bytes the table was parsed from and the
+    // location of each row's definition (the basis for AliasReloader)
+    AliasTable loadAliasTable(std::string& content, std::vector<CachedDefinition>& locations);
+    
+    // Set the file size from which loading is split across threads
+    // (default kDefaultParallelThreshold; 0 disables chunked parsing)
+    void setParallelThreshold(size_t bytes);
+    
+    // Default size above which files are parsed in parallel (1 MiB)
+    static constexpr size_t kDefaultParallelThreshold = size_t(1) << 20;
+    
+    // Enable or disable the persistent parse cache (see AliasCache; on by
+    // default). An unchanged file is then loaded without being parsed.
+    void setCacheEnabled(bool enabled);
+    
     // Add a new alias to the configuration file
     // Returns: true if alias was successfully added
     bool addAlias(const Alias& alias);
@@ -43,6 +93,39 @@ public:
     // Returns: true if alias was found and removed
     bool removeAlias(const std::string& aliasName);
     
+    // Replace the command of an existing alias in place: its last definition
+    // is rewritten where it stands, keeping flags and all other bytes
+    // Returns: true if alias was found and updated
+    bool updateAlias(const std::string& aliasName, const std::string& newCommand);
+    
+    // Rename every definition of an alias in place (only the name bytes change)
+    // Returns: true if alias was found and the new name was not taken
+    bool renameAlias(const std::string& oldName, const std::string& newName);
+    
+    // --------------------------------------------------------------------------
+    // Batch Editing
+    // --------------------------------------------------------------------------
+    
+    class Transaction;
+    
+    // Start a batch of alias changes that is written in a single pass
+    // Returns: Empty transaction bound to this handler
+    Transaction beginTransaction();
+    
+    // Treat later commits as edits of content (the file as the user last
+    // saw it). If the file has changed since, the edits are three-way merged
+    // with those changes instead of simply replayed on the new file, and a
+    // commit fails if both sides changed the same alias (see getConflicts).
+    // After each successful commit the written content becomes the base.
+    void setMergeBase(std::string content);
+    
+    // Go back to replaying edits on the current file
+    void clearMergeBase();
+    
+    // Aliases the last commit failed on because they were also changed on
+    // disk since the merge base (sorted; empty after any other outcome)
+    const std::vector<std::string>& getConflicts() const;
+    
     // --------------------------------------------------------------------------
     // File Operations
     // --------------------------------------------------------------------------
@@ -63,6 +146,24 @@ public:
     // Returns: true if write was successful
     bool writeAllLines(const std::vector<std::string>& lines);
     
+    // Write line views (which may point into a mapping of this file)
+    bool writeAllLines(std::span<const std::string_view> lines);
+    
+    // Apply byte edits to the file, rebuilding only the part after the first
+    // edited offset (see WriteMode). Offsets refer to the file as last
+    // loaded or indexed; fails if it has changed on disk since.
+    // Returns: true if the edits were written
+    bool applyEdits(std::vector<FileEdit> edits);
+    
+    // How rewrites reach the disk
+    enum class WriteMode {
+        Atomic,   // New file fsynced and renamed over the old one (default)
+        InPlace   // Live file patched with pwrite + ftruncate (fastest, not crash-safe)
+    };
+    
+    // Select how rewrites are written
+    void setWriteMode(WriteMode mode);
+    
     // --------------------------------------------------------------------------
     // File Permissions and Error Handling
     // --------------------------------------------------------------------------
@@ -74,18 +175,96 @@ public:
     // Get the last error message for debugging
     std::string getLastError() const;
     
+    // Filesystem metadata calls (open, stat, chmod, lock, link, rename,
+    // xattr; see syscalls.hpp) made by the last load, edit, commit or
+    // whole-file read or write. Calls made by a BackupManager are not included
+    uint64_t getLastSyscallCount() const;
+
 private:
     // --------------------------------------------------------------------------
     // Private Methods
     // --------------------------------------------------------------------------
     
-    // Ensure the configuration file exists, create if it doesn't
-    // Returns: true if file exists or was created successfully
-    bool ensureFileExists();
+    // Open the directory holding the configuration file (symlinks are
+    // resolved once) unless it is already open
+    // Returns: true if dirFd and fileName are set
+    bool openDirectory() const;
+    
+    // Open the configuration file relative to dirFd with flags (O_CLOEXEC is
+    // added). With create, a missing file is created with mode 0644
+    // Returns: the descriptor, or -1 with errno set
+    int openConfig(int flags, bool create);
     
-    // Set appropriate file permissions (read/write for owner)
+    // Set appropriate file permissions on a new file (read/write for owner)
     // Returns: true if permissions were set successfully
-    bool setFilePermissions();
+    bool setFilePermissions(int fd);
+    
+    // Shared body of the loadAliasTable overloads (outputs may be null)
+    AliasTable loadTable(std::string* content, std::vector<CachedDefinition>* locations);
+    
+    // Tokenize every alias definition in text, in file order
+    // Splits text into chunks parsed in parallel when it is large enough
+    void tokenizeBuffer(std::string_view text, std::vector<AliasDefinition>& out) const;
+    
+    // --------------------------------------------------------------------------
+    // Definition Index
+    // --------------------------------------------------------------------------
+    
+    // Identity of the file content an index was built from
+    struct FileStamp {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        int64_t ctimeNs = 0;
+        bool operator==(const FileStamp&) const = default;
+    };
+    
+    // Byte location of one alias definition
+    struct IndexedDefinition {
+        std::string name;              // Alias name
+        size_t offset = 0;             // Start of name=value
+        size_t length = 0;             // Length of name=value
+        size_t statementOffset = 0;    // Start of the statement's first line
+        size_t statementEnd = 0;       // Just past the statement
+        size_t cutOffset = 0;          // Range removing only this definition
+        size_t cutEnd = 0;             // from a multi-definition statement
+    };
+    
+    // Stamp of stat results
+    static FileStamp toStamp(const struct stat& sb);
+    
+    // Read the stamp of an open file
+    static bool readStamp(int fd, FileStamp& stamp);
+    
+    // Index entries (with cut ranges) for tokenized definitions
+    static std::vector<IndexedDefinition> indexDefinitions(
+        const std::vector<AliasDefinition>& definitions);
+    
+    // Replace the index with the definitions found in definitions
+    void setIndex(const std::vector<AliasDefinition>& definitions, const FileStamp& stamp);
+    
+    // Replace the index with cached locations of the rows of table
+    void setIndex(const AliasTable& table, const std::vector<CachedDefinition>& definitions,
+                  const FileStamp& stamp);
+    
+    // Make the index match the file behind fd, re-parsing only if needed
+    bool refreshIndex(int fd);
+    
+    // Sort edits and merge overlapping deletions (fails on other overlaps
+    // and on edits past fileSize)
+    static bool normalizeEdits(std::vector<FileEdit>& edits, uint64_t fileSize,
+                               std::string& error);
+    
+    // Apply normalized edits to text, which starts at file offset origin
+    static std::string spliceEdits(std::string_view text, uint64_t origin,
+                                   const std::vector<FileEdit>& edits);
+    
+    // Write edits through fd (file of fileSize bytes) and update the index.
+    // Writes pending in group are committed first (in-place mode) or
+    // together with the new file (atomic mode)
+    bool writeEdits(int fd, uint64_t fileSize, std::vector<FileEdit>& edits,
+                    SyncGroup* group = nullptr);
     
     // --------------------------------------------------------------------------
     // Member Variables
@@ -95,6 +274,90 @@ private:
     ShellDetector::Shell shell;     // Shell type for syntax handling
     std::string lastError;          // Last error message
     AliasManager aliasManager;      // Alias formatter/parser for this shell
+    size_t parallelThreshold = kDefaultParallelThreshold;  // Chunked parse limit
+    std::vector<IndexedDefinition> definitionIndex;  // Definitions by byte offset
+    FileStamp indexStamp;           // File state the index describes
+    bool indexValid = false;        // Index matches indexStamp
+    WriteMode writeMode = WriteMode::Atomic;  // Rewrite strategy
+    bool cacheEnabled = true;       // Use the persistent parse cache
+    std::string mergeBase;          // Content commits are three-way merged from
+    bool hasMergeBase = false;      // mergeBase is set
+    std::vector<std::string> conflicts;  // Aliases the last commit conflicted on
+    mutable int dirFd = -1;         // Directory of the resolved file, or -1
+    mutable std::string fileName;   // Name of the resolved file in dirFd
+    FileLock writerLock;            // Writer lock (lock file kept open)
+    uint64_t lastSyscalls = 0;      // Metadata calls of the last operation
+};
+
+// ------------------------------------------------------------------------------
+// Class: ConfigFileHandler::Transaction
+// Purpose: Queues alias changes and applies them in one read-modify-write
+// pass. The file is indexed once, every change becomes a byte edit, and the
+// result is written once (one backup, one atomic rename). Operations take
+// effect in the order they were queued, so each sees the names left by the
+// ones before it. Concurrent writers (other instances, scripts using the
+// FileLock file) are handled optimistically: if the file changed between
+// reading and writing, the whole pass is redone on the new content. With a
+// merge base set, changes made since the base are merged, not replayed over.
+// ------------------------------------------------------------------------------
+class ConfigFileHandler::Transaction {
+public:
+    explicit Transaction(ConfigFileHandler& handler);
+    
+    // Define an alias (an existing alias of that name is updated instead)
+    void add(const Alias& alias);
+    
+    // Replace the command of an existing alias (its last definition)
+    void update(const std::string& name, const std::string& command);
+    
+    // Remove every definition of an alias
+    void remove(const std::string& name);
+    
+    // Rename every definition of an alias, keeping flags and command
+    void rename(const std::string& oldName, const std::string& newName);
+    
+    // Number of queued operations
+    size_t size() const;
+    bool empty() const;
+    
+    // Drop all queued operations
+    void clear();
+    
+    // Apply the queued operations. Nothing is written if any of them is
+    // invalid or names a missing alias; otherwise backup (if given) is taken
+    // once and the edits are written together, under the writer lock and
+    // only over the version they were computed from (retried if another
+    // writer got in first). The queue is cleared on success.
+    // Returns: true if the file was updated (or there was nothing to change);
+    // on failure the reason is in the handler's getLastError()
+    bool commit(BackupManager* backup = nullptr);
+
+private:
+    enum class OpKind { Add, Update, Remove, Rename };
+    
+    // Result of one commit attempt
+    enum class Outcome { Written, Failed, Conflict };
+    
+    struct Operation {
+        OpKind kind;
+        std::string name;     // Alias the operation applies to
+        std::string value;    // New command (Add/Update) or new name (Rename)
+    };
+    
+    // Replay the operations on content (indexed by index) as byte edits
+    // Returns: false if an operation names a missing or taken alias
+    bool planEdits(const std::vector<IndexedDefinition>& index, std::string_view content,
+                   std::vector<FileEdit>& edits) const;
+    
+    // Edits of current that merge our changes to the merge base into it
+    // Returns: false on conflicting changes (listed in getConflicts)
+    bool mergeEdits(std::string_view current, std::vector<FileEdit>& edits) const;
+    
+    // Read, edit and (if the file is unchanged under lock) write once
+    Outcome tryCommit(BackupManager* backup, FileLock& lock);
+    
+    ConfigFileHandler& handler;         // File being edited
+    std::vector<Operation> operations;  // Queued operations in order
 };
 
 #endif // CONFIGFILEHANDLER_HPP
\ No newline at end of file
@@ -0,0 +1,126 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: File Lock Component Implementation
+//
+// This file implements the FileLock class. flock(2) locks belong to the
+// open file description, so two handlers in the same process exclude each
+// other just like two processes do, and the kernel drops the lock when the
+// descriptor is closed, including when the holder crashes.
+// ------------------------------------------------------------------------------
+
+#include "filelock.hpp"
+#include "aliascache.hpp"  // Fallback lock directory
+#include "hash.hpp"        // Lock file names
+#include <cerrno>          // For errno
+#include <cstdio>          // For std::snprintf
+#include <cstdlib>         // For std::getenv
+#include <cstring>         // For std::strerror
+#include <fcntl.h>         // For O_* flags
+#include <filesystem>      // Symlink resolution
+#include "syscalls.hpp"    // Counted open, flock
+#include <system_error>    // For std::error_code
+#include <unistd.h>        // For close
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------------
+FileLock::~FileLock() {
+    unlock();
+    if (lockFd >= 0) {
+        close(lockFd);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Lock File Path
+// The runtime directory is cleared at logout, which is all a lock file
+// needs; the hash keeps files of the same name in different places apart
+// ------------------------------------------------------------------------------
+std::string FileLock::lockPathFor(const std::string& targetPath) {
+    std::error_code ec;
+    fs::path resolved = fs::weakly_canonical(targetPath, ec);
+    if (ec) {
+        resolved = fs::absolute(targetPath, ec);
+        if (ec) {
+            resolved = targetPath;
+        }
+    }
+    
+    std::string dir;
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+        runtime != nullptr && runtime[0] == '/') {
+        dir = (fs::path(runtime) / "aliacan").string();
+    } else {
+        dir = AliasCache::cacheDirectory();
+    }
+    if (dir.empty()) {
+        return resolved.string() + ".lock";
+    }
+    
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), "-%016llx.lock",
+                  static_cast<unsigned long long>(hash::bytes(resolved.string())));
+    return (fs::path(dir) / (resolved.filename().string() + suffix)).string();
+}
+
+// ------------------------------------------------------------------------------
+// Acquire the Lock
+// ------------------------------------------------------------------------------
+bool FileLock::lock(const std::string& targetPath) {
+    if (isLocked()) {
+        return true;
+    }
+    
+    // Another target: drop the lock file of the previous one
+    if (lockFd >= 0 && targetPath != lockTarget) {
+        close(lockFd);
+        lockFd = -1;
+    }
+    
+    if (lockFd < 0) {
+        const std::string path = lockPathFor(targetPath);
+        int fd = syscalls::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0 && errno == ENOENT) {
+            // First lock of the session: create the directory
+            std::error_code ec;
+            fs::create_directories(fs::path(path).parent_path(), ec);
+            fd = syscalls::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        }
+        if (fd < 0) {
+            // Someone else's lock file: reading is enough for flock
+            fd = syscalls::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        if (fd < 0) {
+            lastError = "Cannot open lock file " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        lockFd = fd;
+        lockTarget = targetPath;
+        lockPath = path;
+    }
+    
+    while (syscalls::flock(lockFd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            lastError = "Cannot lock " + lockPath + ": " + std::strerror(errno);
+            return false;
+        }
+    }
+    
+    locked = true;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Release the Lock
+// ------------------------------------------------------------------------------
+void FileLock::unlock() {
+    if (!locked) {
+        return;
+    }
+    syscalls::flock(lockFd, LOCK_UN);
+    locked = false;
+}
@@ -0,0 +1,70 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: File Lock Component Header
+//
+// This header defines the FileLock class, an exclusive advisory lock that
+// serialises writers of a configuration file. The lock is taken with
+// flock(2) on a separate lock file rather than on the file itself, because
+// atomic writes replace the file's inode and a lock on the old inode would
+// no longer protect anything. Lock files live in $XDG_RUNTIME_DIR/aliacan
+// (or the parse cache directory), not next to the user's rc file; other
+// tools can join in through the path lockPathFor reports. The lock file
+// stays open between lock and unlock calls, so relocking the same target
+// costs one flock call.
+// ------------------------------------------------------------------------------
+
+#ifndef FILELOCK_HPP
+#define FILELOCK_HPP
+
+#include <string>
+
+class FileLock {
+public:
+    // --------------------------------------------------------------------------
+    // Constructor & Destructor
+    // --------------------------------------------------------------------------
+    
+    FileLock() = default;
+    
+    // Releases the lock if it is held and closes the lock file
+    ~FileLock();
+    
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    
+    // --------------------------------------------------------------------------
+    // Locking
+    // --------------------------------------------------------------------------
+    
+    // Lock file guarding targetPath: <file name>-<hash of the resolved
+    // path>.lock in $XDG_RUNTIME_DIR/aliacan, else in the parse cache
+    // directory, else next to the file. Symlinks are resolved first, so
+    // every name of the file shares one lock
+    static std::string lockPathFor(const std::string& targetPath);
+    
+    // Block until the exclusive lock on targetPath is held. The lock file
+    // (and its directory) is created if needed and left in place afterwards (removing it would
+    // let two writers lock different inodes). A lock file still open from
+    // an earlier lock of the same targetPath is reused
+    // Returns: true if the lock is held
+    bool lock(const std::string& targetPath);
+    
+    // Release the lock (no effect if it is not held); the lock file stays open
+    void unlock();
+    
+    // Check whether the lock is held
+    bool isLocked() const { return locked; }
+    
+    // Get the last error message for debugging
+    std::string getLastError() const { return lastError; }
+
+private:
+    int lockFd = -1;            // Open lock file, or -1
+    std::string lockTarget;     // targetPath lockFd was opened for
+    std::string lockPath;       // Lock file behind lockFd
+    bool locked = false;        // lockFd holds the lock
+    std::string lastError;      // Last error message
+};
+
+#endif // FILELOCK_HPP
@@ -0,0 +1,166 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: File Watcher Component Implementation
+//
+// This file implements the FileWatcher class. The thread blocks in poll()
+// on the inotify descriptor and an eventfd used to stop it. Events for
+// other names in the directory are dropped; events for the watched file
+// only move the debounce deadline, so an editor's write-rename-chmod burst
+// produces a single callback.
+// ------------------------------------------------------------------------------
+
+#include "filewatcher.hpp"
+#include <algorithm>          // For std::min
+#include <cerrno>             // For errno
+#include <cstdint>            // For uint64_t
+#include <filesystem>         // Path resolution
+#include <system_error>       // For std::error_code
+#include <poll.h>             // For poll
+#include <sys/eventfd.h>      // For eventfd
+#include <sys/inotify.h>      // For inotify_init1, inotify_add_watch
+#include <unistd.h>           // For read, write, close
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// Directory events that can change the watched file's content
+static constexpr uint32_t kWatchMask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                                       IN_MOVED_TO | IN_MOVED_FROM;
+
+// ------------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------------
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+// ------------------------------------------------------------------------------
+// Start Watching
+// ------------------------------------------------------------------------------
+bool FileWatcher::start(const std::string& path, Callback handler,
+                        std::chrono::milliseconds quiet) {
+    if (isRunning()) {
+        lastError = "Watcher already running";
+        return false;
+    }
+    
+    // Watch the directory of the real file
+    std::error_code ec;
+    fs::path target = fs::weakly_canonical(path, ec);
+    if (ec) {
+        target = path;
+    }
+    fileName = target.filename().string();
+    const fs::path directory = target.has_parent_path() ? target.parent_path() : fs::path(".");
+    
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        lastError = "Cannot create inotify instance";
+        return false;
+    }
+    if (inotify_add_watch(inotifyFd, directory.c_str(), kWatchMask) < 0) {
+        lastError = "Cannot watch directory: " + directory.string();
+        close(inotifyFd);
+        inotifyFd = -1;
+        return false;
+    }
+    
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        lastError = "Cannot create eventfd";
+        close(inotifyFd);
+        inotifyFd = -1;
+        return false;
+    }
+    
+    callback = std::move(handler);
+    debounce = quiet;
+    thread = std::thread(&FileWatcher::run, this);
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Stop Watching
+// ------------------------------------------------------------------------------
+void FileWatcher::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wakeFd, &one, sizeof(one));
+    thread.join();
+    
+    close(inotifyFd);
+    close(wakeFd);
+    inotifyFd = -1;
+    wakeFd = -1;
+}
+
+// ------------------------------------------------------------------------------
+// Watch Thread
+// The poll timeout is the time left until the pending burst is due: once
+// it has been quiet for debounce, or 10 x debounce after it began
+// ------------------------------------------------------------------------------
+void FileWatcher::run() {
+    using Clock = std::chrono::steady_clock;
+    
+    alignas(struct inotify_event) char buffer[4096];
+    bool pending = false;
+    Clock::time_point first;
+    Clock::time_point last;
+    
+    auto dueTime = [&] { return std::min(last + debounce, first + debounce * 10); };
+    
+    for (;;) {
+        int timeout = -1;
+        if (pending) {
+            const auto left = std::chrono::ceil<std::chrono::milliseconds>(dueTime() - Clock::now());
+            timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+        }
+        
+        struct pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        if (poll(fds, 2, timeout) < 0) {
+            if (errno == EINTR) continue;
+            lastError = "poll failed";
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;  // stop() was called
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            // Drain the queue, noting events for the watched name
+            ssize_t length;
+            while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    const auto* event = reinterpret_cast<const struct inotify_event*>(p);
+                    const bool relevant = (event->mask & IN_Q_OVERFLOW) ||
+                                          (event->len > 0 && fileName == event->name);
+                    if (relevant) {
+                        const Clock::time_point now = Clock::now();
+                        if (!pending) {
+                            pending = true;
+                            first = now;
+                        }
+                        last = now;
+                    }
+                    p += sizeof(struct inotify_event) + event->len;
+                }
+            }
+        }
+        
+        if (pending && Clock::now() >= dueTime()) {
+            pending = false;
+            callback();
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Get Last Error Message
+// ------------------------------------------------------------------------------
+std::string FileWatcher::getLastError() const {
+    return lastError;
+}
@@ -0,0 +1,73 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: File Watcher Component Header
+//
+// This header defines the FileWatcher class, which reports changes to one
+// file through inotify. The file's directory is watched rather than the file
+// itself, so editors and tools that replace the file by renaming a new copy
+// over it (vim, chezmoi, our own atomic writes) are still seen. Bursts of
+// events are coalesced: the callback runs once the file has been quiet for
+// the debounce interval, on the watcher's own thread.
+// ------------------------------------------------------------------------------
+
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+class FileWatcher {
+public:
+    // Called on the watcher thread after a burst of changes has settled
+    using Callback = std::function<void()>;
+    
+    // Default quiet time before the callback runs
+    static constexpr std::chrono::milliseconds kDefaultDebounce{100};
+    
+    // --------------------------------------------------------------------------
+    // Constructor & Destructor
+    // --------------------------------------------------------------------------
+    
+    FileWatcher() = default;
+    ~FileWatcher();
+    
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    
+    // --------------------------------------------------------------------------
+    // Watching
+    // --------------------------------------------------------------------------
+    
+    // Start watching path (symlinks are followed to the real file). The
+    // callback runs once no event has arrived for debounce, and at the
+    // latest 10 x debounce after the first event of a continuous burst.
+    // Returns: true if the watch thread was started
+    bool start(const std::string& path, Callback callback,
+               std::chrono::milliseconds debounce = kDefaultDebounce);
+    
+    // Stop watching and join the thread (no callback runs afterwards)
+    void stop();
+    
+    // Check whether the watch thread is running
+    bool isRunning() const { return thread.joinable(); }
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    // Thread body: wait for events, coalesce them, run the callback
+    void run();
+    
+    int inotifyFd = -1;             // inotify instance
+    int wakeFd = -1;                // eventfd used by stop()
+    std::string fileName;           // Name of the file inside the watched directory
+    Callback callback;              // Change handler
+    std::chrono::milliseconds debounce = kDefaultDebounce;  // Quiet time
+    std::thread thread;             // Watch thread
+    std::string lastError;          // Last error message
+};
+
+#endif // FILEWATCHER_HPP
@@ -0,0 +1,84 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Fast Byte Hash Header
+//
+// This header provides a small non-cryptographic 64-bit hash for byte
+// strings. It consumes 16 bytes per step with a 64x64->128 bit multiply and
+// handles short inputs with overlapping loads, so hashing an alias name is
+// a handful of instructions. It is used for hash tables and change
+// detection, never for security.
+// ------------------------------------------------------------------------------
+
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace hash {
+
+__extension__ typedef unsigned __int128 uint128;
+
+inline constexpr uint64_t kSecret0 = 0xa0761d6478bd642fULL;
+inline constexpr uint64_t kSecret1 = 0xe7037ed1a0b428dbULL;
+inline constexpr uint64_t kSecret2 = 0x8ebc6af09c88c6e3ULL;
+
+// Multiply and fold the 128-bit product into 64 bits
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    uint128 r = static_cast<uint128>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// ------------------------------------------------------------------------------
+// Hash a Byte Range
+// ------------------------------------------------------------------------------
+inline uint64_t bytes(const void* data, size_t len, uint64_t seed = 0) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed ^ kSecret0;
+    size_t n = len;
+    
+    // Full 16-byte steps, leaving 1..16 bytes for the tail
+    while (n > 16) {
+        h = mix(read64(p) ^ kSecret1, read64(p + 8) ^ h);
+        p += 16;
+        n -= 16;
+    }
+    
+    // Tail: two (possibly overlapping) loads
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (n >= 8) {
+        a = read64(p);
+        b = read64(p + n - 8);
+    } else if (n >= 4) {
+        a = read32(p);
+        b = read32(p + n - 4);
+    } else if (n > 0) {
+        a = (uint64_t(p[0]) << 16) | (uint64_t(p[n >> 1]) << 8) | p[n - 1];
+    }
+    
+    return mix(mix(a ^ kSecret1, b ^ h) ^ len, kSecret2);
+}
+
+inline uint64_t bytes(std::string_view text, uint64_t seed = 0) {
+    return bytes(text.data(), text.size(), seed);
+}
+
+} // namespace hash
+
+#endif // HASH_HPP
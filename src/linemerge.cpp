@@ -0,0 +1,342 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Line Merge Component Implementation
+//
+// This file implements the LineMerge class. The diff bisects each region at
+// the point where Myers' forward and backward searches meet and recurses on
+// both halves, which needs only two vectors of 2 x cost entries. The merge
+// walks the hunks of both sides in base order; hunks that touch the same
+// base lines form one region, taken from whichever side changed it or, if
+// both did and disagree, reported as a conflict.
+// ------------------------------------------------------------------------------
+
+#include "linemerge.hpp"
+#include "hash.hpp"     // Line hashes
+#include <algorithm>    // For std::count, std::min, std::max
+#include <cstdint>      // For uint64_t
+#include <cstring>      // For std::memchr
+
+// ------------------------------------------------------------------------------
+// Structure: LineIndex
+// Purpose: Line boundaries and hashes of one text.
+// ------------------------------------------------------------------------------
+struct LineIndex {
+    std::string_view text;
+    std::vector<size_t> starts;     // Start of each line, then text.size()
+    std::vector<uint64_t> hashes;   // Hash of each line (with its newline)
+    
+    size_t size() const { return hashes.size(); }
+    
+    std::string_view line(size_t i) const {
+        return text.substr(starts[i], starts[i + 1] - starts[i]);
+    }
+    
+    // Bytes of lines [begin, end)
+    std::string_view lines(size_t begin, size_t end) const {
+        return text.substr(starts[begin], starts[end] - starts[begin]);
+    }
+};
+
+// ------------------------------------------------------------------------------
+// Utility: Split Text into Lines
+// ------------------------------------------------------------------------------
+static LineIndex indexLines(std::string_view text) {
+    LineIndex index;
+    index.text = text;
+    const size_t count = static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1;
+    index.starts.reserve(count + 1);
+    index.hashes.reserve(count);
+    
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const void* newline = std::memchr(text.data() + pos, '\n', text.size() - pos);
+        const size_t end = newline != nullptr
+            ? static_cast<size_t>(static_cast<const char*>(newline) - text.data()) + 1
+            : text.size();
+        index.starts.push_back(pos);
+        index.hashes.push_back(hash::bytes(text.substr(pos, end - pos)));
+        pos = end;
+    }
+    index.starts.push_back(text.size());
+    return index;
+}
+
+// ------------------------------------------------------------------------------
+// Structure: DiffState
+// Purpose: Inputs, scratch vectors and output of one diff.
+// ------------------------------------------------------------------------------
+struct DiffState {
+    const LineIndex& a;
+    const LineIndex& b;
+    std::vector<ptrdiff_t> forward;     // Furthest x per diagonal, from the start
+    std::vector<ptrdiff_t> backward;    // Furthest x per diagonal, from the end
+    std::vector<LineMerge::Hunk> hunks;
+    
+    bool equal(size_t i, size_t j) const {
+        return a.hashes[i] == b.hashes[j] && a.line(i) == b.line(j);
+    }
+    
+    // Append a hunk, joining it to the previous one if they touch
+    void add(size_t a0, size_t a1, size_t b0, size_t b1) {
+        if (!hunks.empty() && hunks.back().baseEnd == a0 && hunks.back().otherEnd == b0) {
+            hunks.back().baseEnd = a1;
+            hunks.back().otherEnd = b1;
+        } else {
+            hunks.push_back({a0, a1, b0, b1});
+        }
+    }
+};
+
+// ------------------------------------------------------------------------------
+// Utility: Find the Bisection Point of a Region
+// Runs the forward and backward searches until they overlap and returns the
+// forward end point (relative to a0, b0). Returns false if the edit cost
+// exceeds LineMerge::kMaxCost.
+// ------------------------------------------------------------------------------
+static bool bisect(DiffState& s, size_t a0, size_t a1, size_t b0, size_t b1,
+                   ptrdiff_t& splitX, ptrdiff_t& splitY) {
+    const ptrdiff_t n = static_cast<ptrdiff_t>(a1 - a0);
+    const ptrdiff_t m = static_cast<ptrdiff_t>(b1 - b0);
+    const ptrdiff_t maxD = std::min<ptrdiff_t>((n + m + 1) / 2,
+                                               static_cast<ptrdiff_t>(LineMerge::kMaxCost));
+    const ptrdiff_t offset = maxD;
+    const ptrdiff_t length = 2 * maxD + 2;  // Diagonals -maxD .. maxD + 1
+    s.forward.assign(static_cast<size_t>(length), -1);
+    s.backward.assign(static_cast<size_t>(length), -1);
+    std::vector<ptrdiff_t>& v1 = s.forward;
+    std::vector<ptrdiff_t>& v2 = s.backward;
+    v1[static_cast<size_t>(offset + 1)] = 0;
+    v2[static_cast<size_t>(offset + 1)] = 0;
+    
+    const ptrdiff_t delta = n - m;
+    const bool front = (delta % 2) != 0;  // Overlap is detected by the forward pass
+    
+    // Diagonals that ran off the edit graph are skipped from then on
+    ptrdiff_t k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+    auto at = [](std::vector<ptrdiff_t>& v, ptrdiff_t i) -> ptrdiff_t& {
+        return v[static_cast<size_t>(i)];
+    };
+    
+    for (ptrdiff_t d = 0; d < maxD; ++d) {
+        for (ptrdiff_t k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+            const ptrdiff_t k1Offset = offset + k1;
+            ptrdiff_t x1 = (k1 == -d || (k1 != d && at(v1, k1Offset - 1) < at(v1, k1Offset + 1)))
+                ? at(v1, k1Offset + 1)
+                : at(v1, k1Offset - 1) + 1;
+            ptrdiff_t y1 = x1 - k1;
+            while (x1 < n && y1 < m &&
+                   s.equal(a0 + static_cast<size_t>(x1), b0 + static_cast<size_t>(y1))) {
+                ++x1;
+                ++y1;
+            }
+            at(v1, k1Offset) = x1;
+            if (x1 > n) {
+                k1end += 2;
+            } else if (y1 > m) {
+                k1start += 2;
+            } else if (front) {
+                const ptrdiff_t k2Offset = offset + delta - k1;
+                if (k2Offset >= 0 && k2Offset < length && at(v2, k2Offset) != -1 &&
+                    x1 >= n - at(v2, k2Offset)) {
+                    splitX = x1;
+                    splitY = y1;
+                    return true;
+                }
+            }
+        }
+        
+        for (ptrdiff_t k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+            const ptrdiff_t k2Offset = offset + k2;
+            ptrdiff_t x2 = (k2 == -d || (k2 != d && at(v2, k2Offset - 1) < at(v2, k2Offset + 1)))
+                ? at(v2, k2Offset + 1)
+                : at(v2, k2Offset - 1) + 1;
+            ptrdiff_t y2 = x2 - k2;
+            while (x2 < n && y2 < m &&
+                   s.equal(a1 - 1 - static_cast<size_t>(x2), b1 - 1 - static_cast<size_t>(y2))) {
+                ++x2;
+                ++y2;
+            }
+            at(v2, k2Offset) = x2;
+            if (x2 > n) {
+                k2end += 2;
+            } else if (y2 > m) {
+                k2start += 2;
+            } else if (!front) {
+                const ptrdiff_t k1Offset = offset + delta - k2;
+                if (k1Offset >= 0 && k1Offset < length && at(v1, k1Offset) != -1) {
+                    const ptrdiff_t x1 = at(v1, k1Offset);
+                    if (x1 >= n - x2) {
+                        splitX = x1;
+                        splitY = x1 - (k1Offset - offset);
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Diff Lines [a0, a1) Against [b0, b1)
+// ------------------------------------------------------------------------------
+static void diffRange(DiffState& s, size_t a0, size_t a1, size_t b0, size_t b1) {
+    // Equal lines at either end are not part of any hunk
+    while (a0 < a1 && b0 < b1 && s.equal(a0, b0)) {
+        ++a0;
+        ++b0;
+    }
+    while (a0 < a1 && b0 < b1 && s.equal(a1 - 1, b1 - 1)) {
+        --a1;
+        --b1;
+    }
+    if (a0 == a1 || b0 == b1) {
+        if (a0 != a1 || b0 != b1) {
+            s.add(a0, a1, b0, b1);
+        }
+        return;
+    }
+    
+    ptrdiff_t x = 0;
+    ptrdiff_t y = 0;
+    const bool found = bisect(s, a0, a1, b0, b1, x, y);
+    const size_t midA = a0 + static_cast<size_t>(x);
+    const size_t midB = b0 + static_cast<size_t>(y);
+    if (!found || (midA == a0 && midB == b0) || (midA == a1 && midB == b1)) {
+        // Too costly to refine (or no progress): replace the whole region
+        s.add(a0, a1, b0, b1);
+        return;
+    }
+    diffRange(s, a0, midA, b0, midB);
+    diffRange(s, midA, a1, midB, b1);
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Hunks of Two Indexed Texts
+// ------------------------------------------------------------------------------
+static std::vector<LineMerge::Hunk> diffIndexed(const LineIndex& a, const LineIndex& b) {
+    DiffState state{a, b, {}, {}, {}};
+    diffRange(state, 0, a.size(), 0, b.size());
+    return std::move(state.hunks);
+}
+
+// ------------------------------------------------------------------------------
+// Diff
+// ------------------------------------------------------------------------------
+std::vector<LineMerge::Hunk> LineMerge::diff(std::string_view base, std::string_view other) {
+    return diffIndexed(indexLines(base), indexLines(other));
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Text of a Base Region on One Side
+// hunks[first, last) are that side's hunks inside base lines [begin, end)
+// ------------------------------------------------------------------------------
+static std::string sideText(const LineIndex& base, const LineIndex& side,
+                            const std::vector<LineMerge::Hunk>& hunks,
+                            size_t first, size_t last, size_t begin, size_t end) {
+    std::string text;
+    size_t pos = begin;
+    for (size_t i = first; i < last; ++i) {
+        text.append(base.lines(pos, hunks[i].baseBegin));
+        text.append(side.lines(hunks[i].otherBegin, hunks[i].otherEnd));
+        pos = hunks[i].baseEnd;
+    }
+    text.append(base.lines(pos, end));
+    return text;
+}
+
+// ------------------------------------------------------------------------------
+// Merge
+// ------------------------------------------------------------------------------
+LineMerge::Result LineMerge::merge(std::string_view baseText, std::string_view theirsText,
+                                   std::string_view oursText) {
+    Result result;
+    
+    // Nothing to combine when one side kept the base
+    if (theirsText == baseText || theirsText == oursText) {
+        result.text.assign(oursText);
+        return result;
+    }
+    if (oursText == baseText) {
+        result.text.assign(theirsText);
+        return result;
+    }
+    
+    const LineIndex base = indexLines(baseText);
+    const LineIndex theirs = indexLines(theirsText);
+    const LineIndex ours = indexLines(oursText);
+    const std::vector<Hunk> t = diffIndexed(base, theirs);
+    const std::vector<Hunk> o = diffIndexed(base, ours);
+    result.text.reserve(std::max(theirsText.size(), oursText.size()));
+    
+    // Does a hunk touch the region [begin, end)? Insertions only touch what
+    // they are strictly inside of, or another insertion at the same line
+    auto touches = [](const Hunk& h, size_t begin, size_t end) {
+        if (h.baseBegin == h.baseEnd) {
+            return begin == end ? h.baseBegin == begin : h.baseBegin > begin && h.baseBegin < end;
+        }
+        if (begin == end) {
+            return begin > h.baseBegin && begin < h.baseEnd;
+        }
+        return h.baseBegin < end && begin < h.baseEnd;
+    };
+    // Order of hunks: by start, insertions before replacements at the same line
+    auto before = [](const Hunk& x, const Hunk& y) {
+        return x.baseBegin != y.baseBegin ? x.baseBegin < y.baseBegin
+                                          : (x.baseBegin == x.baseEnd) > (y.baseBegin == y.baseEnd);
+    };
+    
+    size_t i = 0;       // Next hunk of theirs
+    size_t j = 0;       // Next hunk of ours
+    size_t copied = 0;  // Base lines already emitted
+    while (i < t.size() || j < o.size()) {
+        // Start a region at the earlier hunk and absorb everything touching it
+        const bool takeTheirs = j == o.size() || (i < t.size() && !before(o[j], t[i]));
+        const Hunk& seed = takeTheirs ? t[i] : o[j];
+        size_t begin = seed.baseBegin;
+        size_t end = seed.baseEnd;
+        const size_t firstT = i;
+        const size_t firstO = j;
+        takeTheirs ? ++i : ++j;
+        for (bool grew = true; grew;) {
+            grew = false;
+            while (i < t.size() && touches(t[i], begin, end)) {
+                end = std::max(end, t[i++].baseEnd);
+                grew = true;
+            }
+            while (j < o.size() && touches(o[j], begin, end)) {
+                end = std::max(end, o[j++].baseEnd);
+                grew = true;
+            }
+        }
+        
+        result.text.append(base.lines(copied, begin));
+        copied = end;
+        if (j == firstO) {
+            result.text.append(sideText(base, theirs, t, firstT, i, begin, end));
+            continue;
+        }
+        if (i == firstT) {
+            result.text.append(sideText(base, ours, o, firstO, j, begin, end));
+            continue;
+        }
+        
+        // Changed on both sides
+        Conflict conflict;
+        conflict.theirs = sideText(base, theirs, t, firstT, i, begin, end);
+        conflict.ours = sideText(base, ours, o, firstO, j, begin, end);
+        if (conflict.theirs == conflict.ours) {
+            result.text.append(conflict.ours);
+            continue;
+        }
+        conflict.offset = result.text.size();
+        conflict.baseLine = begin;
+        conflict.base.assign(base.lines(begin, end));
+        result.text.append(conflict.theirs);
+        result.text.append(conflict.ours);
+        result.conflicts.push_back(std::move(conflict));
+    }
+    result.text.append(base.lines(copied, base.size()));
+    return result;
+}
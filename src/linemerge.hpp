@@ -0,0 +1,68 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Line Merge Component Header
+//
+// This header defines the LineMerge class, a line-level diff and three-way
+// merge. Lines are compared by hash (bytes are only compared when hashes
+// match), the common head and tail are skipped before any real work, and
+// the diff is Myers' linear-space algorithm, so a small change to a
+// 100k-line file costs little more than hashing it.
+// ------------------------------------------------------------------------------
+
+#ifndef LINEMERGE_HPP
+#define LINEMERGE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class LineMerge {
+public:
+    // --------------------------------------------------------------------------
+    // Structure: Hunk
+    // Purpose: Lines [baseBegin, baseEnd) of the base are replaced by lines
+    // [otherBegin, otherEnd) of the other text (0-based; a line includes its
+    // newline, so a missing final newline is a difference).
+    // --------------------------------------------------------------------------
+    struct Hunk {
+        size_t baseBegin = 0;
+        size_t baseEnd = 0;
+        size_t otherBegin = 0;
+        size_t otherEnd = 0;
+    };
+    
+    // --------------------------------------------------------------------------
+    // Structure: Conflict
+    // Purpose: A base region both sides changed differently. The merged text
+    // holds the theirs version followed by the ours version at offset.
+    // --------------------------------------------------------------------------
+    struct Conflict {
+        size_t offset = 0;          // Byte offset of the region in the merged text
+        size_t baseLine = 0;        // First base line of the region (0-based)
+        std::string base;           // Region in the base
+        std::string theirs;         // Region as the other writer left it
+        std::string ours;           // Region as we changed it
+    };
+    
+    // Result of a three-way merge
+    struct Result {
+        std::string text;                   // Merged content
+        std::vector<Conflict> conflicts;    // Regions changed on both sides
+    };
+    
+    // Largest edit distance searched for in one step; past it the rest of a
+    // region is reported as one replacement hunk (still a correct diff)
+    static constexpr size_t kMaxCost = 4096;
+    
+    // Line changes that turn base into other, in order and non-adjacent
+    static std::vector<Hunk> diff(std::string_view base, std::string_view other);
+    
+    // Merge the changes from base to theirs with those from base to ours.
+    // Changes to different lines combine; the same change made on both sides
+    // is taken once; anything else is a conflict (see Conflict)
+    static Result merge(std::string_view base, std::string_view theirs, std::string_view ours);
+};
+
+#endif // LINEMERGE_HPP
@@ -0,0 +1,121 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Line Scanner Component Implementation
+//
+// This file implements block-wise alias line detection. Each block produces
+// newline and blank masks; the scanner only looks at individual bytes where
+// a line starts, so long non-alias lines (comments, exports, functions) are
+// skipped a whole block at a time.
+// ------------------------------------------------------------------------------
+
+#include "linescanner.hpp"
+#include "aliasmanager.hpp"   // For isAliasLine (scalar reference)
+#include "simd.hpp"           // For block comparisons
+#include <cstring>            // For std::memcmp, std::memcpy
+
+// ------------------------------------------------------------------------------
+// Find Alias Lines (SIMD)
+// State carried across blocks:
+// - atLineStart: only blanks seen since the current line began
+// - pending: the current line starts with 'alias' and waits for its newline
+// ------------------------------------------------------------------------------
+std::vector<LineRef> LineScanner::findAliasLines(std::string_view buffer) {
+    std::vector<LineRef> lines;
+    
+    const char* data = buffer.data();
+    const size_t size = buffer.size();
+    
+    size_t lineStart = 0;       // Offset of the current line
+    size_t lineNumber = 1;      // Number of the current line
+    bool atLineStart = true;    // No non-blank byte seen on this line yet
+    bool pending = false;       // Current line is an alias line
+    
+    auto scanBlock = [&](const char* p, size_t base, simd::Mask valid) {
+        simd::Block block = simd::load(p);
+        simd::Mask newlines = simd::eq(block, '\n') & valid;
+        
+        // Fast path: inside a line with no newline in this block
+        if (!atLineStart && newlines == 0) {
+            return;
+        }
+        
+        simd::Mask blanks = simd::eq(block, ' ') | simd::eq(block, '\t');
+        simd::Mask others = ~(blanks | newlines) & valid;
+        simd::Mask remaining = valid;
+        
+        while (true) {
+            // At a line start we need the first non-blank byte or newline,
+            // otherwise only the next newline matters
+            simd::Mask events = (atLineStart ? (newlines | others) : newlines) & remaining;
+            if (events == 0) {
+                break;
+            }
+            
+            int bit = simd::firstBit(events);
+            size_t pos = base + static_cast<size_t>(bit);
+            remaining &= ~simd::lowBits(static_cast<size_t>(bit) + 1);
+            
+            if (newlines & (simd::Mask(1) << bit)) {
+                // End of line: emit it if it was an alias line
+                if (pending) {
+                    lines.push_back({lineStart, pos - lineStart, lineNumber});
+                    pending = false;
+                }
+                ++lineNumber;
+                lineStart = pos + 1;
+                atLineStart = true;
+            } else {
+                // First non-blank byte of the line: check the keyword
+                pending = size - pos >= 5 && std::memcmp(data + pos, "alias", 5) == 0;
+                atLineStart = false;
+            }
+        }
+    };
+    
+    // Full blocks straight from the buffer
+    size_t pos = 0;
+    for (; pos + simd::kBlockSize <= size; pos += simd::kBlockSize) {
+        scanBlock(data + pos, pos, simd::lowBits(simd::kBlockSize));
+    }
+    
+    // Tail: copy into a padded block and mask out the padding
+    if (pos < size) {
+        char tail[simd::kBlockSize] = {};
+        std::memcpy(tail, data + pos, size - pos);
+        scanBlock(tail, pos, simd::lowBits(size - pos));
+    }
+    
+    // Last line without a trailing newline
+    if (pending) {
+        lines.push_back({lineStart, size - lineStart, lineNumber});
+    }
+    
+    return lines;
+}
+
+// ------------------------------------------------------------------------------
+// Find Alias Lines (Scalar Reference)
+// Splits the buffer into lines and tests each one with isAliasLine
+// ------------------------------------------------------------------------------
+std::vector<LineRef> LineScanner::findAliasLinesScalar(std::string_view buffer) {
+    std::vector<LineRef> lines;
+    
+    size_t offset = 0;
+    size_t lineNumber = 1;
+    while (offset < buffer.size()) {
+        size_t eol = buffer.find('\n', offset);
+        if (eol == std::string_view::npos) {
+            eol = buffer.size();
+        }
+        
+        if (AliasManager::isAliasLine(buffer.substr(offset, eol - offset))) {
+            lines.push_back({offset, eol - offset, lineNumber});
+        }
+        
+        offset = eol + 1;
+        ++lineNumber;
+    }
+    
+    return lines;
+}
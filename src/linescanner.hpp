@@ -0,0 +1,51 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Line Scanner Component Header
+//
+// This header defines the LineScanner class, which locates alias definition
+// lines inside a raw configuration file buffer. Instead of splitting the file
+// into lines and testing each one, the scanner walks the buffer in SIMD
+// blocks, tracking newlines and the first non-blank byte of every line with
+// bit masks, so only lines that start with the 'alias' keyword are reported.
+// ------------------------------------------------------------------------------
+
+#ifndef LINESCANNER_HPP
+#define LINESCANNER_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// ------------------------------------------------------------------------------
+// Structure: LineRef
+// Purpose: Location of one line inside a scanned buffer.
+// ------------------------------------------------------------------------------
+struct LineRef {
+    size_t offset;       // Byte offset of the first character of the line
+    size_t length;       // Line length in bytes, excluding the newline
+    size_t lineNumber;   // 1-based line number within the buffer
+};
+
+class LineScanner {
+public:
+    // --------------------------------------------------------------------------
+    // Scanning Methods (Static)
+    // --------------------------------------------------------------------------
+    
+    // Find all lines whose first non-blank word starts with 'alias'
+    // Uses AVX2/SSE2 block scanning when available
+    // Returns: Line references in file order
+    static std::vector<LineRef> findAliasLines(std::string_view buffer);
+    
+    // Reference implementation: line-by-line scan using isAliasLine
+    // Returns: Same result as findAliasLines
+    static std::vector<LineRef> findAliasLinesScalar(std::string_view buffer);
+    
+    // Get a view of a scanned line
+    static std::string_view lineAt(std::string_view buffer, const LineRef& ref) {
+        return buffer.substr(ref.offset, ref.length);
+    }
+};
+
+#endif // LINESCANNER_HPP
@@ -26,6 +26,7 @@
 #include <QFont>                 // Font customization
 #include <QGraphicsOpacityEffect> // Visual effects
 #include <QPropertyAnimation>    // Animation framework
+#include <QSignalBlocker>        // Quiet list updates during live reload
 
 // ------------------------------------------------------------------------------
 // Constructor
@@ -47,6 +48,19 @@ MainWindow::MainWindow(QWidget* parent)
     loadAliasesFromFile();
     updateShellInfo();
     applyStylesheet();
+    
+    // Live reload: re-parse on the watcher thread, patch the list on ours
+    fileWatcher.start(configFilePath, [this]() {
+        AliasDelta delta;
+        AliasTable table;
+        std::string content;
+        if (reloader->refresh(delta, table, &content)) {
+            QMetaObject::invokeMethod(this, [this, delta, table = std::move(table),
+                                             content = std::move(content)]() mutable {
+                applyAliasDelta(delta, std::move(table), std::move(content));
+            }, Qt::QueuedConnection);
+        }
+    });
 }
 
 // ------------------------------------------------------------------------------
@@ -64,6 +78,8 @@ void MainWindow::initializeShellDetection() {
     configFilePath = ShellDetector::getConfigFilePath(currentShell);
     configHandler = std::make_unique<ConfigFileHandler>(configFilePath, currentShell);
     backupManager = std::make_unique<BackupManager>(configFilePath);
+    backupManager->setAsync(true);  // Edits only wait for the snapshot
+    reloader = std::make_unique<AliasReloader>(configFilePath, currentShell);
 }
 
 // ------------------------------------------------------------------------------
@@ -245,8 +261,15 @@ void MainWindow::setupConnections() {
 // ------------------------------------------------------------------------------
 void MainWindow::loadAliasesFromFile() {
     try {
-        currentAliases = configHandler->loadAliases();
-        updateAliasList();
+        AliasDelta delta;
+        AliasTable table;
+        std::string content;
+        if (reloader->refresh(delta, table, &content)) {
+            applyAliasDelta(delta, std::move(table), std::move(content));
+        }
+        
+        // Saves are merged against what the user is looking at
+        configHandler->setMergeBase(shownContent);
     } catch (const std::exception& e) {
         showError("Error", QString("Failed to load aliases: ") + e.what());
     }
@@ -269,15 +292,59 @@ void MainWindow::updateShellInfo() {
 // ------------------------------------------------------------------------------
 void MainWindow::updateAliasList() {
     aliasList->clear();
-    for (const auto& alias : currentAliases) {
-        // Format: "alias_name = command"
-        aliasList->addItem(
-            QString::fromStdString(alias.name + " = " + alias.command)
-        );
+    for (size_t row = 0; row < currentAliases.size(); ++row) {
+        aliasList->addItem(aliasItemText(row));
     }
     statusLabel->setText(QString("Total aliases: %1").arg(currentAliases.size()));
 }
 
+// ------------------------------------------------------------------------------
+// Apply a Reloader Delta
+// Only the replaced rows are touched, so selection and scroll position
+// survive an edit made elsewhere. Deltas that arrive out of order fall
+// back to rebuilding the whole list
+// ------------------------------------------------------------------------------
+void MainWindow::applyAliasDelta(const AliasDelta& delta, AliasTable table,
+                                 std::string content) {
+    if (delta.generation <= modelGeneration) {
+        return;  // Already showing this table or a newer one
+    }
+    
+    const bool contiguous = delta.baseGeneration == modelGeneration &&
+                            static_cast<size_t>(aliasList->count()) == currentAliases.size();
+    currentAliases = std::move(table);
+    shownContent = std::move(content);
+    modelGeneration = delta.generation;
+    
+    // A live reload must not re-select (and so reset) an edit in progress
+    QSignalBlocker blocker(aliasList);
+    if (!contiguous) {
+        updateAliasList();
+    } else {
+        const int first = static_cast<int>(delta.firstRow);
+        for (size_t i = 0; i < delta.removedRows; ++i) {
+            delete aliasList->takeItem(first);
+        }
+        for (size_t i = 0; i < delta.insertedRows; ++i) {
+            aliasList->insertItem(first + static_cast<int>(i), aliasItemText(delta.firstRow + i));
+        }
+        statusLabel->setText(QString("Total aliases: %1").arg(currentAliases.size()));
+    }
+    filterAliasList(searchInput->text());
+}
+
+// ------------------------------------------------------------------------------
+// Alias List Item Text
+// ------------------------------------------------------------------------------
+QString MainWindow::aliasItemText(size_t row) const {
+    std::string_view name = currentAliases.name(row);
+    std::string_view command = currentAliases.command(row);
+    
+    // Format: "alias_name = command"
+    return QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size())) + " = " +
+           QString::fromUtf8(command.data(), static_cast<qsizetype>(command.size()));
+}
+
 // ------------------------------------------------------------------------------
 // Filter Alias List Based on Search Text
 // ------------------------------------------------------------------------------
@@ -319,7 +386,7 @@ void MainWindow::toggleTheme() {
 std::string getCurrentDate() {
     auto now = std::chrono::system_clock::now();
     auto in_time_t = std::chrono::system_clock::to_time_t(now);
-
+    
     std::stringstream ss;
     ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d");
     return ss.str();
@@ -336,23 +403,37 @@ void MainWindow::onAddAlias() {
         return;
     }
     
-    // Create backup before modification (safety first!)
-    std::string backupPath = backupManager->createBackup();
-    if (backupPath.empty()) {
-        showError("Backup Error", "Failed to create backup. Operation cancelled.");
-        return;
+    // The commit backs the file up first
+    ConfigFileHandler::Transaction transaction = configHandler->beginTransaction();
+    bool updating = !editingName.empty() && currentAliases.find(editingName) != AliasTable::npos;
+    if (updating) {
+        // Edit the selected alias where it stands (renamed if the name changed)
+        transaction.rename(editingName, aliasName.toStdString());
+        transaction.update(aliasName.toStdString(), command.toStdString());
+    } else {
+        // Add the alias (an existing one of that name is updated in place)
+        Alias newAlias{aliasName.toStdString(), command.toStdString(), std::string(),true, getCurrentDate(), getCurrentDate()};
+        transaction.add(newAlias);
     }
-    
-    // Create and add the alias
-    Alias newAlias{aliasName.toStdString(), command.toStdString(), std::string(),true, getCurrentDate(), getCurrentDate()};
-    if (!configHandler->addAlias(newAlias)) {
+    if (!transaction.commit(backupManager.get())) {
+        if (!configHandler->getConflicts().empty()) {
+            // Show the disk version now (the watcher may not have reloaded it
+            // yet) so that saving again applies ours over it
+            const std::string error = configHandler->getLastError();
+            loadAliasesFromFile();
+            showError("Changed on Disk",
+                QString::fromStdString(error) +
+                "\n\nThe list shows the current file. Save again to overwrite it.");
+            return;
+        }
         showError("Error", 
-            QString::fromStdString("Failed to add alias: " + configHandler->getLastError())
+            QString::fromStdString((updating ? "Failed to update alias: " : "Failed to add alias: ") +
+                                   configHandler->getLastError())
         );
         return;
     }
     
-    showSuccess("✨ Alias added successfully!");
+    showSuccess(updating ? "⚙️  Alias updated successfully!" : "✨ Alias added successfully!");
     clearInputFields();
     loadAliasesFromFile();  // Refresh the list
 }
@@ -380,17 +461,16 @@ void MainWindow::onRemoveAlias() {
         return;
     }
     
-    // Create backup before removal
-    std::string backupPath = backupManager->createBackup();
-    if (backupPath.empty()) {
-        showError("Backup Error", "Failed to create backup. Operation cancelled.");
-        return;
-    }
-    
-    // Remove the alias
-    if (!configHandler->removeAlias(aliasName.toStdString())) {
+    // Remove the alias; the commit backs the file up first
+    ConfigFileHandler::Transaction transaction = configHandler->beginTransaction();
+    transaction.remove(aliasName.toStdString());
+    if (!transaction.commit(backupManager.get())) {
+        const std::string error = configHandler->getLastError();
+        if (!configHandler->getConflicts().empty()) {
+            loadAliasesFromFile();
+        }
         showError("Error", 
-            QString::fromStdString("Failed to remove alias: " + configHandler->getLastError())
+            QString::fromStdString("Failed to remove alias: " + error)
         );
         return;
     }
@@ -422,6 +502,12 @@ void MainWindow::onAliasSelected() {
         aliasNameInput->setText(parts[0].trimmed());
         commandInput->setText(parts[1].trimmed());
         isModifying = false;
+        
+        // Remember which alias an update applies to, and the file as it
+        // was when editing started (changes made on disk meanwhile are merged)
+        editingName = parts[0].trimmed().toStdString();
+        configHandler->setMergeBase(shownContent);
+        addButton->setText("⚙️  Update Alias");
     }
 }
 
@@ -431,7 +517,9 @@ void MainWindow::onAliasSelected() {
 // ------------------------------------------------------------------------------
 void MainWindow::onNameChanged(const QString& text) {
     if (isModifying) return;
-    addButton->setText(text.isEmpty() ? "✨ Add Alias" : "⚙️  Update Alias");
+    bool existing = !editingName.empty() ||
+                    currentAliases.find(text.trimmed().toStdString()) != AliasTable::npos;
+    addButton->setText(existing ? "⚙️  Update Alias" : "✨ Add Alias");
 }
 
 // ------------------------------------------------------------------------------
@@ -573,6 +661,7 @@ bool MainWindow::validateInput(QString& aliasName, QString& command) {
 // Clear Input Fields
 // ------------------------------------------------------------------------------
 void MainWindow::clearInputFields() {
+    editingName.clear();
     aliasNameInput->clear();
     commandInput->clear();
     commandStatus->clear();
@@ -18,8 +18,11 @@
 #include <vector>
 #include "shelldetector.hpp"
 #include "aliasmanager.hpp"
+#include "aliastable.hpp"
 #include "configfilehandler.hpp"
 #include "backupmanager.hpp"
+#include "aliasreloader.hpp"
+#include "filewatcher.hpp"
 
 // Forward declarations for Qt widgets (reduces compilation dependencies)
 class QLabel;
@@ -78,6 +81,8 @@ private:
     // --------------------------------------------------------------------------
     std::unique_ptr<ConfigFileHandler> configHandler;  // Handles config file I/O
     std::unique_ptr<BackupManager> backupManager;      // Manages backup operations
+    std::unique_ptr<AliasReloader> reloader;           // Incremental re-parsing
+    FileWatcher fileWatcher;                           // Live reload (stops before reloader)
     ShellDetector::Shell currentShell;                 // Detected shell type
     std::string configFilePath;                        // Path to shell config file
     
@@ -101,7 +106,10 @@ private:
     // --------------------------------------------------------------------------
     // Application State
     // --------------------------------------------------------------------------
-    std::vector<Alias> currentAliases;  // Current list of aliases
+    AliasTable currentAliases;          // Current aliases (arena-backed table)
+    uint64_t modelGeneration = 0;       // Reloader generation shown in the list
+    std::string shownContent;           // File content the list shows (merge base)
+    std::string editingName;            // Alias selected for editing (empty = adding)
     bool isModifying = false;           // Flag to prevent recursive updates
     bool isDarkTheme = false;           // Current theme state
     
@@ -118,6 +126,9 @@ private:
     void loadAliasesFromFile();         // Load aliases from config file
     void updateShellInfo();             // Update shell info display
     void updateAliasList();             // Refresh alias list widget
+    void applyAliasDelta(const AliasDelta& delta, AliasTable table,
+                         std::string content);  // Patch changed rows
+    QString aliasItemText(size_t row) const;  // List text of one alias
     void filterAliasList(const QString& searchText);  // Filter displayed aliases
     
     // --------------------------------------------------------------------------
@@ -0,0 +1,466 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Managed Aliases Component Implementation
+//
+// This file implements the ManagedAliases class. The owned region is found
+// by a byte search for the marker lines, parsed on its own, edited as a
+// plain list and formatted again from scratch. The new file is the old
+// bytes before the region, the new region and the old bytes after it,
+// written atomically under the same writer lock ConfigFileHandler uses.
+// ------------------------------------------------------------------------------
+
+#include "managedaliases.hpp"
+#include "aliastokenizer.hpp"  // Statement tokenizer
+#include "atomicwriter.hpp"    // Crash-safe replacement
+#include "filelock.hpp"        // Writer lock
+#include "mappedfile.hpp"      // Zero-copy file reads
+#include <algorithm>           // For std::find_if
+#include <cerrno>              // For errno
+#include <cstdlib>             // For std::getenv
+#include <cstring>             // For std::strerror
+#include <fcntl.h>             // For open
+#include <filesystem>          // Directory creation
+#include <system_error>        // For std::error_code
+#include <unistd.h>            // For close
+#include <unordered_map>       // Name lookup while parsing
+
+// Alias for convenience
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------
+// Utility: Quote a Path for the Shell
+// ------------------------------------------------------------------------------
+static std::string quotePath(ShellDetector::Shell shell, const std::string& path) {
+    std::string quoted = "'";
+    for (char c : path) {
+        if (shell == ShellDetector::Shell::FISH && (c == '\'' || c == '\\')) {
+            quoted += '\\';
+            quoted += c;
+        } else if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Find a Whole Marker Line
+// ------------------------------------------------------------------------------
+static size_t findLine(std::string_view content, std::string_view marker, size_t from) {
+    for (size_t at = content.find(marker, from); at != std::string_view::npos;
+         at = content.find(marker, at + 1)) {
+        const size_t after = at + marker.size();
+        if ((at == 0 || content[at - 1] == '\n') &&
+            (after == content.size() || content[after] == '\n')) {
+            return at;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Position of an Alias by Name
+// ------------------------------------------------------------------------------
+static std::vector<Alias>::iterator findAlias(std::vector<Alias>& aliases,
+                                              const std::string& name) {
+    return std::find_if(aliases.begin(), aliases.end(),
+                        [&name](const Alias& alias) { return alias.name == name; });
+}
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+ManagedAliases::ManagedAliases(const std::string& rcPath, ShellDetector::Shell shell,
+                               Storage storage, const std::string& sidecarPath)
+    : rcPath(rcPath),
+      sidecarPath(sidecarPath.empty() ? defaultSidecarPath(shell) : sidecarPath),
+      shell(shell),
+      storage(storage),
+      aliasManager(shell) {
+}
+
+// ------------------------------------------------------------------------------
+// Default Sidecar Path
+// ------------------------------------------------------------------------------
+std::string ManagedAliases::defaultSidecarPath(ShellDetector::Shell shell) {
+    fs::path dir;
+    if (const char* xdg = std::getenv("XDG_CONFIG_HOME"); xdg != nullptr && xdg[0] == '/') {
+        dir = fs::path(xdg) / "aliacan";
+    } else if (const char* home = std::getenv("HOME"); home != nullptr && home[0] != '\0') {
+        dir = fs::path(home) / ".config" / "aliacan";
+    } else {
+        return "";
+    }
+    
+    switch (shell) {
+        case ShellDetector::Shell::ZSH:
+            return (dir / "aliases.zsh").string();
+        case ShellDetector::Shell::FISH:
+            return (dir / "aliases.fish").string();
+        case ShellDetector::Shell::BASH:
+        case ShellDetector::Shell::UNKNOWN:
+        default:
+            return (dir / "aliases.bash").string();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Install the Owned Region
+// ------------------------------------------------------------------------------
+bool ManagedAliases::install() {
+    if (storage == Storage::Block) {
+        return replaceRegion(rcPath, true, [this](std::string_view region, std::string& out) {
+            out = region.empty() ? render({}) : std::string(region);
+            return true;
+        });
+    }
+    
+    if (sidecarPath.empty()) {
+        lastError = "Cannot resolve the sidecar file location";
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::path(sidecarPath).parent_path(), ec);
+    if (ec) {
+        lastError = "Cannot create " + fs::path(sidecarPath).parent_path().string() + ": " +
+                    ec.message();
+        return false;
+    }
+    
+    // Aliases a marker block already holds move to the sidecar file before
+    // the block is replaced by the line sourcing it
+    std::vector<Alias> adopted;
+    MappedFile rc;
+    size_t begin = 0;
+    size_t end = 0;
+    bool found = false;
+    if (fs::exists(rcPath, ec) && rc.open(rcPath) && findBlock(rc.view(), begin, end, found) &&
+        found) {
+        adopted = parseRegion(rc.view().substr(begin, end - begin));
+    }
+    rc.close();
+    
+    const bool stored = replaceRegion(sidecarPath, false,
+        [this, &adopted](std::string_view region, std::string& out) {
+            std::vector<Alias> aliases = parseRegion(region);
+            for (Alias& alias : adopted) {
+                if (findAlias(aliases, alias.name) == aliases.end()) {
+                    alias.enabled = true;
+                    aliases.push_back(std::move(alias));
+                }
+            }
+            out = render(aliases);
+            return true;
+        });
+    return stored && replaceRegion(rcPath, true, [this](std::string_view, std::string& out) {
+        out = sourceLine();
+        return true;
+    });
+}
+
+// ------------------------------------------------------------------------------
+// Check the Installation
+// ------------------------------------------------------------------------------
+bool ManagedAliases::isInstalled() const {
+    std::error_code ec;
+    MappedFile rc;
+    size_t begin = 0;
+    size_t end = 0;
+    bool found = false;
+    if (!fs::exists(rcPath, ec) || !rc.open(rcPath) ||
+        !findBlock(rc.view(), begin, end, found) || !found) {
+        return false;
+    }
+    return storage == Storage::Block || fs::exists(sidecarPath, ec);
+}
+
+// ------------------------------------------------------------------------------
+// Alias File Path
+// ------------------------------------------------------------------------------
+std::string ManagedAliases::getAliasFilePath() const {
+    return storage == Storage::Block ? rcPath : sidecarPath;
+}
+
+// ------------------------------------------------------------------------------
+// Load Managed Aliases
+// ------------------------------------------------------------------------------
+std::vector<Alias> ManagedAliases::loadAliases() {
+    const std::string path = getAliasFilePath();
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        return {};
+    }
+    
+    MappedFile file;
+    if (!file.open(path)) {
+        lastError = file.getLastError();
+        return {};
+    }
+    
+    size_t begin = 0;
+    size_t end = file.size();
+    bool found = true;
+    if (storage == Storage::Block && !findBlock(file.view(), begin, end, found)) {
+        lastError = path + ": managed block has no end marker";
+        return {};
+    }
+    if (!found) {
+        return {};
+    }
+    return parseRegion(file.view().substr(begin, end - begin));
+}
+
+// ------------------------------------------------------------------------------
+// Add Alias
+// ------------------------------------------------------------------------------
+bool ManagedAliases::addAlias(const Alias& alias) {
+    if (!AliasManager::validateAliasName(alias.name) ||
+        !AliasManager::validateCommand(alias.command)) {
+        lastError = "Invalid alias name or command";
+        return false;
+    }
+    
+    return modify([&alias](std::vector<Alias>& aliases) {
+        if (auto it = findAlias(aliases, alias.name); it != aliases.end()) {
+            it->command = alias.command;
+        } else {
+            aliases.push_back(alias);
+        }
+        return true;
+    });
+}
+
+// ------------------------------------------------------------------------------
+// Remove Alias
+// ------------------------------------------------------------------------------
+bool ManagedAliases::removeAlias(const std::string& aliasName) {
+    return modify([this, &aliasName](std::vector<Alias>& aliases) {
+        auto it = findAlias(aliases, aliasName);
+        if (it == aliases.end()) {
+            lastError = "Alias not found: " + aliasName;
+            return false;
+        }
+        aliases.erase(it);
+        return true;
+    });
+}
+
+// ------------------------------------------------------------------------------
+// Update Alias
+// ------------------------------------------------------------------------------
+bool ManagedAliases::updateAlias(const std::string& aliasName, const std::string& newCommand) {
+    if (!AliasManager::validateCommand(newCommand)) {
+        lastError = "Invalid command";
+        return false;
+    }
+    
+    return modify([this, &aliasName, &newCommand](std::vector<Alias>& aliases) {
+        auto it = findAlias(aliases, aliasName);
+        if (it == aliases.end()) {
+            lastError = "Alias not found: " + aliasName;
+            return false;
+        }
+        it->command = newCommand;
+        return true;
+    });
+}
+
+// ------------------------------------------------------------------------------
+// Rename Alias
+// ------------------------------------------------------------------------------
+bool ManagedAliases::renameAlias(const std::string& oldName, const std::string& newName) {
+    if (!AliasManager::validateAliasName(newName)) {
+        lastError = "Invalid alias name";
+        return false;
+    }
+    
+    return modify([this, &oldName, &newName](std::vector<Alias>& aliases) {
+        auto it = findAlias(aliases, oldName);
+        if (it == aliases.end()) {
+            lastError = "Alias not found: " + oldName;
+            return false;
+        }
+        if (newName != oldName && findAlias(aliases, newName) != aliases.end()) {
+            lastError = "Alias already exists: " + newName;
+            return false;
+        }
+        it->name = newName;
+        return true;
+    });
+}
+
+// ------------------------------------------------------------------------------
+// Error Handling
+// ------------------------------------------------------------------------------
+std::string ManagedAliases::getLastError() const {
+    return lastError;
+}
+
+// ------------------------------------------------------------------------------
+// Locate the Marker Block
+// ------------------------------------------------------------------------------
+bool ManagedAliases::findBlock(std::string_view content, size_t& begin, size_t& end,
+                               bool& found) {
+    found = false;
+    const size_t open = findLine(content, kBeginMarker, 0);
+    if (open == std::string_view::npos) {
+        return true;
+    }
+    const size_t close = findLine(content, kEndMarker, open + kBeginMarker.size());
+    if (close == std::string_view::npos) {
+        return false;
+    }
+    
+    found = true;
+    begin = open + kBeginMarker.size() + 1;
+    end = close;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Rewrite the Owned Region
+// ------------------------------------------------------------------------------
+bool ManagedAliases::replaceRegion(
+    const std::string& path, bool delimited,
+    const std::function<bool(std::string_view, std::string&)>& produce) {
+    FileLock lock;
+    if (!lock.lock(path)) {
+        lastError = lock.getLastError();
+        return false;
+    }
+    
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 && errno != ENOENT) {
+        lastError = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    MappedFile file;
+    if (fd >= 0 && !file.open(fd)) {
+        lastError = file.getLastError();
+        close(fd);
+        return false;
+    }
+    const std::string_view content = file.view();
+    
+    size_t begin = 0;
+    size_t end = content.size();
+    bool found = fd >= 0;
+    if (delimited && !findBlock(content, begin, end, found)) {
+        lastError = path + ": managed block has no end marker";
+        close(fd);
+        return false;
+    }
+    
+    const std::string_view region = found ? content.substr(begin, end - begin)
+                                          : std::string_view();
+    std::string replacement;
+    if (!produce(region, replacement)) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    if (found && region == replacement) {
+        close(fd);
+        return true;
+    }
+    
+    // Bytes outside the region are copied by the kernel, never parsed
+    AtomicWriter writer(path);
+    bool ok = writer.open();
+    if (!delimited) {
+        ok = ok && writer.write(replacement);
+    } else if (found) {
+        ok = ok && writer.copyRange(fd, 0, begin) && writer.write(replacement) &&
+             writer.copyRange(fd, end, content.size() - end);
+    } else {
+        std::string block;
+        if (!content.empty() && content.back() != '\n') {
+            block += '\n';
+        }
+        block.append(kBeginMarker).append("\n").append(replacement);
+        block.append(kEndMarker).append("\n");
+        ok = ok && (fd < 0 || writer.copyRange(fd, 0, content.size())) && writer.write(block);
+    }
+    ok = ok && writer.commit();
+    if (fd >= 0) close(fd);
+    
+    if (!ok) {
+        lastError = writer.getLastError();
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Edit the Managed Aliases
+// Without install, Block storage gets its marker block appended and Sidecar
+// storage its file created, but only install hooks the sidecar into the rc
+// ------------------------------------------------------------------------------
+bool ManagedAliases::modify(const std::function<bool(std::vector<Alias>&)>& change) {
+    if (storage == Storage::Sidecar) {
+        std::error_code ec;
+        if (!sidecarPath.empty()) {
+            fs::create_directories(fs::path(sidecarPath).parent_path(), ec);
+        }
+        if (sidecarPath.empty() || ec) {
+            lastError = "Cannot create the sidecar file directory";
+            return false;
+        }
+    }
+    
+    return replaceRegion(getAliasFilePath(), storage == Storage::Block,
+        [this, &change](std::string_view region, std::string& out) {
+            std::vector<Alias> aliases = parseRegion(region);
+            if (!change(aliases)) {
+                return false;
+            }
+            out = render(aliases);
+            return true;
+        });
+}
+
+// ------------------------------------------------------------------------------
+// Parse the Owned Region
+// ------------------------------------------------------------------------------
+std::vector<Alias> ManagedAliases::parseRegion(std::string_view region) const {
+    std::vector<AliasDefinition> definitions;
+    AliasTokenizer::tokenize(shell, region, definitions);
+    
+    std::vector<Alias> aliases;
+    std::unordered_map<std::string_view, size_t> positions;
+    aliases.reserve(definitions.size());
+    for (const AliasDefinition& def : definitions) {
+        auto [it, inserted] = positions.try_emplace(def.view.name, aliases.size());
+        if (inserted) {
+            // Everything the region defines is live in the shell
+            aliases.push_back(def.view.toAlias());
+            aliases.back().enabled = true;
+        } else {
+            def.view.materializeCommand(aliases[it->second].command);
+        }
+    }
+    return aliases;
+}
+
+// ------------------------------------------------------------------------------
+// Format the Owned Region
+// ------------------------------------------------------------------------------
+std::string ManagedAliases::render(const std::vector<Alias>& aliases) const {
+    std::string text = storage == Storage::Block
+        ? "# Generated by AliaCan: changes between these markers are overwritten\n"
+        : "# Generated by AliaCan: changes to this file are overwritten\n";
+    aliasManager.formatAliasesInto(text, aliases);
+    return text;
+}
+
+// ------------------------------------------------------------------------------
+// Line Sourcing the Sidecar File
+// ------------------------------------------------------------------------------
+std::string ManagedAliases::sourceLine() const {
+    const std::string quoted = quotePath(shell, sidecarPath);
+    if (shell == ShellDetector::Shell::FISH) {
+        return "test -f " + quoted + "; and source " + quoted + "\n";
+    }
+    return "[ -f " + quoted + " ] && . " + quoted + "\n";
+}
@@ -0,0 +1,132 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Managed Aliases Component Header
+//
+// This header defines the ManagedAliases class, an opt-in storage mode in
+// which AliaCan owns the aliases it writes outright instead of editing them
+// wherever they stand in the rc file. The owned region is either a block
+// between two marker lines of the rc file, or a dedicated file under
+// ~/.config/aliacan that a marker block in the rc file sources once. Every
+// change regenerates only that region with the shell's formatter, so its
+// cost follows the number of managed aliases; the rest of the rc file is
+// copied through (copy_file_range) but never parsed.
+// ------------------------------------------------------------------------------
+
+#ifndef MANAGEDALIASES_HPP
+#define MANAGEDALIASES_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aliasmanager.hpp"
+#include "shelldetector.hpp"
+
+class ManagedAliases {
+public:
+    // Where the managed aliases live
+    enum class Storage {
+        Block,     // Between the markers in the rc file
+        Sidecar    // In a separate file sourced from the markers in the rc file
+    };
+    
+    // Lines delimiting the owned block of the rc file
+    static constexpr std::string_view kBeginMarker = "# >>> aliacan managed aliases >>>";
+    static constexpr std::string_view kEndMarker = "# <<< aliacan managed aliases <<<";
+    
+    // --------------------------------------------------------------------------
+    // Constructor
+    // --------------------------------------------------------------------------
+    
+    // Manage aliases of rcPath for shell. sidecarPath overrides the default
+    // sidecar location (see defaultSidecarPath) and is ignored for Block
+    ManagedAliases(const std::string& rcPath, ShellDetector::Shell shell, Storage storage,
+                   const std::string& sidecarPath = "");
+    
+    // Default sidecar file: $XDG_CONFIG_HOME/aliacan/aliases.<shell>, or
+    // ~/.config/aliacan/aliases.<shell> (empty if neither can be resolved)
+    static std::string defaultSidecarPath(ShellDetector::Shell shell);
+    
+    // --------------------------------------------------------------------------
+    // Setup
+    // --------------------------------------------------------------------------
+    
+    // Create the owned region: an empty marker block (Block), or the sidecar
+    // file plus a marker block sourcing it (Sidecar). Existing blocks and
+    // files are left as they are, so this can be called on every start
+    // Returns: true if the region exists
+    bool install();
+    
+    // Check whether install has been done for this storage
+    bool isInstalled() const;
+    
+    // File holding the managed aliases (the rc file for Block)
+    std::string getAliasFilePath() const;
+    
+    // --------------------------------------------------------------------------
+    // Alias Management
+    // --------------------------------------------------------------------------
+    
+    // Aliases of the owned region, in order (empty if not installed)
+    std::vector<Alias> loadAliases();
+    
+    // Define an alias (an existing managed alias of that name is updated)
+    bool addAlias(const Alias& alias);
+    
+    // Remove a managed alias
+    // Returns: true if the alias was found and removed
+    bool removeAlias(const std::string& aliasName);
+    
+    // Replace the command of a managed alias
+    // Returns: true if the alias was found and updated
+    bool updateAlias(const std::string& aliasName, const std::string& newCommand);
+    
+    // Rename a managed alias, keeping its place and command
+    // Returns: true if the alias was found and the new name was not taken
+    bool renameAlias(const std::string& oldName, const std::string& newName);
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    // --------------------------------------------------------------------------
+    // Private Methods
+    // --------------------------------------------------------------------------
+    
+    // Locate the bytes between the marker lines of content
+    // Returns: false if the block is malformed; found tells whether it exists
+    static bool findBlock(std::string_view content, size_t& begin, size_t& end, bool& found);
+    
+    // Rewrite the owned region of path under its writer lock: the whole file,
+    // or the marker block if delimited (appended when missing). produce gets
+    // the current region and sets its replacement; an unchanged region is
+    // not written
+    bool replaceRegion(const std::string& path, bool delimited,
+                       const std::function<bool(std::string_view, std::string&)>& produce);
+    
+    // Parse and edit the managed aliases, then write them back
+    bool modify(const std::function<bool(std::vector<Alias>&)>& change);
+    
+    // Managed aliases defined in region (a redefinition keeps the first place)
+    std::vector<Alias> parseRegion(std::string_view region) const;
+    
+    // Region text for aliases
+    std::string render(const std::vector<Alias>& aliases) const;
+    
+    // rc file line that sources the sidecar file
+    std::string sourceLine() const;
+    
+    // --------------------------------------------------------------------------
+    // Member Variables
+    // --------------------------------------------------------------------------
+    
+    std::string rcPath;             // Shell configuration file
+    std::string sidecarPath;        // Sidecar file (Sidecar storage)
+    ShellDetector::Shell shell;     // Shell type for syntax handling
+    Storage storage;                // Where the aliases live
+    AliasManager aliasManager;      // Formatter for this shell
+    std::string lastError;          // Last error message
+};
+
+#endif // MANAGEDALIASES_HPP
@@ -0,0 +1,210 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Mapped File Component Implementation
+//
+// This file implements the MappedFile class. The mapping is private and
+// read-only. Writers in this project replace files rather than truncating
+// them in place, so a mapping never sees the file shrink under it.
+// ------------------------------------------------------------------------------
+
+#include "mappedfile.hpp"
+#include <cerrno>        // For errno
+#include <cstring>       // For std::memchr, std::strerror
+#include <fcntl.h>       // For open
+#include <sys/mman.h>    // For mmap, madvise, munmap
+#include "syscalls.hpp"  // Counted open, fstat
+#include <unistd.h>      // For read, pread, close
+#include <utility>       // For std::move
+
+// Chunk size for the read() fallback
+static constexpr size_t kReadChunk = 64 * 1024;
+
+// ------------------------------------------------------------------------------
+// Destructor and Moves
+// ------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        
+        // A moved small string does not keep its address, so a view over
+        // the buffer is re-pointed rather than copied
+        const bool fromBuffer = other.mapping == nullptr;
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        buffer = std::move(other.buffer);
+        content = fromBuffer ? std::string_view(buffer) : other.content;
+        lineStarts = std::move(other.lineStarts);
+        indexed = other.indexed;
+        lastError = std::move(other.lastError);
+        
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.content = {};
+        other.indexed = false;
+    }
+    return *this;
+}
+
+// ------------------------------------------------------------------------------
+// Open a File by Path
+// ------------------------------------------------------------------------------
+bool MappedFile::open(const std::string& path, bool populate) {
+    close();
+    
+    int fd = syscalls::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        lastError = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    bool ok = open(fd, populate);
+    ::close(fd);
+    if (!ok) {
+        lastError = path + ": " + lastError;
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Open a Descriptor
+// Regular, non-empty files are mapped; anything else is read with read()
+// ------------------------------------------------------------------------------
+bool MappedFile::open(int fd, bool populate) {
+    close();
+    
+    struct stat sb;
+    if (syscalls::fstat(fd, &sb) != 0) {
+        lastError = std::string("Cannot stat file: ") + std::strerror(errno);
+        return false;
+    }
+    return load(fd, S_ISREG(sb.st_mode), static_cast<size_t>(sb.st_size), populate);
+}
+
+// ------------------------------------------------------------------------------
+// Open a Regular File Descriptor Without Stat
+// ------------------------------------------------------------------------------
+bool MappedFile::openRegular(int fd, size_t size, bool populate) {
+    close();
+    return load(fd, true, size, populate);
+}
+
+// ------------------------------------------------------------------------------
+// Map or Read the Content of fd
+// ------------------------------------------------------------------------------
+bool MappedFile::load(int fd, bool regular, size_t size, bool populate) {
+    // Regular file: map it
+    if (regular && size > 0) {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if (populate) flags |= MAP_POPULATE;
+#endif
+        void* base = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        if (base != MAP_FAILED) {
+            madvise(base, size, MADV_SEQUENTIAL);
+            mapping = base;
+            mappingSize = size;
+            content = std::string_view(static_cast<const char*>(base), size);
+            return true;
+        }
+        // Mapping refused (e.g. some network filesystems): read it instead
+    }
+    
+    // Pipes, character devices, empty or unmappable files
+    if (regular) {
+        buffer.reserve(size);
+    }
+    for (off_t at = 0;;) {
+        const size_t used = buffer.size();
+        buffer.resize(used + kReadChunk);
+        
+        // Regular files are read from the start whatever the fd position is
+        ssize_t n = regular ? ::pread(fd, buffer.data() + used, kReadChunk, at)
+                            : ::read(fd, buffer.data() + used, kReadChunk);
+        if (n < 0 && errno == EINTR) {
+            buffer.resize(used);
+            continue;
+        }
+        if (n <= 0) {
+            buffer.resize(used);
+            if (n < 0) {
+                lastError = std::string("Cannot read file: ") + std::strerror(errno);
+                buffer.clear();
+                return false;
+            }
+            break;
+        }
+        buffer.resize(used + static_cast<size_t>(n));
+        at += n;
+    }
+    
+    content = buffer;
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Close
+// ------------------------------------------------------------------------------
+void MappedFile::close() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+    buffer.clear();
+    content = {};
+    lineStarts.clear();
+    indexed = false;
+}
+
+// ------------------------------------------------------------------------------
+// Line Index
+// lineStarts holds the start of every line followed by one sentinel: the
+// offset just past the newline that would end the last line, so that line
+// i always spans [lineStarts[i], lineStarts[i + 1] - 1)
+// ------------------------------------------------------------------------------
+void MappedFile::ensureLineIndex() {
+    if (indexed) return;
+    
+    const char* data = content.data();
+    const size_t size = content.size();
+    
+    lineStarts.clear();
+    lineStarts.push_back(0);
+    size_t pos = 0;
+    while (pos < size) {
+        const void* nl = std::memchr(data + pos, '\n', size - pos);
+        if (nl == nullptr) break;
+        pos = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+        lineStarts.push_back(pos);
+    }
+    
+    // Unterminated last line: add the sentinel of its missing newline
+    if (lineStarts.back() != size) {
+        lineStarts.push_back(size + 1);
+    }
+    indexed = true;
+}
+
+size_t MappedFile::lineCount() {
+    ensureLineIndex();
+    return lineStarts.size() - 1;
+}
+
+std::string_view MappedFile::line(size_t i) {
+    ensureLineIndex();
+    return content.substr(lineStarts[i], lineStarts[i + 1] - 1 - lineStarts[i]);
+}
+
+size_t MappedFile::lineOffset(size_t i) {
+    ensureLineIndex();
+    return lineStarts[i];
+}
@@ -0,0 +1,94 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Mapped File Component Header
+//
+// This header defines the MappedFile class, a read-only, zero-copy view of a
+// file. Regular files are mapped with mmap and advised for sequential
+// access; pipes and other special files are read into an owned buffer
+// instead, so callers always see one contiguous string_view. A line index
+// (byte offset of every line start) can be built over the view on demand.
+// ------------------------------------------------------------------------------
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MappedFile {
+public:
+    // --------------------------------------------------------------------------
+    // Constructor & Destructor
+    // --------------------------------------------------------------------------
+    
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    // --------------------------------------------------------------------------
+    // Opening and Closing
+    // --------------------------------------------------------------------------
+    
+    // Map (or read) the file at path, replacing any previous content
+    // populate: prefault the whole mapping (MAP_POPULATE) when it will
+    // be read entirely anyway
+    // Returns: true on success; getLastError describes failures
+    bool open(const std::string& path, bool populate = false);
+    
+    // Same for an already open descriptor, which stays owned by the caller
+    bool open(int fd, bool populate = false);
+    
+    // Same for a descriptor the caller already knows to be a regular file
+    // of size bytes (from its own stat), saving the fstat
+    bool openRegular(int fd, size_t size, bool populate = false);
+    
+    // Release the mapping or buffer
+    void close();
+    
+    // Check whether the content comes from mmap (false for read() fallback)
+    bool isMapped() const { return mapping != nullptr; }
+    
+    // --------------------------------------------------------------------------
+    // Content Access
+    // --------------------------------------------------------------------------
+    
+    // Whole file content; valid until close, open or destruction
+    std::string_view view() const { return content; }
+    size_t size() const { return content.size(); }
+    
+    // Number of lines (a trailing newline does not start an extra line)
+    size_t lineCount();
+    
+    // Line i without its newline
+    std::string_view line(size_t i);
+    
+    // Byte offset of the start of line i
+    size_t lineOffset(size_t i);
+    
+    // Get the last error message
+    std::string getLastError() const { return lastError; }
+
+private:
+    // Map fd (size bytes) or read it to the end into the buffer
+    bool load(int fd, bool regular, size_t size, bool populate);
+    
+    // Build the line index if it has not been built yet
+    void ensureLineIndex();
+    
+    void* mapping = nullptr;              // mmap base, or nullptr
+    size_t mappingSize = 0;               // Length passed to mmap
+    std::string buffer;                   // Content read by the fallback path
+    std::string_view content;             // View over mapping or buffer
+    std::vector<size_t> lineStarts;       // Line start offsets + end sentinel
+    bool indexed = false;                 // lineStarts is up to date
+    std::string lastError;                // Last error message
+};
+
+#endif // MAPPEDFILE_HPP
@@ -12,7 +12,6 @@
 
 #include "shelldetector.hpp"
 #include <cstdlib>       // For std::getenv
-#include <utility>       // For std::pair
 #include <filesystem>    // For filesystem operations
 #include <fstream>       // For file reading
 #include <iostream>      // For debugging output
@@ -116,21 +115,12 @@ ShellDetector::Shell ShellDetector::detectFromEnvironment() {
 // Useful when shell is started without version variables
 // ------------------------------------------------------------------------------
 ShellDetector::Shell ShellDetector::detectFromConfigFiles() {
-    std::string home = expandHome("~");
-    
-    // List of shells and their configuration files to check
-    // Ordered by popularity/reliability
-    constexpr std::pair<Shell, std::string_view> configs[] = {
-        {Shell::BASH, BASHRC},
-        {Shell::ZSH, ZSHRC},
-        {Shell::FISH, FISH_CONFIG}
-    };
+    // List of shells to check, ordered by popularity/reliability
+    constexpr Shell shells[] = {Shell::BASH, Shell::ZSH, Shell::FISH};
     
-    for (const auto& [shell, config] : configs) {
-        std::string configPath = home + "/" + std::string(config);
-        
+    for (Shell shell : shells) {
         // Check if config file exists and is readable
-        if (fs::exists(configPath)) {
+        if (fs::exists(getConfigFilePath(shell))) {
             return shell;
         }
     }
@@ -263,24 +253,46 @@ std::string ShellDetector::getConfigFilePath(Shell shell) {
             // BASH can use multiple files, default to .bashrc
             // Could check for .bash_profile or .bash_aliases
             return home + "/" + std::string(BASHRC);
-            
+        
         case Shell::ZSH:
-            // ZSH typically uses .zshrc
-            return home + "/" + std::string(ZSHRC);
-            
+            // ZSH typically uses .zshrc, in $ZDOTDIR when that is set
+            return getZshConfigDir() + "/" + std::string(ZSHRC);
+        
         case Shell::FISH:
-            // FISH uses config.fish in .config/fish directory
-            return home + "/" + std::string(FISH_CONFIG);
-            
+            // FISH uses config.fish in its XDG configuration directory
+            return getFishConfigDir() + "/" + std::string(FISH_CONFIG);
+        
         case Shell::UNKNOWN:
             return "";  // Empty string for unknown shell
-            
+        
         default:
             // Should never reach here, but include for completeness
             return "";
     }
 }
 
+// ------------------------------------------------------------------------------
+// ZSH Startup File Directory
+// $ZDOTDIR when set, otherwise the home directory
+// ------------------------------------------------------------------------------
+std::string ShellDetector::getZshConfigDir() {
+    if (const char* zdotdir = std::getenv("ZDOTDIR"); zdotdir != nullptr && zdotdir[0] == '/') {
+        return zdotdir;
+    }
+    return expandHome("~");
+}
+
+// ------------------------------------------------------------------------------
+// FISH Configuration Directory
+// $XDG_CONFIG_HOME/fish when set, otherwise ~/.config/fish
+// ------------------------------------------------------------------------------
+std::string ShellDetector::getFishConfigDir() {
+    if (const char* xdg = std::getenv("XDG_CONFIG_HOME"); xdg != nullptr && xdg[0] == '/') {
+        return std::string(xdg) + "/fish";
+    }
+    return expandHome("~") + "/.config/fish";
+}
+
 // ------------------------------------------------------------------------------
 // Get Shell Name as String
 // Converts Shell enum to human-readable name
@@ -70,13 +70,20 @@ public:
     // Returns: Expanded path with ~ replaced by home directory
     static std::string expandHome(const std::string& path);
     
+    // Directory holding the ZSH startup files ($ZDOTDIR, default ~)
+    static std::string getZshConfigDir();
+    
+    // FISH configuration directory ($XDG_CONFIG_HOME/fish, default
+    // ~/.config/fish), home of config.fish and conf.d
+    static std::string getFishConfigDir();
+
 private:
     // --------------------------------------------------------------------------
     // Configuration File Names (Private Constants)
     // --------------------------------------------------------------------------
     static constexpr std::string_view BASHRC = ".bashrc";
     static constexpr std::string_view ZSHRC = ".zshrc";
-    static constexpr std::string_view FISH_CONFIG = ".config/fish/config.fish";
+    static constexpr std::string_view FISH_CONFIG = "config.fish";
 };
 
 #endif // SHELLDETECTOR_HPP
\ No newline at end of file
@@ -0,0 +1,127 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: SIMD Block Helpers Header
+//
+// This header provides a tiny abstraction over byte-block comparisons used by
+// the text scanning code. A block is 32 bytes with AVX2, 16 bytes with SSE2,
+// and 16 bytes processed by a plain loop otherwise. Comparisons (equality,
+// and inRange for ASCII ranges; bytes >= 0x80 are never in range) return a
+// bit mask with one bit per byte, so callers can be written once for all
+// targets.
+// ------------------------------------------------------------------------------
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+// Bit mask with one bit per byte of a block (bit i = byte i)
+using Mask = uint32_t;
+
+#if defined(__AVX2__)
+
+// --------------------------------------------------------------------------
+// AVX2: 32-byte blocks
+// --------------------------------------------------------------------------
+inline constexpr size_t kBlockSize = 32;
+
+struct Block {
+    __m256i v;
+};
+
+inline Block load(const char* p) {
+    return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+}
+
+inline Mask eq(Block b, char c) {
+    return static_cast<Mask>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(b.v, _mm256_set1_epi8(c))));
+}
+
+inline Mask inRange(Block b, char lo, char hi) {
+    __m256i above = _mm256_cmpgt_epi8(b.v, _mm256_set1_epi8(static_cast<char>(lo - 1)));
+    __m256i below = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), b.v);
+    return static_cast<Mask>(_mm256_movemask_epi8(_mm256_and_si256(above, below)));
+}
+
+#elif defined(__SSE2__)
+
+// --------------------------------------------------------------------------
+// SSE2: 16-byte blocks
+// --------------------------------------------------------------------------
+inline constexpr size_t kBlockSize = 16;
+
+struct Block {
+    __m128i v;
+};
+
+inline Block load(const char* p) {
+    return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+}
+
+inline Mask eq(Block b, char c) {
+    return static_cast<Mask>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(b.v, _mm_set1_epi8(c))));
+}
+
+inline Mask inRange(Block b, char lo, char hi) {
+    __m128i above = _mm_cmpgt_epi8(b.v, _mm_set1_epi8(static_cast<char>(lo - 1)));
+    __m128i below = _mm_cmplt_epi8(b.v, _mm_set1_epi8(static_cast<char>(hi + 1)));
+    return static_cast<Mask>(_mm_movemask_epi8(_mm_and_si128(above, below)));
+}
+
+#else
+
+// --------------------------------------------------------------------------
+// Scalar fallback: 16-byte blocks compared one byte at a time
+// --------------------------------------------------------------------------
+inline constexpr size_t kBlockSize = 16;
+
+struct Block {
+    const char* p;
+};
+
+inline Block load(const char* p) {
+    return {p};
+}
+
+inline Mask eq(Block b, char c) {
+    Mask m = 0;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        m |= static_cast<Mask>(b.p[i] == c) << i;
+    }
+    return m;
+}
+
+inline Mask inRange(Block b, char lo, char hi) {
+    Mask m = 0;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        m |= static_cast<Mask>(b.p[i] >= lo && b.p[i] <= hi) << i;
+    }
+    return m;
+}
+
+#endif
+
+// Mask with the low n bits set (n <= kBlockSize)
+inline constexpr Mask lowBits(size_t n) {
+    return n >= 32 ? ~Mask(0) : ((Mask(1) << n) - 1);
+}
+
+// Index of the lowest set bit (mask must be non-zero)
+inline int firstBit(Mask m) {
+    return std::countr_zero(m);
+}
+
+} // namespace simd
+
+#endif // SIMD_HPP
@@ -0,0 +1,124 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Counted Filesystem Calls Header
+//
+// This header wraps the filesystem metadata calls the file components make
+// (open, stat, chmod, lock, link, rename, extended attributes). Each wrapper
+// bumps a per-thread counter before making the call, so an operation's cost
+// in metadata round trips, the expensive part on network home directories,
+// can be measured and kept fixed. Data transfer (read, write, mmap, fsync)
+// and close are not counted.
+// ------------------------------------------------------------------------------
+
+#ifndef SYSCALLS_HPP
+#define SYSCALLS_HPP
+
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+
+namespace syscalls {
+
+// Metadata calls made by the current thread
+inline thread_local uint64_t calls = 0;
+
+// Number of counted calls this thread has made so far
+inline uint64_t count() {
+    return calls;
+}
+
+// ------------------------------------------------------------------------------
+// Class: Tally
+// Purpose: Stores the number of calls made during its lifetime in out.
+// ------------------------------------------------------------------------------
+class Tally {
+public:
+    explicit Tally(uint64_t& out) : out(out), start(calls) {}
+    ~Tally() { out = calls - start; }
+    
+    Tally(const Tally&) = delete;
+    Tally& operator=(const Tally&) = delete;
+
+private:
+    uint64_t& out;
+    uint64_t start;
+};
+
+// ------------------------------------------------------------------------------
+// Wrappers
+// ------------------------------------------------------------------------------
+
+inline int open(const char* path, int flags, mode_t mode = 0) {
+    ++calls;
+    return ::open(path, flags, mode);
+}
+
+inline int openat(int dirFd, const char* path, int flags, mode_t mode = 0) {
+    ++calls;
+    return ::openat(dirFd, path, flags, mode);
+}
+
+inline int fstat(int fd, struct stat* st) {
+    ++calls;
+    return ::fstat(fd, st);
+}
+
+inline int fstatat(int dirFd, const char* path, struct stat* st, int flags) {
+    ++calls;
+    return ::fstatat(dirFd, path, st, flags);
+}
+
+inline int fchmod(int fd, mode_t mode) {
+    ++calls;
+    return ::fchmod(fd, mode);
+}
+
+inline int fchown(int fd, uid_t owner, gid_t group) {
+    ++calls;
+    return ::fchown(fd, owner, group);
+}
+
+inline int flock(int fd, int operation) {
+    ++calls;
+    return ::flock(fd, operation);
+}
+
+inline int linkat(int oldDirFd, const char* oldPath, int newDirFd, const char* newPath,
+                  int flags) {
+    ++calls;
+    return ::linkat(oldDirFd, oldPath, newDirFd, newPath, flags);
+}
+
+inline int renameat(int oldDirFd, const char* oldPath, int newDirFd, const char* newPath) {
+    ++calls;
+    return ::renameat(oldDirFd, oldPath, newDirFd, newPath);
+}
+
+inline int unlinkat(int dirFd, const char* path, int flags) {
+    ++calls;
+    return ::unlinkat(dirFd, path, flags);
+}
+
+inline ssize_t flistxattr(int fd, char* list, size_t size) {
+    ++calls;
+    return ::flistxattr(fd, list, size);
+}
+
+inline ssize_t fgetxattr(int fd, const char* name, void* value, size_t size) {
+    ++calls;
+    return ::fgetxattr(fd, name, value, size);
+}
+
+inline int fsetxattr(int fd, const char* name, const void* value, size_t size, int flags) {
+    ++calls;
+    return ::fsetxattr(fd, name, value, size, flags);
+}
+
+} // namespace syscalls
+
+#endif // SYSCALLS_HPP
@@ -0,0 +1,119 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Thread Pool Component Implementation
+//
+// This file implements the ThreadPool class. parallelFor hands out loop
+// indices through a shared atomic counter, so uneven chunks balance
+// themselves, and it blocks on a latch until every participant is done.
+// ------------------------------------------------------------------------------
+
+#include "threadpool.hpp"
+#include <algorithm>   // For std::min
+#include <atomic>      // Shared loop index
+#include <exception>   // For std::exception_ptr
+#include <latch>       // Completion barrier for parallelFor
+
+// ------------------------------------------------------------------------------
+// Constructor
+// Starts threads - 1 workers; the thread calling parallelFor is the last one
+// ------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Destructor
+// ------------------------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Worker Loop
+// Runs tasks until the pool is stopped and the queue is empty
+// ------------------------------------------------------------------------------
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;  // Stopping and nothing left to do
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Parallel Loop
+// ------------------------------------------------------------------------------
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    
+    // Helpers beyond the calling thread (never more than there are indices)
+    const size_t helpers = std::min(workers.size(), count - 1);
+    
+    std::atomic<size_t> next{0};
+    std::latch done(static_cast<std::ptrdiff_t>(helpers + 1));
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    
+    auto participate = [&] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+        done.count_down();
+    };
+    
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < helpers; ++i) {
+                tasks.emplace_back(participate);
+            }
+        }
+        available.notify_all();
+    }
+    
+    participate();
+    done.wait();
+    
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Shared Pool
+// ------------------------------------------------------------------------------
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,64 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: Thread Pool Component Header
+//
+// This header defines a small fixed-size thread pool for data-parallel work
+// such as parsing large configuration files in chunks. Work is submitted as
+// an indexed loop; the calling thread takes part in the loop and returns
+// once every index has been processed.
+// ------------------------------------------------------------------------------
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // --------------------------------------------------------------------------
+    // Constructor & Destructor
+    // --------------------------------------------------------------------------
+    
+    // Start a pool able to run threads loop bodies at once (the caller of
+    // parallelFor counts as one); 0 uses the hardware concurrency
+    explicit ThreadPool(size_t threads = 0);
+    
+    // Finish queued work and join all workers
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // --------------------------------------------------------------------------
+    // Work Submission
+    // --------------------------------------------------------------------------
+    
+    // Number of loop bodies that can run at once
+    size_t size() const { return workers.size() + 1; }
+    
+    // Call fn(i) for every i in [0, count) across the pool and wait
+    // The first exception thrown by fn is rethrown to the caller
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+    
+    // Process-wide pool sized to the hardware, created on first use
+    static ThreadPool& shared();
+
+private:
+    // Worker thread main loop
+    void workerLoop();
+    
+    std::vector<std::thread> workers;           // Worker threads
+    std::deque<std::function<void()>> tasks;    // Pending tasks
+    std::mutex mutex;                           // Guards tasks and stopping
+    std::condition_variable available;          // Signals new tasks or stop
+    bool stopping = false;                      // Set by the destructor
+};
+
+#endif // THREADPOOL_HPP
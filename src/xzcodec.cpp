@@ -0,0 +1,229 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: XZ Codec Component Implementation
+//
+// This file implements the XzCodec class on top of liblzma's stream API.
+// Both directions share one loop: refill the input buffer with read(),
+// run lzma_code, and hand the output buffer to the sink whenever it is
+// full or the stream has ended. Compressed streams use a single LZMA2
+// filter and a CRC64 check, matching what xz writes by default.
+// ------------------------------------------------------------------------------
+
+#include "xzcodec.hpp"
+#include "atomicwriter.hpp"  // Crash-safe output files
+#include <algorithm>         // For std::clamp, std::min, std::max
+#include <cerrno>            // For errno
+#include <cstring>           // For std::strerror
+#include <fcntl.h>           // For open
+#include <filesystem>        // Path splitting
+#include <lzma.h>            // liblzma stream API
+#include <memory>            // For std::unique_ptr
+#include <sys/stat.h>        // For fstat, futimens
+#include <unistd.h>          // For read, close
+
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------
+// Utility: Describe a liblzma Result
+// ------------------------------------------------------------------------------
+static std::string lzmaText(lzma_ret ret) {
+    switch (ret) {
+        case LZMA_MEM_ERROR:         return "out of memory";
+        case LZMA_MEMLIMIT_ERROR:    return "memory limit reached";
+        case LZMA_FORMAT_ERROR:      return "not in .xz format";
+        case LZMA_OPTIONS_ERROR:     return "unsupported options";
+        case LZMA_DATA_ERROR:        return "compressed data is corrupt";
+        case LZMA_BUF_ERROR:         return "compressed data is truncated";
+        case LZMA_UNSUPPORTED_CHECK: return "unsupported integrity check";
+        default:                     return "liblzma error " + std::to_string(static_cast<int>(ret));
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Utility: Run a Coder over a Descriptor
+// Reads inFd to the end, finishing the stream at end of input, and passes
+// every full output buffer (and the last partial one) to sink
+// ------------------------------------------------------------------------------
+static bool pumpStream(lzma_stream& stream, int inFd, const XzCodec::Sink& sink,
+                       std::string& error) {
+    const size_t size = XzCodec::kBufferSize;
+    std::unique_ptr<uint8_t[]> in(new uint8_t[size]);
+    std::unique_ptr<uint8_t[]> out(new uint8_t[size]);
+    
+    lzma_action action = LZMA_RUN;
+    stream.next_out = out.get();
+    stream.avail_out = size;
+    for (;;) {
+        if (stream.avail_in == 0 && action == LZMA_RUN) {
+            ssize_t n = read(inFd, in.get(), size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error = std::string("Cannot read input: ") + std::strerror(errno);
+                return false;
+            }
+            stream.next_in = in.get();
+            stream.avail_in = static_cast<size_t>(n);
+            if (n == 0) {
+                action = LZMA_FINISH;
+            }
+        }
+        
+        const lzma_ret ret = lzma_code(&stream, action);
+        if (stream.avail_out == 0 || ret == LZMA_STREAM_END) {
+            const size_t produced = size - stream.avail_out;
+            if (produced > 0 &&
+                !sink(std::string_view(reinterpret_cast<const char*>(out.get()), produced))) {
+                error = "Cannot write output";
+                return false;
+            }
+            stream.next_out = out.get();
+            stream.avail_out = size;
+        }
+        if (ret == LZMA_STREAM_END) {
+            return true;
+        }
+        if (ret != LZMA_OK) {
+            error = lzmaText(ret);
+            return false;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Constructor
+// ------------------------------------------------------------------------------
+XzCodec::XzCodec(int level, bool extreme)
+    : level(std::clamp(level, 0, kMaxLevel)), extreme(extreme) {
+}
+
+// ------------------------------------------------------------------------------
+// Compress a Stream
+// ------------------------------------------------------------------------------
+bool XzCodec::compress(int inFd, const Sink& sink, uint64_t sizeHint) {
+    lzma_options_lzma options;
+    const uint32_t preset = static_cast<uint32_t>(level) | (extreme ? LZMA_PRESET_EXTREME : 0);
+    if (lzma_lzma_preset(&options, preset)) {
+        lastError = "Unsupported compression level " + std::to_string(level);
+        return false;
+    }
+    
+    // A dictionary beyond the input size only costs memory
+    if (sizeHint > 0) {
+        options.dict_size = static_cast<uint32_t>(std::max<uint64_t>(
+            LZMA_DICT_SIZE_MIN, std::min<uint64_t>(options.dict_size, sizeHint)));
+    }
+    
+    lzma_filter filters[] = {
+        {LZMA_FILTER_LZMA2, &options},
+        {LZMA_VLI_UNKNOWN, nullptr},
+    };
+    lzma_stream stream = LZMA_STREAM_INIT;
+    lzma_ret ret = lzma_stream_encoder(&stream, filters, LZMA_CHECK_CRC64);
+    if (ret != LZMA_OK) {
+        lastError = "Cannot start compression: " + lzmaText(ret);
+        return false;
+    }
+    
+    std::string error;
+    const bool ok = pumpStream(stream, inFd, sink, error);
+    lzma_end(&stream);
+    if (!ok) {
+        lastError = "Compression failed: " + error;
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Decompress a Stream
+// ------------------------------------------------------------------------------
+bool XzCodec::decompress(int inFd, const Sink& sink) {
+    lzma_stream stream = LZMA_STREAM_INIT;
+    lzma_ret ret = lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED);
+    if (ret != LZMA_OK) {
+        lastError = "Cannot start decompression: " + lzmaText(ret);
+        return false;
+    }
+    
+    std::string error;
+    const bool ok = pumpStream(stream, inFd, sink, error);
+    lzma_end(&stream);
+    if (!ok) {
+        lastError = "Decompression failed: " + error;
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Compress a File
+// The output takes its metadata from the open source file, and gets the
+// source's times before it is published
+// ------------------------------------------------------------------------------
+bool XzCodec::compressFile(const std::string& source, const std::string& target) {
+    int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (in < 0 || fstat(in, &st) != 0) {
+        lastError = "Cannot open " + source + ": " + std::strerror(errno);
+        if (in >= 0) close(in);
+        return false;
+    }
+    
+    fs::path dir = fs::path(target).parent_path();
+    if (dir.empty()) dir = ".";
+    int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        lastError = "Cannot open directory " + dir.string() + ": " + std::strerror(errno);
+        close(in);
+        return false;
+    }
+    
+    bool ok = false;
+    {
+        AtomicWriter writer(dirFd, fs::path(target).filename().string(), in);
+        if (!writer.open()) {
+            lastError = writer.getLastError();
+        } else if (compress(in, [&writer](std::string_view data) { return writer.write(data); },
+                            static_cast<uint64_t>(st.st_size))) {
+            const struct timespec times[2] = {st.st_atim, st.st_mtim};
+            futimens(writer.fd(), times);
+            ok = writer.commit();
+            if (!ok) {
+                lastError = writer.getLastError();
+            }
+        }
+    }
+    close(dirFd);
+    close(in);
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Decompress a File
+// ------------------------------------------------------------------------------
+bool XzCodec::decompressFile(const std::string& source, const std::string& target) {
+    int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        lastError = "Cannot open " + source + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    AtomicWriter writer(target);
+    bool ok = writer.open();
+    if (!ok) {
+        lastError = writer.getLastError();
+    } else if ((ok = decompress(in, [&writer](std::string_view data) { return writer.write(data); }))) {
+        ok = writer.commit();
+        if (!ok) {
+            lastError = writer.getLastError();
+        }
+    }
+    close(in);
+    return ok;
+}
+
+// ------------------------------------------------------------------------------
+// Get Last Error Message
+// ------------------------------------------------------------------------------
+std::string XzCodec::getLastError() const {
+    return lastError;
+}
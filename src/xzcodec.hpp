@@ -0,0 +1,77 @@
+// ------------------------------------------------------------------------------
+// Program Name: AliaCan
+// Creator: Xzrayツ
+// Description: XZ Codec Component Header
+//
+// This header defines the XzCodec class, which compresses and decompresses
+// .xz data in-process with liblzma. Data is streamed through two fixed
+// buffers, so memory use does not grow with the input, and no shell or
+// external xz binary is involved. Output is standard .xz that the xz
+// command line tool reads and writes too.
+// ------------------------------------------------------------------------------
+
+#ifndef XZCODEC_HPP
+#define XZCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class XzCodec {
+public:
+    // Highest compression level (as xz -9)
+    static constexpr int kMaxLevel = 9;
+    
+    // Size of the input and output buffers
+    static constexpr size_t kBufferSize = size_t(64) << 10;
+    
+    // Receives output in order; returns false to stop with an error
+    using Sink = std::function<bool(std::string_view)>;
+    
+    // --------------------------------------------------------------------------
+    // Constructor
+    // --------------------------------------------------------------------------
+    
+    // level: 0 (fastest) to kMaxLevel (smallest), clamped
+    // extreme: spend more time for slightly smaller output (as xz -e)
+    explicit XzCodec(int level = kMaxLevel, bool extreme = true);
+    
+    // --------------------------------------------------------------------------
+    // Streaming
+    // --------------------------------------------------------------------------
+    
+    // Compress everything readable from inFd into one .xz stream
+    // sizeHint: input size when known (0 if not). The dictionary is not
+    // made larger than the input, which bounds memory for small files
+    // without changing the output size
+    // Returns: true once the whole stream has been passed to sink
+    bool compress(int inFd, const Sink& sink, uint64_t sizeHint = 0);
+    
+    // Decompress the .xz data readable from inFd (concatenated streams too)
+    // Returns: true if the input was complete and intact
+    bool decompress(int inFd, const Sink& sink);
+    
+    // --------------------------------------------------------------------------
+    // Files
+    // --------------------------------------------------------------------------
+    
+    // Write source compressed to target (replaced atomically). Like xz, the
+    // mode, owner and modification time of source are carried over
+    bool compressFile(const std::string& source, const std::string& target);
+    
+    // Write source decompressed to target (replaced atomically, keeping
+    // the mode and owner of an existing target)
+    bool decompressFile(const std::string& source, const std::string& target);
+    
+    // Get the last error message for debugging
+    std::string getLastError() const;
+
+private:
+    int level;                  // Preset level 0-9
+    bool extreme;               // Extreme preset variant
+    std::string lastError;      // Last error message
+};
+
+#endif // XZCODEC_HPP
@@ -10,7 +10,11 @@
 // including shell detection, alias management, and configuration handling.
 // ------------------------------------------------------------------------------
 
+#include <cstdlib>       // For setenv
+#include <filesystem>    // Private cache directory
 #include <iostream>
+#include <string>
+#include <unistd.h>      // For getpid
 
 // Forward declarations of test functions from other test modules.
 // Each function tests a specific component of the AliaCan system.
@@ -25,6 +29,14 @@ int main() {
     std::cout << "AliaCan Test Suite v0.0.1.1" << std::endl;
     std::cout << "========================================" << std::endl << std::endl;
     
+    // Loads write parse cache entries and edits create lock files; keep
+    // them out of the user's real cache and runtime directories
+    const std::filesystem::path scratchDir = std::filesystem::temp_directory_path() /
+        ("alia-can-test-env-" + std::to_string(getpid()));
+    std::filesystem::create_directories(scratchDir);
+    setenv("XDG_CACHE_HOME", scratchDir.c_str(), 1);
+    setenv("XDG_RUNTIME_DIR", scratchDir.c_str(), 1);
+    
     // Execute shell detector tests.
     // This component identifies the user's current shell (bash, zsh, fish, etc.)
     // and determines the appropriate alias file location.
@@ -46,6 +58,8 @@ int main() {
     test_confighandler();
     std::cout << "[TEST] ConfigHandler tests completed." << std::endl << std::endl;
     
+    std::filesystem::remove_all(scratchDir);
+    
     // Display test suite completion summary.
     std::cout << "========================================" << std::endl;
     std::cout << "All tests completed successfully!" << std::endl;
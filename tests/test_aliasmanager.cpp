@@ -12,8 +12,15 @@
 
 #include "aliasmanager.hpp"    // Main class under test
 #include "shelldetector.hpp"   // Shell types enum
+#include "linescanner.hpp"     // Bulk alias line detection
+#include "aliastokenizer.hpp"  // Table-driven statement tokenizer
+#include "aliasformatter.hpp"  // Shell-specialised formatter
+#include "aliastable.hpp"      // Arena-backed alias table
+#include "charclass.hpp"       // Shared byte classification tables
 #include <cassert>             // Assertion macros for test validation
+#include <cctype>              // Reference character classification
 #include <iostream>            // Console output for test reporting
+#include <random>              // Random inputs for escaping tests
 
 #include "utils.hpp"
 
@@ -44,6 +51,63 @@ static void testValidateAliasName() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Batch Alias Name Validation
+// Purpose: Verify the batch validator and the shared classification tables.
+// Tests:
+//   - Batch results match validateAliasName for every name, including
+//     every byte at every position around the SIMD block boundaries
+//   - Table bits match the classic ctype predicates for all 256 bytes
+// ------------------------------------------------------------------------------
+static void testValidateAliasNamesBatch() {
+    std::cout << "  Testing batch alias name validation... ";
+    
+    std::vector<std::string> storage = {
+        "ll", "git_log", "g123", "_start", "", "with space", "alias.ll",
+        "ll\n", "-x", "x-", "9lives", std::string(255, 'a'), std::string(256, 'a'),
+        "caf\xc3\xa9"
+    };
+    std::vector<std::string_view> names(storage.begin(), storage.end());
+    
+    std::vector<uint8_t> valid = AliasManager::validateAliasNames(names);
+    assert(valid.size() == names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        assert((valid[i] != 0) == AliasManager::validateAliasName(names[i]));
+    }
+    assert(valid[0] && valid[9] && valid[10] && valid[11]);
+    assert(!valid[4] && !valid[8] && !valid[12] && !valid[13]);
+    
+    // One byte varied at a time, at the start, middle and end of full and
+    // partial blocks
+    storage.clear();
+    for (size_t len : {1, 2, 15, 16, 17, 31, 32, 33, 64, 255}) {
+        for (size_t pos : {size_t(0), len / 2, len - 1}) {
+            for (int c = 0; c < 256; ++c) {
+                std::string name(len, 'a');
+                name[pos] = static_cast<char>(c);
+                storage.push_back(std::move(name));
+            }
+        }
+    }
+    names.assign(storage.begin(), storage.end());
+    valid = AliasManager::validateAliasNames(names);
+    for (size_t i = 0; i < names.size(); ++i) {
+        assert((valid[i] != 0) == AliasManager::validateAliasName(names[i]));
+    }
+    
+    // Tables agree with the C locale predicates they replace
+    for (int c = 0; c < 256; ++c) {
+        char ch = static_cast<char>(c);
+        bool nameStart = (c < 128 && std::isalnum(c)) || c == '_';
+        assert(charclass::has(ch, charclass::kNameStart) == nameStart);
+        assert(charclass::has(ch, charclass::kNameChar) == (nameStart || c == '-'));
+        assert(charclass::has(ch, charclass::kEscape) == 
+               (charclass::kEscapedChars.find(ch) != std::string_view::npos));
+    }
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Test: Command Validation
 // Purpose: Ensure commands are valid and safe to execute.
@@ -172,6 +236,51 @@ static void testParseAliasLine() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Alias View Parsing
+// Purpose: Verify the zero-copy parser returns slices of the input line.
+// Tests:
+//   - Name and command point into the original buffer
+//   - Escapes are flagged and only resolved on materialization
+//   - Non-alias lines leave the view empty
+// ------------------------------------------------------------------------------
+static void testParseAliasView() {
+    std::cout << "  Testing alias view parsing... ";
+    
+    // Views must point into the parsed buffer
+    {
+        std::string line = "  alias ll='ls -la'";
+        AliasView v;
+        assert(AliasManager::parseAliasView(line, v));
+        assert(v.name == "ll");
+        assert(v.command == "ls -la");
+        assert(!v.hasEscapes);
+        assert(v.name.data() >= line.data() && 
+               v.name.data() < line.data() + line.size());
+        assert(v.command.data() >= line.data() && 
+               v.command.data() < line.data() + line.size());
+    }
+    
+    // Escaped commands are materialized on demand
+    {
+        AliasView v;
+        assert(AliasManager::parseAliasView("alias e=\"echo \\$HOME\"", v));
+        assert(v.hasEscapes);
+        assert(v.command == "echo \\$HOME");
+        assert(v.toAlias().command == "echo $HOME");
+    }
+    
+    // Non-alias lines
+    {
+        AliasView v;
+        assert(!AliasManager::parseAliasView("export X=1", v));
+        assert(v.empty());
+        assert(!AliasManager::parseAliasView("", v));
+    }
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Test: Alias Line Detection
 // Purpose: Identify valid alias definition lines.
@@ -199,6 +308,340 @@ static void testIsAliasLine() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Bulk Alias Line Scanning
+// Purpose: Verify the SIMD scanner agrees with the line-by-line reference.
+// Tests:
+//   - Indented, commented and non-alias lines
+//   - Lines spanning block boundaries and a missing trailing newline
+//   - Reported offsets and line numbers
+// ------------------------------------------------------------------------------
+static void testLineScanner() {
+    std::cout << "  Testing bulk alias line scanning... ";
+    
+    auto sameLines = [](const std::vector<LineRef>& a, const std::vector<LineRef>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].offset != b[i].offset || a[i].length != b[i].length ||
+                a[i].lineNumber != b[i].lineNumber) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    // Small hand-written file
+    {
+        std::string rc = "# alias no='x'\nalias ll='ls -la'\n\t  alias gs='git status'\n"
+                         "export X=1\n\n   \nalia\nalias";
+        auto lines = LineScanner::findAliasLines(rc);
+        assert(sameLines(lines, LineScanner::findAliasLinesScalar(rc)));
+        assert(lines.size() == 3);
+        assert(LineScanner::lineAt(rc, lines[0]) == "alias ll='ls -la'");
+        assert(lines[0].lineNumber == 2);
+        assert(lines[1].lineNumber == 3);
+        assert(LineScanner::lineAt(rc, lines[2]) == "alias");
+        assert(lines[2].lineNumber == 8);
+    }
+    
+    // Generated file with lines of every length around the block sizes
+    {
+        std::string rc;
+        for (size_t i = 0; i < 200; ++i) {
+            rc += std::string(i % 37, (i % 3) ? ' ' : 'x');
+            rc += (i % 2) ? "alias a" + std::to_string(i) + "='b'" : std::string("echo");
+            rc += std::string(i % 53, '-');
+            rc += '\n';
+        }
+        assert(sameLines(LineScanner::findAliasLines(rc), 
+                         LineScanner::findAliasLinesScalar(rc)));
+    }
+    
+    // Empty input
+    assert(LineScanner::findAliasLines("").empty());
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Alias Statement Tokenizer
+// Purpose: Verify the table-driven tokenizer for every supported shell.
+// Tests:
+//   - Multiple definitions per line and option flags (bash/zsh)
+//   - Backslash-newline continuations and line numbers
+//   - Fish 'alias name value' syntax with comments and escapes
+//   - Concatenated quoted words and query-only statements
+// ------------------------------------------------------------------------------
+static void testTokenizer() {
+    std::cout << "  Testing alias statement tokenizer... ";
+    
+    using Shell = ShellDetector::Shell;
+    
+    // Multiple definitions on one line
+    {
+        std::string rc = "alias a='x' b=\"y z\" c=plain\n";
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(Shell::BASH, rc, defs);
+        assert(defs.size() == 3);
+        assert(defs[0].view.name == "a" && defs[0].view.command == "x");
+        assert(defs[1].view.name == "b" && defs[1].view.command == "y z");
+        assert(defs[2].view.name == "c" && defs[2].view.command == "plain");
+        assert(rc.substr(defs[1].offset, defs[1].length) == "b=\"y z\"");
+    }
+    
+    // Flags and end-of-options marker
+    {
+        std::string rc = "alias -g G='| grep'\nalias -- ll='ls'\n";
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(Shell::ZSH, rc, defs);
+        assert(defs.size() == 2);
+        assert(defs[0].flags == "-g" && defs[0].view.name == "G");
+        assert(defs[0].view.command == "| grep");
+        assert(defs[1].flags == "--" && defs[1].view.name == "ll");
+    }
+    
+    // Continuations, comments and line numbers
+    {
+        std::string rc = "# alias no='x'\nexport X=1 \\\n  alias no2=x\n"
+                         "alias a='x' \\\n  b='y'\nalias c=ab\\\ncd\n";
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(Shell::BASH, rc, defs);
+        assert(defs.size() == 3);
+        assert(defs[0].view.name == "a" && defs[0].lineNumber == 4);
+        assert(defs[1].view.name == "b" && defs[1].lineNumber == 5);
+        assert(defs[2].view.name == "c" && defs[2].lineNumber == 6);
+        assert(defs[2].view.toAlias().command == "abcd");
+    }
+    
+    // Fish syntax
+    {
+        std::string rc = "alias ll 'ls -la'\nalias gs git status   # status\n"
+                         "alias x=y\nalias q 'it\\'s'\nalias lonely\n";
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(Shell::FISH, rc, defs);
+        assert(defs.size() == 4);
+        assert(defs[0].view.name == "ll" && defs[0].view.command == "ls -la");
+        assert(defs[1].view.name == "gs" && defs[1].view.command == "git status");
+        assert(defs[2].view.name == "x" && defs[2].view.command == "y");
+        assert(defs[3].view.toAlias().command == "it's");
+    }
+    
+    // Concatenated words, queries and unclosed quotes
+    {
+        std::string rc = "alias e='echo '\"hi\"\nalias ll\nalias ll 'ls'\nalias u='open";
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(Shell::BASH, rc, defs);
+        assert(defs.size() == 2);
+        assert(defs[0].view.hasQuotes);
+        assert(defs[0].view.toAlias().command == "echo hi");
+        assert(defs[1].view.name == "u" && defs[1].view.command == "open");
+    }
+    
+    // Single statement entry point stops at the end of the statement
+    {
+        std::string rc = "alias a='x' \\\n b='y'\nalias c='z'\n";
+        std::vector<AliasDefinition> defs;
+        size_t end = AliasTokenizer::tokenizeStatement(Shell::BASH, rc, 0, 1, defs);
+        assert(defs.size() == 2);
+        assert(rc.substr(end, 5) == "alias");
+    }
+    
+    // Line parser falls back to fish syntax
+    {
+        auto a = AliasManager::parseAliasLine("alias ll 'ls -la'");
+        assert(a.name == "ll");
+        assert(a.command == "ls -la");
+    }
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Escaping and Unescaping
+// Purpose: Verify the block-wise escape/unescape paths.
+// Tests:
+//   - Output matches a byte-by-byte reference on random inputs of many lengths
+//   - Round trip escape -> unescape restores the input
+//   - No-copy fast paths return the input itself
+// ------------------------------------------------------------------------------
+static void testEscaping() {
+    std::cout << "  Testing escaping and unescaping... ";
+    
+    // Byte-by-byte reference implementation
+    auto referenceEscape = [](std::string_view in) {
+        std::string out;
+        for (char c : in) {
+            if (c == '\'' || c == '"' || c == '\\' || c == '$' || 
+                c == '`' || c == '!' || c == '*' || c == '?') {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out;
+    };
+    
+    std::mt19937 rng(42);
+    const std::string alphabet = "ab -'\"\\$`!*?\n";
+    for (size_t len = 0; len < 100; ++len) {
+        std::string in;
+        for (size_t i = 0; i < len; ++i) {
+            in += alphabet[rng() % alphabet.size()];
+        }
+        
+        std::string escaped = AliasManager::escapeCommand(in);
+        assert(escaped == referenceEscape(in));
+        assert(escaped.size() == in.size() + AliasManager::countEscapes(in));
+        assert(AliasManager::unescapeString(escaped) == in);
+        
+        // Appending keeps existing content
+        std::string appended = "x=";
+        AliasManager::appendEscaped(appended, in);
+        assert(appended == "x=" + escaped);
+    }
+    
+    // Unescape rules: escaped chars, continuations, trailing backslash
+    assert(AliasManager::unescapeString("a\\$b\\\\c") == "a$b\\c");
+    assert(AliasManager::unescapeString("ls \\\n-la") == "ls -la");
+    assert(AliasManager::unescapeString("end\\") == "end\\");
+    
+    // Fast paths hand back the input without copying
+    {
+        std::string storage;
+        std::string_view plain = "ls -la";
+        assert(AliasManager::escapeCommand(plain, storage).data() == plain.data());
+        assert(AliasManager::unescapeString(plain, storage).data() == plain.data());
+        assert(AliasManager::escapeCommand("echo $HOME", storage) == "echo \\$HOME");
+        assert(AliasManager::unescapeString("echo \\$HOME", storage) == "echo $HOME");
+    }
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Batch Formatting
+// Purpose: Verify Formatter and formatAliasesInto.
+// Tests:
+//   - Batch output equals formatAlias per alias, one per line, for every shell
+//   - Invalid aliases are skipped and existing buffer content is kept
+//   - formattedSize matches the formatted length exactly
+// ------------------------------------------------------------------------------
+static void testFormatAliasesBatch() {
+    std::cout << "  Testing batch alias formatting... ";
+    
+    std::vector<Alias> aliases = {
+        {"ll", "ls -la", "", true, "", ""},
+        {"say", "echo 'hi' $USER", "", true, "", ""},
+        {"bad name", "ls", "", true, "", ""},     // Invalid name
+        {"empty", "", "", true, "", ""},          // Invalid command
+        {"glob", "ls *.txt \\ \"q\"", "", true, "", ""},
+    };
+    
+    for (auto shell : {ShellDetector::Shell::BASH, ShellDetector::Shell::ZSH,
+                       ShellDetector::Shell::FISH, ShellDetector::Shell::UNKNOWN}) {
+        AliasManager m(shell);
+        
+        std::string expected = "# header\n";
+        for (const auto& a : aliases) {
+            std::string line = m.formatAlias(a);
+            if (!line.empty()) {
+                expected += line + "\n";
+            }
+        }
+        
+        std::string out = "# header\n";
+        assert(m.formatAliasesInto(out, aliases) == 3);
+        assert(out == expected);
+    }
+    
+    // Exact sizes and syntax per shell
+    Alias a{"say", "echo 'hi' $USER", "", true, "", ""};
+    std::string line;
+    assert(Formatter<ShellDetector::Shell::BASH>::appendTo(line, a));
+    assert(line == "alias say=\"echo \\'hi\\' \\$USER\"");
+    assert(line.size() == Formatter<ShellDetector::Shell::BASH>::formattedSize(a));
+    line.clear();
+    assert(Formatter<ShellDetector::Shell::FISH>::appendTo(line, a));
+    assert(line == "alias say 'echo \\'hi\\' \\$USER'");
+    assert(line.size() == Formatter<ShellDetector::Shell::FISH>::formattedSize(a));
+    
+    // Invalid aliases leave the buffer untouched
+    line = "keep";
+    assert(!Formatter<ShellDetector::Shell::ZSH>::appendTo(line, aliases[2]));
+    assert(line == "keep");
+    assert(Formatter<ShellDetector::Shell::ZSH>::formattedSize(aliases[3]) == 0);
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Alias Table
+// Purpose: Verify the arena-backed AliasTable.
+// Tests:
+//   - Rows keep every field; find returns the last definition of a name
+//   - Redefinitions share the interned name bytes
+//   - Views are resolved (quotes, escapes) when appended
+//   - The name map keeps working across growth and clear
+//   - Binary images restore an identical table; damaged images are rejected
+// ------------------------------------------------------------------------------
+static void testAliasTable() {
+    std::cout << "  Testing alias table... ";
+    
+    AliasTable table;
+    assert(table.empty() && table.find("ll") == AliasTable::npos);
+    
+    assert(table.append("ll", "ls -la", "long list", true, "2024-01-01", "") == 0);
+    assert(table.append(Alias{"gs", "git status", "", false, "", ""}) == 1);
+    assert(table.name(0) == "ll" && table.command(0) == "ls -la");
+    assert(table.description(0) == "long list" && table.createdDate(0) == "2024-01-01");
+    assert(table.enabled(0) && !table.enabled(1));
+    
+    // Redefinition: last one wins, name bytes are not stored again
+    size_t before = table.arenaSize();
+    assert(table.append("ll", "ls -l") == 2);
+    assert(table.arenaSize() == before + 5);
+    assert(table.find("ll") == 2);
+    assert(table.name(2).data() == table.name(0).data());
+    
+    // Views are resolved into the arena
+    AliasView view;
+    assert(AliasManager::parseAliasView("alias say='echo \\$HOME'", view));
+    table.append(view);
+    assert(table.command(table.find("say")) == "echo $HOME");
+    
+    // Growth past the initial map capacity
+    for (int i = 0; i < 1000; ++i) {
+        table.append("a" + std::to_string(i), "cmd");
+    }
+    for (int i = 0; i < 1000; ++i) {
+        size_t row = table.find("a" + std::to_string(i));
+        assert(row != AliasTable::npos && table.name(row) == "a" + std::to_string(i));
+    }
+    assert(table.find("gs") == 1 && table.find("missing") == AliasTable::npos);
+    
+    // Materialization and clear
+    std::vector<Alias> aliases = table.toAliases();
+    assert(aliases.size() == table.size());
+    assert(aliases[1].name == "gs" && aliases[1].command == "git status");
+    
+    // Binary image round trip (the name map comes back without rehashing)
+    std::string image;
+    table.serialize(image);
+    AliasTable restored;
+    assert(restored.deserialize(image));
+    assert(restored.size() == table.size() && restored.toAliases() == aliases);
+    assert(restored.lineNumber(3) == table.lineNumber(3));
+    assert(restored.find("a999") == table.find("a999") && restored.find("gs") == 1);
+    assert(!restored.deserialize(std::string_view(image).substr(0, image.size() - 8)));
+    assert(restored.empty() && restored.find("gs") == AliasTable::npos);
+    
+    table.clear();
+    assert(table.empty() && table.find("gs") == AliasTable::npos);
+    table.append("gs", "git status -s");
+    assert(table.find("gs") == 0);
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Main Test Runner
 // Purpose: Execute all AliasManager tests and report results.
@@ -208,10 +651,17 @@ void test_aliasmanager() {
     
     // Execute all test cases
     testValidateAliasName();      // Test naming rules
+    testValidateAliasNamesBatch(); // Test batch validation
     testValidateCommand();        // Test command safety
     testFormatAlias();            // Test shell-specific formatting
     testParseAliasLine();         // Test parsing of alias strings
+    testParseAliasView();         // Test zero-copy view parsing
     testIsAliasLine();            // Test alias detection
+    testLineScanner();            // Test bulk line scanning
+    testTokenizer();              // Test statement tokenizer
+    testEscaping();               // Test escape/unescape paths
+    testFormatAliasesBatch();     // Test batch formatting
+    testAliasTable();             // Test arena-backed alias table
     
     std::cout << "✓ AliasManager tests passed!\n";
 }
@@ -12,11 +12,37 @@
 
 #include "configfilehandler.hpp"  // Configuration file operations
 #include "backupmanager.hpp"      // Backup creation and restoration
+#include "threadpool.hpp"         // Parallel loop helper
+#include "mappedfile.hpp"         // Zero-copy file access
+#include "atomicwriter.hpp"       // Crash-safe file replacement
+#include "aliascache.hpp"         // Persistent parse cache
+#include "hash.hpp"               // Content hash for cache keys
+#include "aliasreloader.hpp"      // Incremental reload
+#include "filewatcher.hpp"        // inotify change notification
+#include "aliastokenizer.hpp"     // Reference parse for reload tests
+#include "linemerge.hpp"          // Line diff and three-way merge
+#include "managedaliases.hpp"      // Owned alias block and sidecar file
+#include "aliasdiscovery.hpp"      // Include-following alias discovery
+#include "xzcodec.hpp"             // In-process .xz compression
+#include "backupstore.hpp"         // Content-addressed backups
+#include "filelock.hpp"            // Lock file locations
 #include <cassert>                // Assertion macros for test validation
 #include <iostream>               // Console output for test reporting
 #include <filesystem>             // Filesystem operations for test cleanup
 #include <fstream>                // File stream operations
 #include <cstdlib>                // Environment variable access
+#include <stdexcept>              // For std::runtime_error
+#include <unistd.h>               // For pipe, write, close
+#include <sys/stat.h>             // For stat, chmod
+#include <sys/xattr.h>            // For setxattr, getxattr
+#include <fcntl.h>                // For open
+#include <iterator>               // For std::istreambuf_iterator, std::size
+#include <random>                 // Random edits for reload tests
+#include <mutex>                  // Watcher callback synchronization
+#include <condition_variable>     // Waiting for watcher callbacks
+#include <thread>                 // For std::this_thread::sleep_for
+#include <map>                    // Expected alias sets
+#include <sys/wait.h>             // For waitpid
 
 #include "utils.hpp"
 
@@ -166,6 +192,1193 @@ static void testRemoveAlias() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Minimal-Rewrite Edits
+// Purpose: Verify that removals and byte edits only touch what they change.
+// Tests:
+//   - Whole statements and single words of multi-definition lines are cut
+//   - All other bytes (comments, other commands, newlines) are preserved
+//   - Successive edits reuse the index; external changes are re-parsed
+//   - Same-length edits are spliced in place; stale offsets are rejected
+// ------------------------------------------------------------------------------
+static void testMinimalEdits() {
+    std::cout << "  Testing minimal-rewrite edits... ";
+    
+    const std::string path = getTempTestFile();
+    auto readFile = [&] {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    
+    for (auto mode : {ConfigFileHandler::WriteMode::InPlace, ConfigFileHandler::WriteMode::Atomic}) {
+        writeFile("# top\nalias a='1'\nexport X=1\nalias b=2 c=3 d=4 # tail\n"
+                  "alias a=\"again\"\n# end\n");
+        ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+        h.setWriteMode(mode);
+        assert(h.loadAliasTable().size() == 5);
+        
+        struct stat before;
+        stat(path.c_str(), &before);
+        
+        assert(h.removeAlias("c"));
+        assert(readFile() == "# top\nalias a='1'\nexport X=1\nalias b=2 d=4 # tail\n"
+                             "alias a=\"again\"\n# end\n");
+        assert(h.removeAlias("d"));
+        assert(readFile() == "# top\nalias a='1'\nexport X=1\nalias b=2 # tail\n"
+                             "alias a=\"again\"\n# end\n");
+        assert(h.removeAlias("a"));
+        assert(readFile() == "# top\nexport X=1\nalias b=2 # tail\n# end\n");
+        assert(!h.removeAlias("a"));
+        
+        // In place keeps the inode; atomic writes replace the file
+        struct stat after;
+        stat(path.c_str(), &after);
+        assert((before.st_ino == after.st_ino) == (mode == ConfigFileHandler::WriteMode::InPlace));
+        
+        // External change: the index is rebuilt before removing
+        writeFile("alias x=1\nalias y=2\n");
+        assert(h.removeAlias("x"));
+        assert(readFile() == "alias y=2\n");
+        
+        // Same-length splice, then a stale edit is refused until reload
+        assert(h.loadAliasTable().size() == 1);
+        assert(h.applyEdits({{8, 1, "7"}}));
+        assert(readFile() == "alias y=7\n");
+        assert(!h.applyEdits({{8, 1, "8"}}));
+        assert(h.loadAliasTable().command(0) == "7");
+        assert(h.applyEdits({{6, 3, "yy=42"}}));
+        assert(readFile() == "alias yy=42\n");
+    }
+    
+    cleanupTestFile();
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Transactions
+// Purpose: Verify batched alias changes.
+// Tests:
+//   - Add, update, remove and rename are applied in one write, in order
+//   - Flags, other definitions and unrelated lines are left untouched
+//   - One backup per commit; nothing is written when an operation fails
+//   - Operations that cancel out write nothing
+// ------------------------------------------------------------------------------
+static void testTransaction() {
+    std::cout << "  Testing transactions... ";
+    
+    const std::string path = getTempTestFile() + ".txn";
+    auto readFile = [&] {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    BackupManager backups(path);
+    for (const std::string& old : backups.listBackups()) {
+        fs::remove(old);
+    }
+    
+    const std::string original = "# top\nalias -g ll='ls -l'\nalias a=1 b=2\n"
+                                 "alias ll=\"ls -la\"\nexport X=1\nalias gone=x";
+    writeFile(original);
+    ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+    
+    // Failing operations leave the file and the backups alone
+    {
+        auto txn = h.beginTransaction();
+        txn.update("ll", "ls");
+        txn.remove("missing");
+        assert(!txn.commit(&backups));
+        assert(h.getLastError() == "Alias not found: missing");
+        assert(txn.size() == 2);
+        
+        txn.clear();
+        txn.rename("a", "ll");
+        assert(!txn.commit(&backups));
+        txn.clear();
+        txn.add({"bad name", "x", "", true, "", ""});
+        assert(!txn.commit(&backups));
+    }
+    assert(readFile() == original && backups.listBackups().empty());
+    
+    // Mixed batch
+    {
+        auto txn = h.beginTransaction();
+        txn.update("ll", "ls -lah");
+        txn.rename("a", "aa");
+        txn.remove("b");
+        txn.add({"n", "echo hi", "", true, "", ""});
+        txn.add({"t", "tmp", "", true, "", ""});
+        txn.remove("t");
+        txn.remove("gone");
+        assert(txn.size() == 7);
+        assert(txn.commit(&backups));
+        assert(txn.empty());
+    }
+    assert(readFile() == "# top\nalias -g ll='ls -l'\nalias aa=1\n"
+                         "alias ll='ls -lah'\nexport X=1\nalias n='echo hi'\n");
+    
+    std::vector<std::string> taken = backups.listBackups();
+    assert(taken.size() == 1);
+    std::ifstream saved(taken[0], std::ios::binary);
+    assert(std::string(std::istreambuf_iterator<char>(saved), {}) == original);
+    
+    // Later operations see earlier renames; add updates an existing alias
+    {
+        auto txn = h.beginTransaction();
+        txn.rename("aa", "a2");
+        txn.add({"a2", "two", "", true, "", ""});
+        txn.add({"z", "1", "", true, "", ""});
+        txn.remove("z");
+        assert(txn.commit());
+    }
+    assert(readFile() == "# top\nalias -g ll='ls -l'\nalias a2='two'\n"
+                         "alias ll='ls -lah'\nexport X=1\nalias n='echo hi'\n");
+    assert(h.loadAliasTable().size() == 4);
+    
+    // Nothing left to write after cancelling operations
+    {
+        auto txn = h.beginTransaction();
+        txn.add({"z", "1", "", true, "", ""});
+        txn.remove("z");
+        assert(txn.commit(&backups));
+    }
+    assert(backups.listBackups().size() == 1);
+    
+    // Fish syntax; appending after a last line without a newline
+    writeFile("alias g 'git'\nalias x 1");
+    ConfigFileHandler fish(path, ShellDetector::Shell::FISH);
+    {
+        auto txn = fish.beginTransaction();
+        txn.update("g", "git status");
+        txn.add({"y", "2", "", true, "", ""});
+        assert(txn.commit());
+    }
+    assert(readFile() == "alias g 'git status'\nalias x 1\nalias y '2'\n");
+    
+    for (const std::string& old : backups.listBackups()) {
+        fs::remove(old);
+    }
+    fs::remove(path);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Update and Rename
+// Purpose: Verify that existing aliases are edited where they stand.
+// Tests:
+//   - The last definition is rewritten; no duplicate is appended
+//   - Flags, neighbouring definitions and other lines keep their bytes
+//   - Missing aliases, taken names and invalid input are rejected
+// ------------------------------------------------------------------------------
+static void testUpdateRename() {
+    std::cout << "  Testing in-place update and rename... ";
+    
+    const std::string path = getTempTestFile();
+    auto readFile = [&] {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << "alias gs='git status'\n# keep\nalias -g G='| grep' v=vim\n";
+    }
+    
+    ConfigFileHandler h(path, ShellDetector::Shell::ZSH);
+    assert(h.updateAlias("gs", "git status -sb"));
+    assert(readFile() == "alias gs='git status -sb'\n# keep\nalias -g G='| grep' v=vim\n");
+    assert(h.updateAlias("G", "| rg"));
+    assert(readFile() == "alias gs='git status -sb'\n# keep\nalias -g G='| rg' v=vim\n");
+    
+    assert(h.renameAlias("v", "vi"));
+    assert(h.renameAlias("gs", "gst"));
+    assert(readFile() == "alias gst='git status -sb'\n# keep\nalias -g G='| rg' vi=vim\n");
+    
+    std::vector<Alias> aliases = h.loadAliases();
+    assert(aliases.size() == 3);
+    assert(aliases[0].name == "gst" && aliases[0].command == "git status -sb");
+    
+    // Rejected: nothing changes
+    const std::string before = readFile();
+    assert(!h.updateAlias("missing", "x"));
+    assert(!h.renameAlias("missing", "y"));
+    assert(!h.renameAlias("gst", "vi"));
+    assert(!h.renameAlias("gst", "bad name"));
+    assert(!h.updateAlias("gst", ""));
+    assert(readFile() == before);
+    
+    // Nothing is created for a missing file
+    fs::remove(path);
+    assert(!h.updateAlias("gst", "x") && !fs::exists(path));
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Parse Cache
+// Purpose: Verify the persistent parsed-alias cache.
+// Tests:
+//   - A load writes an entry that a second load is served from
+//   - Index locations from the cache drive later edits correctly
+//   - Changed content is detected even with the same size and mtime
+//   - Damaged entries and other shells fall back to parsing
+// ------------------------------------------------------------------------------
+static void testAliasCache() {
+    std::cout << "  Testing parse cache... ";
+    
+    const fs::path cacheHome = getTempTestFile() + ".cache";
+    fs::remove_all(cacheHome);
+    const char* savedXdg = std::getenv("XDG_CACHE_HOME");
+    const std::string oldXdg = savedXdg ? savedXdg : "";
+    setenv("XDG_CACHE_HOME", fs::absolute(cacheHome).c_str(), 1);
+    
+    const std::string path = getTempTestFile();
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    writeFile("alias ll='ls -la'\nexport X=1\nalias gs=\"git status\" gd='git diff'\n");
+    
+    ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+    AliasTable first = h.loadAliasTable();
+    assert(first.size() == 3);
+    
+    AliasCache cache(path);
+    const std::string entry = cache.entryPath();
+    assert(entry.rfind(fs::absolute(cacheHome / "aliacan").string(), 0) == 0);
+    assert(fs::exists(entry));
+    
+    // The entry is valid for the current file content
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        const std::string text(std::istreambuf_iterator<char>(ifs), {});
+        struct stat sb;
+        stat(path.c_str(), &sb);
+        CacheKey key{static_cast<uint64_t>(sb.st_dev), static_cast<uint64_t>(sb.st_ino),
+                     static_cast<uint64_t>(sb.st_size),
+                     int64_t(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec,
+                     hash::bytes(text), static_cast<uint32_t>(ShellDetector::Shell::BASH)};
+        AliasTable table;
+        std::vector<CachedDefinition> defs;
+        assert(cache.load(key, table, defs));
+        assert(table.toAliases() == first.toAliases() && defs.size() == 3);
+        key.shell = static_cast<uint32_t>(ShellDetector::Shell::FISH);
+        assert(!cache.load(key, table, defs));
+    }
+    
+    // A fresh handler loads from the cache and edits through its index
+    ConfigFileHandler cached(path, ShellDetector::Shell::BASH);
+    AliasTable second = cached.loadAliasTable();
+    assert(second.toAliases() == first.toAliases());
+    assert(second.lineNumber(2) == 3);
+    assert(cached.removeAlias("gs"));
+    std::vector<Alias> left = cached.loadAliases();
+    assert(left.size() == 2 && left[1].name == "gd" && left[1].command == "git diff");
+    
+    // Same size and mtime, different content: the hash catches it
+    struct stat sb;
+    stat(path.c_str(), &sb);
+    std::string text;
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        text.assign(std::istreambuf_iterator<char>(ifs), {});
+    }
+    text[text.find("ll")] = 'k';
+    writeFile(text);
+    const struct timespec times[2] = {sb.st_atim, sb.st_mtim};
+    utimensat(AT_FDCWD, path.c_str(), times, 0);
+    assert(ConfigFileHandler(path, ShellDetector::Shell::BASH).loadAliases()[0].name == "kl");
+    
+    // A damaged entry is ignored and rewritten
+    {
+        std::fstream stream(entry, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(-1, std::ios::end);
+        stream.put('\x7f');
+    }
+    ConfigFileHandler damaged(path, ShellDetector::Shell::BASH);
+    assert(damaged.loadAliases().size() == 2);
+    assert(AliasCache(path).remove());
+    
+    // Disabled: nothing is written
+    damaged.setCacheEnabled(false);
+    assert(damaged.loadAliases().size() == 2 && !fs::exists(entry));
+    
+    if (savedXdg) {
+        setenv("XDG_CACHE_HOME", oldXdg.c_str(), 1);
+    } else {
+        unsetenv("XDG_CACHE_HOME");
+    }
+    fs::remove_all(cacheHome);
+    cleanupTestFile();
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Incremental Reload
+// Purpose: Verify that AliasReloader tracks file changes correctly.
+// Tests:
+//   - Small edits re-parse only the statements around them
+//   - After random edits (quotes, continuations, keywords) the table always
+//     equals a full parse, including line numbers
+//   - Applying each delta to the previous rows yields the new rows
+//   - Text appended to a statement left open at the end joins it
+//   - Edits outside definitions still report the new content
+//   - Unchanged content and deleted files are handled
+// ------------------------------------------------------------------------------
+static void testAliasReloader() {
+    std::cout << "  Testing incremental reload... ";
+    
+    const std::string path = getTempTestFile();
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += "alias a" + std::to_string(i) + "='echo " + std::to_string(i) + "'\n";
+        text += "export V" + std::to_string(i) + "=1\n";
+    }
+    writeFile(text);
+    
+    AliasReloader reloader(path, ShellDetector::Shell::BASH);
+    AliasDelta delta;
+    AliasTable table;
+    assert(reloader.refresh(delta, table));
+    assert(delta.baseGeneration == 0 && delta.generation == 1);
+    assert(delta.firstRow == 0 && delta.removedRows == 0 && delta.insertedRows == 200);
+    assert(!reloader.refresh(delta, table));
+    
+    // One command changed: one row replaced, one statement re-parsed
+    text.replace(text.find("echo 100"), 8, "echo hundred");
+    writeFile(text);
+    assert(reloader.refresh(delta, table));
+    assert(delta.firstRow == 100 && delta.removedRows == 1 && delta.insertedRows == 1);
+    assert(table.command(100) == "echo hundred" && reloader.lastParsedBytes() < 64);
+    
+    // A line inserted at the top shifts every line number
+    text.insert(0, "alias top=1\n");
+    writeFile(text);
+    assert(reloader.refresh(delta, table));
+    assert(delta.firstRow == 0 && delta.removedRows == 0 && delta.insertedRows == 1);
+    assert(table.lineNumber(200) == 400 && reloader.lastParsedBytes() < 64);
+    
+    // Full-parse reference for the random edits below
+    auto matchesFullParse = [](const std::string& content, const AliasTable& result) {
+        std::vector<AliasDefinition> defs;
+        AliasTokenizer::tokenize(ShellDetector::Shell::BASH, content, defs);
+        if (defs.size() != result.size()) return false;
+        AliasTable reference;
+        for (size_t i = 0; i < defs.size(); ++i) {
+            reference.append(defs[i].view, defs[i].lineNumber);
+            if (reference.name(i) != result.name(i) || reference.command(i) != result.command(i) ||
+                reference.lineNumber(i) != result.lineNumber(i)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    AliasDelta probe;
+    AliasTable scratch;
+    
+    // Appended after an unclosed quote: still inside the open statement
+    {
+        AliasReloader unclosed(path, ShellDetector::Shell::BASH);
+        std::string before = "al\nalias a='x 'hh'\n";
+        assert(unclosed.update(before, probe, scratch));
+        before += "alias d=e\\\n";
+        assert(unclosed.update(before, probe, scratch));
+        assert(matchesFullParse(before, scratch) && scratch.size() == 1);
+    }
+    
+    // A line dropped outside any definition: no row changes, but the line
+    // numbers and the content do
+    {
+        AliasReloader lines(path, ShellDetector::Shell::BASH);
+        std::string before = "alias d=e\\\nalias g 'h'\nalias g 'h'\nalias c='x'\n";
+        assert(lines.update(before, probe, scratch));
+        const uint64_t previous = lines.generation();
+        before.erase(before.find("alias g"), 12);
+        assert(lines.update(before, probe, scratch));
+        assert(probe.baseGeneration == previous && probe.generation == previous + 1);
+        assert(probe.removedRows == 0 && probe.insertedRows == 0);
+        assert(matchesFullParse(before, scratch));
+    }
+    
+    const char* fragments[] = {"'", "\"", "\n", "\\\n", "alias ", "x=1 ", "alias n=2\n",
+                               "# c\n", "alias m='a\nb'\n", "y=\"q\" "};
+    std::mt19937 rng(42);
+    std::vector<std::pair<std::string, std::string>> rows;
+    for (size_t i = 0; i < table.size(); ++i) {
+        rows.emplace_back(table.name(i), table.command(i));
+    }
+    uint64_t generation = reloader.generation();
+    
+    for (int step = 0; step < 400; ++step) {
+        const size_t at = rng() % (text.size() + 1);
+        if (rng() % 2 == 0 && at < text.size()) {
+            text.erase(at, 1 + rng() % 16);
+        } else {
+            text.insert(at, fragments[rng() % std::size(fragments)]);
+        }
+        
+        if (reloader.update(text, delta, table)) {
+            assert(delta.baseGeneration == generation && delta.generation == generation + 1);
+            generation = delta.generation;
+            rows.erase(rows.begin() + static_cast<ptrdiff_t>(delta.firstRow),
+                       rows.begin() + static_cast<ptrdiff_t>(delta.firstRow + delta.removedRows));
+            for (size_t i = 0; i < delta.insertedRows; ++i) {
+                const size_t row = delta.firstRow + i;
+                rows.emplace(rows.begin() + static_cast<ptrdiff_t>(row),
+                             std::string(table.name(row)), std::string(table.command(row)));
+            }
+        }
+        assert(matchesFullParse(text, table));
+        
+        // Rows are the same with or without a delta
+        assert(rows.size() == table.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            assert(rows[i].first == table.name(i) && rows[i].second == table.command(i));
+        }
+    }
+    
+    // A deleted file has no aliases
+    writeFile("alias a='1'\nalias b='2'\n");
+    reloader.refresh(delta, table);
+    assert(table.size() == 2);
+    fs::remove(path);
+    assert(reloader.refresh(delta, table));
+    assert(table.empty() && delta.firstRow == 0 && delta.removedRows == 2 &&
+           delta.insertedRows == 0);
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: File Watcher
+// Purpose: Verify inotify change notification.
+// Tests:
+//   - A burst of writes produces one callback after the debounce interval
+//   - Replacing the file through a rename is noticed
+//   - Changes to other files in the directory are ignored
+// ------------------------------------------------------------------------------
+static void testFileWatcher() {
+    std::cout << "  Testing file watcher... ";
+    
+    const fs::path dir = getTempTestFile() + ".watch";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path = (dir / "rc").string();
+    std::ofstream(path) << "alias a=1\n";
+    
+    std::mutex lock;
+    std::condition_variable changed;
+    int calls = 0;
+    auto waitFor = [&](int count) {
+        std::unique_lock<std::mutex> guard(lock);
+        return changed.wait_for(guard, std::chrono::seconds(5), [&] { return calls >= count; });
+    };
+    
+    FileWatcher watcher;
+    assert(watcher.start(path, [&] {
+        std::lock_guard<std::mutex> guard(lock);
+        ++calls;
+        changed.notify_all();
+    }, std::chrono::milliseconds(50)));
+    assert(watcher.isRunning());
+    
+    for (int i = 0; i < 5; ++i) {
+        std::ofstream(path, std::ios::app) << "alias b" << i << "=1\n";
+    }
+    assert(waitFor(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        assert(calls == 1);
+    }
+    
+    std::ofstream((dir / "unrelated").string()) << "x";
+    std::ofstream((dir / "rc.new").string()) << "alias c=1\n";
+    fs::rename(dir / "rc.new", path);
+    assert(waitFor(2));
+    
+    watcher.stop();
+    assert(!watcher.isRunning());
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        assert(calls == 2);
+    }
+    
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Concurrent Writers
+// Purpose: Verify that no edit is lost when several processes write at once.
+// Tests:
+//   - Forked processes add, rename and remove their own aliases through
+//     transactions (atomic rewrites) and addAlias (locked appends)
+//   - The final file holds exactly the aliases every script leaves behind
+//   - The lock file is kept out of the rc file's directory
+// ------------------------------------------------------------------------------
+static void testConcurrentWriters() {
+    std::cout << "  Testing concurrent writers... ";
+    
+    const std::string path = getTempTestFile() + ".multi";
+    fs::remove(path);
+    std::ofstream(path) << "alias base='x'\n";
+    
+    // The script of process p: each step is applied to the file by the
+    // child and to the expected alias set by the parent
+    constexpr int kProcesses = 6;
+    constexpr int kRounds = 25;
+    auto run = [](int p, auto&& add, auto&& append, auto&& rename, auto&& remove) {
+        std::string previous;
+        for (int r = 0; r < kRounds; ++r) {
+            std::string name = "p" + std::to_string(p) + "_" + std::to_string(r);
+            add(name, "echo " + name);
+            if (r % 4 == 1) {
+                const std::string renamed = "r" + name.substr(1);
+                rename(name, renamed);
+                name = renamed;
+            }
+            if (r % 3 == 2) {
+                remove(previous);
+            }
+            if (r % 5 == 0) {
+                append("q" + name.substr(1), "true");
+            }
+            previous = name;
+        }
+    };
+    
+    std::vector<pid_t> children;
+    for (int p = 0; p < kProcesses; ++p) {
+        pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) {
+            ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+            h.setCacheEnabled(false);
+            bool ok = true;
+            run(p,
+                [&](const std::string& n, const std::string& c) {
+                    auto txn = h.beginTransaction();
+                    txn.add({n, c, "", true, "", ""});
+                    ok = txn.commit() && ok;
+                },
+                [&](const std::string& n, const std::string& c) {
+                    ok = h.addAlias({n, c, "", true, "", ""}) && ok;
+                },
+                [&](const std::string& a, const std::string& b) { ok = h.renameAlias(a, b) && ok; },
+                [&](const std::string& n) { ok = h.removeAlias(n) && ok; });
+            _exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    
+    std::map<std::string, std::string> expected{{"base", "x"}};
+    for (int p = 0; p < kProcesses; ++p) {
+        run(p,
+            [&](const std::string& n, const std::string& c) { expected[n] = c; },
+            [&](const std::string& n, const std::string& c) { expected[n] = c; },
+            [&](const std::string& a, const std::string& b) {
+                expected[b] = expected[a];
+                expected.erase(a);
+            },
+            [&](const std::string& n) { expected.erase(n); });
+    }
+    
+    for (pid_t pid : children) {
+        int status = 0;
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    
+    ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+    h.setCacheEnabled(false);
+    AliasTable table = h.loadAliasTable();
+    std::map<std::string, std::string> actual;
+    for (size_t row = 0; row < table.size(); ++row) {
+        assert(actual.emplace(table.name(row), table.command(row)).second);
+    }
+    assert(actual == expected);
+    
+    const std::string lockFile = FileLock::lockPathFor(path);
+    assert(fs::exists(lockFile) && !fs::exists(path + ".lock"));
+    assert(fs::path(lockFile).parent_path() != fs::absolute(path).parent_path());
+    
+    fs::remove(path);
+    fs::remove(lockFile);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Line Merge
+// Purpose: Verify the line diff and three-way merge.
+// Tests:
+//   - Random diffs rebuild the target and are minimal (checked against LCS)
+//   - Changes to different lines combine; identical changes are taken once
+//   - Differing changes to the same lines become conflicts
+// ------------------------------------------------------------------------------
+static void testLineMerge() {
+    std::cout << "  Testing line merge... ";
+    
+    auto splitLines = [](const std::string& text) {
+        std::vector<std::string> lines;
+        for (size_t pos = 0; pos < text.size();) {
+            size_t end = text.find('\n', pos);
+            end = end == std::string::npos ? text.size() : end + 1;
+            lines.push_back(text.substr(pos, end - pos));
+            pos = end;
+        }
+        return lines;
+    };
+    auto lcs = [](const std::vector<std::string>& a, const std::vector<std::string>& b) {
+        std::vector<std::vector<size_t>> d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+        for (size_t i = 1; i <= a.size(); ++i) {
+            for (size_t j = 1; j <= b.size(); ++j) {
+                d[i][j] = a[i - 1] == b[j - 1] ? d[i - 1][j - 1] + 1
+                                               : std::max(d[i - 1][j], d[i][j - 1]);
+            }
+        }
+        return d[a.size()][b.size()];
+    };
+    
+    std::mt19937 rng(17);
+    auto randomText = [&] {
+        std::string text;
+        for (size_t i = rng() % 14; i > 0; --i) {
+            text += static_cast<char>('a' + rng() % 4);
+            text += '\n';
+        }
+        if (!text.empty() && rng() % 4 == 0) {
+            text.pop_back();  // No final newline
+        }
+        return text;
+    };
+    for (int round = 0; round < 3000; ++round) {
+        const std::string a = randomText();
+        const std::string b = randomText();
+        const std::vector<std::string> la = splitLines(a);
+        const std::vector<std::string> lb = splitLines(b);
+        
+        std::string rebuilt;
+        size_t pos = 0;
+        size_t cost = 0;
+        for (const LineMerge::Hunk& h : LineMerge::diff(a, b)) {
+            assert(h.baseBegin >= pos && h.baseBegin <= h.baseEnd);
+            for (size_t i = pos; i < h.baseBegin; ++i) rebuilt += la[i];
+            for (size_t i = h.otherBegin; i < h.otherEnd; ++i) rebuilt += lb[i];
+            cost += (h.baseEnd - h.baseBegin) + (h.otherEnd - h.otherBegin);
+            pos = h.baseEnd;
+        }
+        for (size_t i = pos; i < la.size(); ++i) rebuilt += la[i];
+        assert(rebuilt == b);
+        assert(cost == la.size() + lb.size() - 2 * lcs(la, lb));
+    }
+    
+    // Different lines combine, including neighbouring ones
+    LineMerge::Result r = LineMerge::merge("a\nb\nc\nd\n", "A\nb\nc\nd\n", "a\nB\nc\nd\nE\n");
+    assert(r.conflicts.empty() && r.text == "A\nB\nc\nd\nE\n");
+    
+    // The same change on both sides is not a conflict
+    r = LineMerge::merge("a\nb\n", "a\nX\nc\n", "a\nX\nc\n");
+    assert(r.conflicts.empty() && r.text == "a\nX\nc\n");
+    r = LineMerge::merge("a\nb\nc\n", "a\nc\n", "a\nc\nd\n");
+    assert(r.conflicts.empty() && r.text == "a\nc\nd\n");
+    
+    // Differing changes of the same line, and two inserts at one place
+    r = LineMerge::merge("a\nb\nc\n", "a\nX\nc\n", "a\nY\nc\n");
+    assert(r.conflicts.size() == 1 && r.text == "a\nX\nY\nc\n");
+    assert(r.conflicts[0].base == "b\n" && r.conflicts[0].theirs == "X\n" &&
+           r.conflicts[0].ours == "Y\n" && r.conflicts[0].offset == 2 &&
+           r.conflicts[0].baseLine == 1);
+    r = LineMerge::merge("a\n", "a\nt\n", "a\no\n");
+    assert(r.conflicts.size() == 1 && r.conflicts[0].base.empty() && r.text == "a\nt\no\n");
+    
+    // Far-apart edits of a 100k-line file
+    std::string base;
+    for (int i = 0; i < 100000; ++i) {
+        base += "alias a" + std::to_string(i) + "='cmd " + std::to_string(i) + "'\n";
+    }
+    std::string theirs = base;
+    std::string ours = base;
+    theirs.replace(theirs.find("alias a500="), 5, "alias");
+    theirs.insert(theirs.find("alias a700="), "# note\n");
+    ours.replace(ours.find("'cmd 90000'"), 11, "'cmd ours'");
+    std::string expected = theirs;
+    expected.replace(expected.find("'cmd 90000'"), 11, "'cmd ours'");
+    r = LineMerge::merge(base, theirs, ours);
+    assert(r.conflicts.empty() && r.text == expected);
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Merge on Commit
+// Purpose: Verify three-way merging of commits against a merge base.
+// Tests:
+//   - Changes made on disk since the base are kept, ours are applied
+//   - Aliases added on both sides at the end are both kept
+//   - Different aliases of one statement changed on both sides are both kept
+//   - The same alias changed on both sides fails with that name as a
+//     conflict and leaves the file untouched
+//   - A successful commit makes the written content the new base
+// ------------------------------------------------------------------------------
+static void testMergeCommit() {
+    std::cout << "  Testing merge on commit... ";
+    
+    const std::string path = getTempTestFile() + ".merge";
+    auto readFile = [&] {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    
+    const std::string base = "# rc\nalias a='1'\nalias b='2'\nalias c=3 d=4\nexport X=1\n";
+    writeFile(base);
+    ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+    h.setMergeBase(base);
+    
+    // Someone else edits b and appends e; we edit a and add f
+    writeFile("# rc\nalias a='1'\nalias b='two'\nalias c=3 d=4\nexport X=1\nalias e='5'\n");
+    {
+        auto txn = h.beginTransaction();
+        txn.update("a", "one");
+        txn.add({"f", "6", "", true, "", ""});
+        assert(txn.commit());
+    }
+    assert(readFile() == "# rc\nalias a='one'\nalias b='two'\nalias c=3 d=4\nexport X=1\n"
+                         "alias e='5'\nalias f='6'\n");
+    assert(h.getConflicts().empty());
+    
+    // Different aliases of one statement: the operations are replayed
+    writeFile("# rc\nalias a='one'\nalias b='two'\nalias c=30 d=4\nexport X=1\n"
+              "alias e='5'\nalias f='6'\n");
+    assert(h.updateAlias("d", "40"));
+    assert(readFile().find("alias c=30 d='40'\n") != std::string::npos);
+    
+    // The same alias on both sides: nothing is written
+    const std::string beforeConflict = readFile();
+    h.setMergeBase(beforeConflict);
+    writeFile(beforeConflict + "# unrelated\n");
+    {
+        std::string onDisk = readFile();
+        onDisk.replace(onDisk.find("alias b='two'"), 13, "alias b='disk'");
+        writeFile(onDisk);
+        auto txn = h.beginTransaction();
+        txn.update("b", "ours");
+        txn.remove("e");
+        assert(!txn.commit());
+        assert(h.getConflicts() == std::vector<std::string>{"b"});
+        assert(h.getLastError().find("b") != std::string::npos);
+        assert(readFile() == onDisk);
+        
+        // Removing an alias that was changed on disk conflicts too
+        txn.clear();
+        txn.remove("b");
+        assert(!txn.commit() && h.getConflicts() == std::vector<std::string>{"b"});
+        
+        // Once the user has seen the disk version, the edit goes through
+        h.setMergeBase(onDisk);
+        txn.clear();
+        txn.update("b", "ours");
+        assert(txn.commit() && h.getConflicts().empty());
+        assert(readFile().find("alias b='ours'\n") != std::string::npos);
+    }
+    
+    // The written content is the base of the next commit
+    assert(h.updateAlias("a", "uno"));
+    assert(readFile().find("alias a='uno'\n") != std::string::npos);
+    assert(readFile().find("# unrelated\n") != std::string::npos);
+    
+    h.clearMergeBase();
+    fs::remove(path);
+    fs::remove(FileLock::lockPathFor(path));
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Managed Aliases
+// Purpose: Verify the opt-in owned alias region.
+// Tests:
+//   - Block storage only ever rewrites the bytes between its markers
+//   - Aliases outside the block are neither loaded nor touched
+//   - Sidecar storage adopts the block's aliases and sources its file once
+// ------------------------------------------------------------------------------
+static void testManagedAliases() {
+    std::cout << "  Testing managed aliases... ";
+    
+    const std::string rc = getTempTestFile() + ".managed";
+    const std::string sidecar = getTempTestFile() + ".sidecar/aliases.bash";
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    const std::string head = "# my rc\nalias ll='ls -l'\nexport X=1";
+    const std::string tail = "alias gs='git status'\n";
+    {
+        std::ofstream ofs(rc, std::ios::trunc | std::ios::binary);
+        ofs << head;
+    }
+    
+    // Block: created at the end on first use, then edited in place
+    ManagedAliases block(rc, ShellDetector::Shell::BASH, ManagedAliases::Storage::Block);
+    assert(!block.isInstalled() && block.loadAliases().empty());
+    assert(block.install() && block.isInstalled());
+    assert(block.install());
+    assert(block.addAlias({"a", "echo 1", "", true, "", ""}));
+    assert(block.addAlias({"b", "echo 2", "", true, "", ""}));
+    {
+        std::ofstream ofs(rc, std::ios::app | std::ios::binary);
+        ofs << tail;
+    }
+    assert(block.addAlias({"ll", "ls -la", "", true, "", ""}));
+    assert(block.updateAlias("a", "echo one"));
+    assert(block.renameAlias("b", "c"));
+    assert(!block.renameAlias("c", "a") && !block.updateAlias("zz", "x"));
+    assert(block.removeAlias("ll"));
+    assert(!block.removeAlias("ll"));
+    
+    std::string text = readFile(rc);
+    assert(text.starts_with(head + "\n" + std::string(ManagedAliases::kBeginMarker) + "\n"));
+    assert(text.ends_with(std::string(ManagedAliases::kEndMarker) + "\n" + tail));
+    assert(text.find("alias a='echo one'\nalias c='echo 2'\n") != std::string::npos);
+    std::vector<Alias> managed = block.loadAliases();
+    assert(managed.size() == 2);
+    assert(managed[0].name == "a" && managed[0].command == "echo one");
+    assert(managed[1].name == "c" && managed[1].command == "echo 2");
+    assert(managed[0].enabled && managed[1].enabled);
+    
+    // The rc file as a whole still defines both kinds
+    std::vector<Alias> all = ConfigFileHandler(rc, ShellDetector::Shell::BASH).loadAliases();
+    assert(all.size() == 4);
+    
+    // A block without its end marker is refused rather than guessed at
+    {
+        std::ofstream ofs(rc + ".broken", std::ios::binary);
+        ofs << ManagedAliases::kBeginMarker << "\nalias a='1'\n";
+    }
+    ManagedAliases broken(rc + ".broken", ShellDetector::Shell::BASH,
+                          ManagedAliases::Storage::Block);
+    assert(!broken.addAlias({"b", "2", "", true, "", ""}));
+    assert(broken.getLastError().find("end marker") != std::string::npos);
+    
+    // Sidecar: the block's aliases move out and the block sources the file
+    ManagedAliases side(rc, ShellDetector::Shell::BASH, ManagedAliases::Storage::Sidecar,
+                        sidecar);
+    assert(side.getAliasFilePath() == sidecar);
+    assert(side.install() && side.isInstalled());
+    assert(side.install());
+    text = readFile(rc);
+    assert(text.find("[ -f '" + sidecar + "' ] && . '" + sidecar + "'\n") !=
+           std::string::npos);
+    assert(text.find("alias a=") == std::string::npos);
+    assert(text.starts_with(head) && text.ends_with(tail));
+    
+    const std::string rcBefore = text;
+    assert(side.addAlias({"d", "date", "", true, "", ""}));
+    assert(side.removeAlias("c"));
+    assert(readFile(rc) == rcBefore);
+    managed = side.loadAliases();
+    assert(managed.size() == 2 && managed[0].name == "a" && managed[1].name == "d");
+    assert(managed[0].enabled && managed[1].enabled);
+    
+    // The sidecar file itself is an ordinary alias file
+    all = ConfigFileHandler(sidecar, ShellDetector::Shell::BASH).loadAliases();
+    assert(all.size() == 2 && all[1].command == "date");
+    
+    fs::remove_all(fs::path(sidecar).parent_path());
+    for (const std::string& path : {rc, FileLock::lockPathFor(rc), rc + ".broken",
+                                    FileLock::lockPathFor(rc + ".broken")}) {
+        fs::remove(path);
+    }
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Alias Discovery
+// Purpose: Verify discovery of every file aliases come from.
+// Tests:
+//   - source and . are followed in execution order, with origin lines
+//   - Cycles stop, repeated includes replay, unknowable paths are reported
+//   - The winning definition of each name is marked
+//   - ZDOTDIR and XDG_CONFIG_HOME (with fish's conf.d) select startup files
+// ------------------------------------------------------------------------------
+static void testAliasDiscovery() {
+    std::cout << "  Testing alias discovery... ";
+    
+    const fs::path dir = fs::absolute(getTempTestFile() + ".discovery");
+    fs::remove_all(dir);
+    fs::create_directories(dir / "xdg" / "fish" / "conf.d");
+    fs::create_directories(dir / "zdot");
+    auto writeFile = [](const fs::path& path, const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    auto restoreEnv = [](const char* name, const char* saved) {
+        if (saved != nullptr) {
+            setenv(name, saved, 1);
+        } else {
+            unsetenv(name);
+        }
+    };
+    const std::string root = (dir / "root.sh").string();
+    const std::string inc = (dir / "inc.sh").string();
+    const char* savedDir = std::getenv("ALIACAN_TEST_DIR");
+    const std::string oldDir = savedDir != nullptr ? savedDir : "";
+    setenv("ALIACAN_TEST_DIR", dir.c_str(), 1);
+    
+    writeFile(root,
+              "alias a='root'\n"
+              "if [ -f \"$ALIACAN_TEST_DIR/inc.sh\" ]; then . \"$ALIACAN_TEST_DIR/inc.sh\"; fi\n"
+              "alias b='root-b'\n"
+              "source ${ALIACAN_TEST_DIR}/inc.sh  # again\n"
+              ". $(echo nope)\n"
+              ". ~/aliacan-missing-file\n"
+              "alias c='root-c'\n");
+    writeFile(inc,
+              "alias a='inc'\n"
+              "alias b='inc-b'\n"
+              "[ -n \"$X\" ] || . '" + root + "'\n"
+              "alias d='inc-d'\n");
+    
+    AliasDiscovery::Result r = AliasDiscovery(ShellDetector::Shell::BASH).discover({root});
+    assert(r.files.size() == 2);
+    assert(r.files[0].path == root && r.files[0].includedFrom == AliasDiscovery::kNone);
+    assert(r.files[1].path == inc && r.files[1].includedFrom == 0 && r.files[1].includeLine == 2);
+    
+    // Execution order: root 1, inc, root 3, inc again, root 7
+    const std::vector<std::pair<std::string, std::string>> order = {
+        {"a", "root"}, {"a", "inc"}, {"b", "inc-b"}, {"d", "inc-d"}, {"b", "root-b"},
+        {"a", "inc"}, {"b", "inc-b"}, {"d", "inc-d"}, {"c", "root-c"}
+    };
+    assert(r.aliases.size() == order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        assert(r.aliases[i].name == order[i].first && r.aliases[i].command == order[i].second);
+    }
+    assert(r.aliases[0].file == 0 && r.aliases[0].line == 1);
+    assert(r.aliases[3].file == 1 && r.aliases[3].line == 4);
+    assert(r.aliases[8].file == 0 && r.aliases[8].line == 7);
+    
+    // Shadowing: the last run of each name wins
+    for (size_t i = 0; i < r.aliases.size(); ++i) {
+        assert(r.aliases[i].effective == (i >= 5));
+    }
+    assert(r.aliases[0].shadowedBy == 1 && r.aliases[1].shadowedBy == 5);
+    assert(r.aliases[2].shadowedBy == 4 && r.aliases[4].shadowedBy == 6);
+    assert(r.aliases[5].shadowedBy == AliasDiscovery::kNone);
+    
+    // The cycle back to root, the command substitution, the missing file
+    assert(r.skipped.size() == 3);
+    assert(r.skipped[0].file == 1 && r.skipped[0].line == 3 &&
+           r.skipped[0].reason == "include cycle");
+    assert(r.skipped[1].file == 0 && r.skipped[1].line == 5 &&
+           r.skipped[1].target == "$(echo nope)");
+    assert(r.skipped[2].line == 6 && r.skipped[2].reason == "not found");
+    
+    // Another name for a known file is the same file
+    fs::create_symlink(inc, dir / "link.sh");
+    r = AliasDiscovery(ShellDetector::Shell::BASH).discover({root, (dir / "link.sh").string()});
+    assert(r.files.size() == 2 && r.aliases.size() == order.size() + 3);
+    
+    // Startup files follow ZDOTDIR and XDG_CONFIG_HOME
+    const char* savedZdot = std::getenv("ZDOTDIR");
+    const char* savedXdg = std::getenv("XDG_CONFIG_HOME");
+    const std::string oldZdot = savedZdot != nullptr ? savedZdot : "";
+    const std::string oldXdg = savedXdg != nullptr ? savedXdg : "";
+    setenv("ZDOTDIR", (dir / "zdot").c_str(), 1);
+    setenv("XDG_CONFIG_HOME", (dir / "xdg").c_str(), 1);
+    
+    assert(ShellDetector::getConfigFilePath(ShellDetector::Shell::ZSH) ==
+           (dir / "zdot" / ".zshrc").string());
+    assert(AliasDiscovery::startupFiles(ShellDetector::Shell::ZSH) ==
+           (std::vector<std::string>{(dir / "zdot" / ".zshenv").string(),
+                                     (dir / "zdot" / ".zshrc").string()}));
+    
+    const fs::path fish = dir / "xdg" / "fish";
+    writeFile(fish / "conf.d" / "b.fish", "alias x 'b'\n");
+    writeFile(fish / "conf.d" / "a.fish",
+              "alias x 'a'\n"
+              "test -f $__fish_config_dir/extra.fish; and source $__fish_config_dir/extra.fish\n");
+    writeFile(fish / "conf.d" / "notes.txt", "alias n 'ignored'\n");
+    writeFile(fish / "extra.fish", "alias z 'extra'\n");
+    writeFile(fish / "config.fish", "alias y 'config'\n");
+    assert(AliasDiscovery::startupFiles(ShellDetector::Shell::FISH) ==
+           (std::vector<std::string>{(fish / "conf.d" / "a.fish").string(),
+                                     (fish / "conf.d" / "b.fish").string(),
+                                     (fish / "config.fish").string()}));
+    r = AliasDiscovery(ShellDetector::Shell::FISH).discover();
+    assert(r.files.size() == 4 && r.files[1].path == (fish / "extra.fish").string());
+    assert(r.aliases.size() == 4);
+    assert(r.aliases[0].command == "a" && !r.aliases[0].effective);
+    assert(r.aliases[1].name == "z" && r.aliases[2].command == "b" && r.aliases[2].effective);
+    assert(r.aliases[3].name == "y" && r.skipped.empty());
+    
+    restoreEnv("ZDOTDIR", savedZdot != nullptr ? oldZdot.c_str() : nullptr);
+    restoreEnv("XDG_CONFIG_HOME", savedXdg != nullptr ? oldXdg.c_str() : nullptr);
+    restoreEnv("ALIACAN_TEST_DIR", savedDir != nullptr ? oldDir.c_str() : nullptr);
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Syscall Budget
+// Purpose: Verify that edits make a fixed number of metadata calls.
+// Tests:
+//   - Loads and edits cost the same on a small and a 100k-line file
+//   - Steady-state edits stay within a small budget
+//   - Rewrites keep the file's mode instead of resetting it
+// ------------------------------------------------------------------------------
+static void testSyscallBudget() {
+    std::cout << "  Testing syscall budget... ";
+    
+    const std::string small = getTempTestFile() + ".small";
+    const std::string large = getTempTestFile() + ".large";
+    std::ofstream(small) << "alias a='1'\nalias b='2'\n";
+    {
+        std::ofstream ofs(large);
+        for (int i = 0; i < 100000; ++i) {
+            ofs << "alias l" << i << "='echo " << i << "'\n";
+        }
+        ofs << "alias a='1'\nalias b='2'\n";
+    }
+    chmod(small.c_str(), 0600);
+    chmod(large.c_str(), 0600);
+    
+    // Calls made by each step
+    auto costs = [](const std::string& path) {
+        ConfigFileHandler h(path, ShellDetector::Shell::BASH);
+        h.setCacheEnabled(false);
+        std::vector<uint64_t> out;
+        h.loadAliasTable();
+        out.push_back(h.getLastSyscallCount());
+        assert(h.updateAlias("a", "one"));
+        out.push_back(h.getLastSyscallCount());
+        assert(h.updateAlias("a", "uno"));
+        out.push_back(h.getLastSyscallCount());
+        assert(h.removeAlias("b"));
+        out.push_back(h.getLastSyscallCount());
+        assert(h.addAlias({"c", "3", "", true, "", ""}));
+        out.push_back(h.getLastSyscallCount());
+        return out;
+    };
+    const std::vector<uint64_t> smallCosts = costs(small);
+    const std::vector<uint64_t> largeCosts = costs(large);
+    assert(smallCosts == largeCosts);
+    assert(smallCosts[2] <= 16 && smallCosts[3] <= 16);  // Directory and lock file held
+    assert(smallCosts[4] <= 4);                          // flock, open, flock
+    
+    std::vector<Alias> aliases = ConfigFileHandler(small, ShellDetector::Shell::BASH).loadAliases();
+    assert(aliases.size() == 2 && aliases[0].command == "uno" && aliases[1].name == "c");
+    struct stat st;
+    assert(stat(small.c_str(), &st) == 0 && (st.st_mode & 0777) == 0600);
+    
+    for (const std::string& path : {small, FileLock::lockPathFor(small), large,
+                                    FileLock::lockPathFor(large)}) {
+        fs::remove(path);
+    }
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Atomic Writer
+// Purpose: Verify crash-safe replacement of files.
+// Tests:
+//   - Content, mode and user xattrs (where supported) carry over
+//   - Symlinks stay symlinks; their destination is replaced
+//   - Aborted writers leave the target and the directory untouched
+//   - A SyncGroup publishes several files together, then runs its steps
+// ------------------------------------------------------------------------------
+static void testAtomicWriter() {
+    std::cout << "  Testing atomic writer... ";
+    
+    const fs::path dir = getTempTestFile() + ".d";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string target = (dir / "rc").string();
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto entries = [&] {
+        return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+    };
+    
+    std::ofstream(target) << "old\n";
+    chmod(target.c_str(), 0600);
+    bool xattrs = setxattr(target.c_str(), "user.aliacan", "1", 1, 0) == 0;
+    
+    {
+        AtomicWriter w(target);
+        assert(w.open());
+        assert(w.write("new "));
+        int src = open(target.c_str(), O_RDONLY);
+        assert(w.copyRange(src, 0, 3));  // Prefix of the old file
+        close(src);
+        assert(w.commit());
+    }
+    assert(readFile(target) == "new old");
+    struct stat st;
+    stat(target.c_str(), &st);
+    assert((st.st_mode & 0777) == 0600);
+    if (xattrs) {
+        char value[4] = {};
+        assert(getxattr(target.c_str(), "user.aliacan", value, sizeof(value)) == 1);
+        assert(value[0] == '1');
+    }
+    assert(entries() == 1);
+    
+    // Aborted: nothing changes, no temporary file is left behind
+    {
+        AtomicWriter w(target);
+        assert(w.open() && w.write("discarded"));
+    }
+    assert(readFile(target) == "new old" && entries() == 1);
+    
+    // Through a symlink
+    const std::string link = (dir / "link").string();
+    fs::create_symlink(target, link);
+    {
+        AtomicWriter w(link);
+        assert(w.open() && w.write("via link") && w.commit());
+    }
+    assert(fs::is_symlink(link) && readFile(target) == "via link");
+    
+    // Group commit of three files, one of them owned by the caller
+    {
+        SyncGroup group;
+        AtomicWriter* a = group.add(target);
+        AtomicWriter* b = group.add((dir / "other").string());
+        AtomicWriter c((dir / "third").string());
+        assert(c.open() && c.write("C"));
+        group.add(c);
+        assert(a && b && group.size() == 3);
+        assert(a->write("A") && b->write("B"));
+        bool stepped = false;
+        group.afterCommit([&] { stepped = readFile((dir / "third").string()) == "C"; });
+        assert(readFile(target) == "via link" && !stepped);  // Not visible before commit
+        assert(group.commit() && group.size() == 0 && stepped);
+        assert(c.fd() >= 0);
+    }
+    assert(readFile(target) == "A" && readFile((dir / "other").string()) == "B");
+    assert(entries() == 4);
+    
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Test: Multiple Aliases
 // Purpose: Verify handling of multiple aliases in configuration.
@@ -210,6 +1423,192 @@ static void testMultipleAliases() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Round Trip Through Every Shell Syntax
+// Purpose: Verify that aliases written by addAlias load back unchanged.
+// Tests fish syntax and commands containing quotes and dollar signs.
+// ------------------------------------------------------------------------------
+static void testShellRoundTrip() {
+    std::cout << "  Testing shell syntax round trip... ";
+    
+    const std::vector<Alias> samples = {
+        {"ll", "ls -la", std::string(), true, getCurrentDate(), getCurrentDate()},
+        {"say", "echo \"it's $HOME\"", std::string(), true, getCurrentDate(), getCurrentDate()},
+        {"gl", "git log --format='%h %s'", std::string(), true, getCurrentDate(), getCurrentDate()}
+    };
+    
+    for (auto shell : {ShellDetector::Shell::BASH, ShellDetector::Shell::ZSH,
+                       ShellDetector::Shell::FISH}) {
+        cleanupTestFile();
+        ConfigFileHandler h(getTempTestFile(), shell);
+        for (const auto& a : samples) {
+            assert(h.addAlias(a));
+        }
+        
+        auto loaded = h.loadAliases();
+        assert(loaded.size() == samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            assert(loaded[i].name == samples[i].name);
+            assert(loaded[i].command == samples[i].command);
+        }
+        
+        // The table holds the same definitions and finds them by name
+        AliasTable table = h.loadAliasTable();
+        assert(table.size() == samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            assert(table.find(samples[i].name) == i);
+            assert(table.command(i) == samples[i].command);
+        }
+    }
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Thread Pool
+// Purpose: Verify that parallelFor runs every index once and reports errors.
+// ------------------------------------------------------------------------------
+static void testThreadPool() {
+    std::cout << "  Testing thread pool... ";
+    
+    ThreadPool pool(4);
+    assert(pool.size() == 4);
+    
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), [&](size_t i) { hits[i] += 1; });
+    for (int h : hits) {
+        assert(h == 1);
+    }
+    
+    // The first exception reaches the caller; the pool stays usable
+    bool caught = false;
+    try {
+        pool.parallelFor(10, [](size_t i) {
+            if (i == 7) throw std::runtime_error("boom");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+    pool.parallelFor(0, [](size_t) { assert(false); });
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Parallel Chunked Load
+// Purpose: Verify that large files parse identically in chunks.
+// Tests multi-line quoted values and continuations that may straddle the
+// chunk boundaries; names, commands and line numbers must match a serial
+// load exactly.
+// ------------------------------------------------------------------------------
+static void testParallelLoad() {
+    std::cout << "  Testing parallel chunked load... ";
+    
+    cleanupTestFile();
+    {
+        std::ofstream ofs(getTempTestFile());
+        for (int i = 0; i < 20000; ++i) {
+            switch (i % 5) {
+                case 0: ofs << "alias a" << i << "='ls -la'\n"; break;
+                case 1:
+                    // Quoted value over many lines, mostly hiding the boundaries
+                    ofs << "alias m" << i << "='echo one\n";
+                    for (int j = 0; j < 20; ++j) ofs << "alias fake=x\n";
+                    ofs << "two'\n";
+                    break;
+                case 2: ofs << "alias c" << i << "=git\\\n  x=y\n"; break;
+                case 3: ofs << "export PATH=$PATH:/opt/bin" << i << "\n"; break;
+                default: ofs << "# comment " << i << "\n"; break;
+            }
+        }
+    }
+    
+    ConfigFileHandler serial(getTempTestFile(), ShellDetector::Shell::BASH);
+    serial.setParallelThreshold(0);
+    AliasTable expected = serial.loadAliasTable();
+    
+    ConfigFileHandler chunked(getTempTestFile(), ShellDetector::Shell::BASH);
+    chunked.setParallelThreshold(1);
+    AliasTable actual = chunked.loadAliasTable();
+    
+    assert(expected.size() == 20000 / 5 * 4);  // c lines define two aliases
+    assert(actual.size() == expected.size());
+    for (size_t row = 0; row < expected.size(); ++row) {
+        assert(actual.name(row) == expected.name(row));
+        assert(actual.command(row) == expected.command(row));
+        assert(actual.lineNumber(row) == expected.lineNumber(row));
+    }
+    assert(expected.find("fake") == AliasTable::npos);
+    
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Mapped File
+// Purpose: Verify MappedFile for regular files and the read() fallback.
+// Tests:
+//   - Line index with and without a trailing newline, and for empty files
+//   - Pipes are read into a buffer and expose the same view and index
+//   - Missing files report an error
+// ------------------------------------------------------------------------------
+static void testMappedFile() {
+    std::cout << "  Testing mapped file... ";
+    
+    const std::string path = getTempTestFile();
+    auto writeFile = [&](const std::string& text) {
+        std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+        ofs << text;
+    };
+    
+    {
+        writeFile("alias ll='ls'\n\n# end");
+        MappedFile file;
+        assert(file.open(path, true) && file.isMapped());
+        assert(file.view() == "alias ll='ls'\n\n# end");
+        assert(file.lineCount() == 3);
+        assert(file.line(0) == "alias ll='ls'" && file.line(1).empty() && file.line(2) == "# end");
+        assert(file.lineOffset(2) == 15);
+        
+        // Moving keeps the view valid
+        MappedFile moved = std::move(file);
+        assert(moved.line(2) == "# end" && file.size() == 0);
+    }
+    {
+        writeFile("a\nb\n");
+        MappedFile file;
+        assert(file.open(path));
+        assert(file.lineCount() == 2 && file.line(1) == "b");
+    }
+    {
+        writeFile("");
+        MappedFile file;
+        assert(file.open(path) && !file.isMapped());
+        assert(file.size() == 0 && file.lineCount() == 0);
+    }
+    
+    // Pipe: read() fallback
+    {
+        int fds[2];
+        assert(pipe(fds) == 0);
+        const char text[] = "x\ny";
+        assert(write(fds[1], text, 3) == 3);
+        close(fds[1]);
+        
+        MappedFile file;
+        assert(file.open("/proc/self/fd/" + std::to_string(fds[0])));
+        assert(!file.isMapped() && file.view() == "x\ny");
+        assert(file.lineCount() == 2 && file.line(1) == "y");
+        close(fds[0]);
+    }
+    
+    MappedFile missing;
+    assert(!missing.open(path + ".missing") && !missing.getLastError().empty());
+    
+    cleanupTestFile();
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Test: Validation on Add
 // Purpose: Verify that invalid aliases are rejected.
@@ -322,6 +1721,436 @@ static void testRestoreBackup() {
     std::cout << "✓ passed" << std::endl;
 }
 
+// ------------------------------------------------------------------------------
+// Test: Backup Compression
+// Purpose: Verify in-process .xz compression of backups.
+// Tests:
+//   - Round trip of data larger than the stream buffers
+//   - Output is .xz and keeps the source's mode and modification time
+//   - Corrupt and truncated input is rejected without touching the target
+//   - Compressed backups are restored directly
+// ------------------------------------------------------------------------------
+static void testBackupCompression() {
+    std::cout << "  Testing backup compression... ";
+    
+    const fs::path dir = getTempTestFile() + ".xz.d";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto readFile = [](const fs::path& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [](const fs::path& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc | std::ios::binary) << text;
+    };
+    
+    std::string data;
+    std::mt19937 rng(21);
+    for (int i = 0; i < 20000; ++i) {
+        data += "alias a" + std::to_string(rng() % 5000) + "='echo " + std::to_string(rng()) + "'\n";
+    }
+    const fs::path source = dir / "rc.bak1";
+    writeFile(source, data);
+    chmod(source.c_str(), 0640);
+    const struct timespec times[2] = {{1000000000, 0}, {1000000000, 0}};
+    assert(utimensat(AT_FDCWD, source.c_str(), times, 0) == 0);
+    
+    XzCodec codec(6, false);
+    const fs::path packed = dir / "rc.bak1.xz";
+    assert(codec.compressFile(source, packed));
+    const std::string compressed = readFile(packed);
+    assert(compressed.size() < data.size() / 2);
+    assert(compressed.compare(0, 6, std::string("\xFD" "7zXZ\0", 6)) == 0);
+    struct stat st;
+    assert(stat(packed.c_str(), &st) == 0);
+    assert(st.st_mtim.tv_sec == 1000000000 && (st.st_mode & 0777) == 0640);
+    
+    const fs::path plain = dir / "plain";
+    assert(codec.decompressFile(packed, plain) && readFile(plain) == data);
+    
+    // Damaged input fails and leaves the target as it was
+    std::string damaged = compressed;
+    damaged[damaged.size() / 2] ^= 0x55;
+    writeFile(dir / "damaged.xz", damaged);
+    writeFile(dir / "truncated.xz", compressed.substr(0, compressed.size() - 10));
+    writeFile(plain, "kept");
+    assert(!codec.decompressFile(dir / "damaged.xz", plain));
+    assert(!codec.decompressFile(dir / "truncated.xz", plain));
+    assert(!codec.getLastError().empty() && readFile(plain) == "kept");
+    
+    // Restore from a compressed backup
+    const fs::path config = dir / "rc";
+    writeFile(config, "alias x='changed'\n");
+    writeFile(dir / "rc.bak2", "alias x='saved'\n");
+    assert(codec.compressFile(dir / "rc.bak2", dir / "rc.bak2.xz"));
+    BackupManager b(config.string());
+    assert(b.restoreFromBackup((dir / "rc.bak2.xz").string()));
+    assert(readFile(config) == "alias x='saved'\n");
+    
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Asynchronous Backups
+// Purpose: Verify the background backup worker.
+// Tests:
+//   - A backup holds the bytes the file had when createBackup returned
+//   - The queue never holds more than kMaxPendingBackups snapshots
+//   - flush and destruction write out everything queued
+// ------------------------------------------------------------------------------
+static void testAsyncBackup() {
+    std::cout << "  Testing asynchronous backups... ";
+    
+    cleanupTestFile();
+    const std::string config = getTempTestFile();
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [](const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc | std::ios::binary) << text;
+    };
+    
+    BackupManager b(config);
+    for (const std::string& old : b.listBackups()) {
+        fs::remove(old);
+    }
+    b.setAsync(true);
+    
+    // Snapshot semantics: later changes do not leak into the backup
+    writeFile(config, "alias v='1'\n");
+    const std::string first = b.createBackup();
+    assert(!first.empty());
+    writeFile(config, "alias v='2'\n");
+    assert(b.flush() && b.pendingBackups() == 0);
+    assert(readFile(first) == "alias v='1'\n");
+    
+    // Bursts are throttled by the bounded queue
+    std::string last;
+    for (int i = 0; i < 40; ++i) {
+        writeFile(config, "alias v='" + std::to_string(i) + "'\n");
+        last = b.createBackup();
+        assert(!last.empty() && b.pendingBackups() <= BackupManager::kMaxPendingBackups + 1);
+    }
+    assert(b.flush());
+    assert(readFile(last) == "alias v='39'\n");
+    assert(b.getLastBackupPath() == last);
+    
+    // Destruction flushes
+    std::string queued;
+    {
+        BackupManager scoped(config);
+        scoped.setAsync(true);
+        writeFile(config, "alias v='final'\n");
+        queued = scoped.createBackup();
+    }
+    assert(readFile(queued) == "alias v='final'\n");
+    
+    for (const std::string& backup : b.listBackups()) {
+        fs::remove(backup);
+    }
+    cleanupTestFile();
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Backup Store
+// Purpose: Verify content-addressed, deduplicated backups.
+// Tests:
+//   - A state already stored costs no object; repeating the latest, no entry
+//   - Files with the same content share one object
+//   - Rotation drops old states, and objects no file refers to any more
+//   - Objects are restored by raw path even once compressed
+//   - Edits that change nothing write nothing and take no backup
+// ------------------------------------------------------------------------------
+static void testBackupStore() {
+    std::cout << "  Testing backup store... ";
+    
+    const fs::path dir = getTempTestFile() + ".store.d";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "home");
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [](const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc | std::ios::binary) << text;
+    };
+    auto countObjects = [&dir] {
+        size_t count = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(dir / "home/.shellbackup/objects")) {
+            count += entry.is_regular_file() ? 1 : 0;
+        }
+        return count;
+    };
+    
+    // A private store, so earlier runs and real backups stay out of it
+    const char* home = std::getenv("HOME");
+    const std::string savedHome = home ? home : "";
+    setenv("HOME", (dir / "home").c_str(), 1);
+    
+    const std::string rcA = (dir / "alia-store-a").string();
+    const std::string rcB = (dir / "alia-store-b").string();
+    BackupManager a(rcA);
+    BackupManager b(rcB);
+    BackupStore store(a.getBackupDirectory());
+    
+    // Add followed by undo: three states, two objects
+    writeFile(rcA, "alias a='1'\n");
+    const std::string first = a.createBackup();
+    writeFile(rcA, "alias a='1'\nalias b='2'\n");
+    const std::string second = a.createBackup();
+    writeFile(rcA, "alias a='1'\n");
+    assert(!first.empty() && first != second && a.createBackup() == first);
+    assert(a.createBackup() == first);  // Same as the latest state
+    assert(a.listBackups() == (std::vector<std::string>{second, first}));
+    assert(a.getLastBackupPath() == first && readFile(first) == "alias a='1'\n");
+    assert(countObjects() == 2);
+    
+    // Another file in a known state shares the object
+    writeFile(rcB, "alias a='1'\nalias b='2'\n");
+    assert(b.createBackup() == second);
+    assert(b.listBackups() == std::vector<std::string>{second});
+    assert(countObjects() == 2);
+    
+    writeFile(rcA, "changed\n");
+    assert(a.restoreFromBackup(second));
+    assert(readFile(rcA) == "alias a='1'\nalias b='2'\n");
+    
+    // Rotation keeps 20 states of a, 10 raw; b's state survives, compressed
+    for (int i = 0; i < 25; ++i) {
+        writeFile(rcA, "alias n='" + std::to_string(i) + "'\n");
+        assert(!a.createBackup().empty());
+    }
+    const std::vector<std::string> listed = a.listBackups();
+    assert(listed.size() == 20);
+    assert(listed.front().ends_with(".xz") && !listed.back().ends_with(".xz"));
+    assert(readFile(listed.back()) == "alias n='24'\n");
+    std::string hash;
+    assert(store.isObjectPath(first, hash) && store.objectPath(hash).empty());
+    assert(store.isObjectPath(second, hash) && store.objectPath(hash) == second + ".xz");
+    assert(!store.isObjectPath(rcA, hash));
+    assert(countObjects() == 21);
+    
+    writeFile(rcB, "changed\n");
+    assert(b.restoreFromBackup(second));
+    assert(readFile(rcB) == "alias a='1'\nalias b='2'\n");
+    
+    // An edit that changes nothing: no write, no backup
+    writeFile(rcA, "alias a='1'\n");
+    const struct timespec times[2] = {{1000000000, 0}, {1000000000, 0}};
+    assert(utimensat(AT_FDCWD, rcA.c_str(), times, 0) == 0);
+    ConfigFileHandler h(rcA, ShellDetector::Shell::BASH);
+    {
+        auto txn = h.beginTransaction();
+        txn.update("a", "1");
+        txn.add({"a", "1", "", true, "", ""});
+        assert(txn.commit(&a));
+    }
+    struct stat st;
+    assert(stat(rcA.c_str(), &st) == 0 && st.st_mtim.tv_sec == 1000000000);
+    assert(a.listBackups() == listed);
+    
+    setenv("HOME", savedHome.c_str(), 1);
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Backup Deltas
+// Purpose: Verify delta-encoded backup chains.
+// Tests:
+//   - One-line edits of a large file cost about one line each
+//   - Chains stay within BackupStore::kMaxChain objects, then a keyframe
+//   - Every kept state restores byte for byte
+//   - Rotation removes a keyframe only with the last delta on it
+//   - A damaged delta is reported, not restored
+// ------------------------------------------------------------------------------
+static void testBackupDeltas() {
+    std::cout << "  Testing backup deltas... ";
+    
+    const fs::path dir = getTempTestFile() + ".delta.d";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "home");
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [](const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc | std::ios::binary) << text;
+    };
+    const fs::path objects = dir / "home/.shellbackup/objects";
+    auto storedBytes = [&objects] {
+        uintmax_t bytes = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(objects)) {
+            bytes += entry.is_regular_file() ? entry.file_size() : 0;
+        }
+        return bytes;
+    };
+    
+    const char* home = std::getenv("HOME");
+    const std::string savedHome = home ? home : "";
+    setenv("HOME", (dir / "home").c_str(), 1);
+    
+    // A generated file of ~200 KB, edited one line at a time
+    std::vector<std::string> lines;
+    for (int i = 0; i < 4000; ++i) {
+        lines.push_back("alias gen" + std::to_string(i) + "='echo generated alias number " +
+                        std::to_string(i * 7919) + "'\n");
+    }
+    auto join = [&lines] {
+        std::string text;
+        for (const std::string& line : lines) text += line;
+        return text;
+    };
+    
+    const std::string rc = (dir / "alia-delta").string();
+    BackupManager b(rc);
+    BackupStore store(b.getBackupDirectory());
+    std::vector<std::string> states;
+    std::mt19937 rng(24);
+    for (int i = 0; i < 40; ++i) {
+        if (i % 3 == 2) {
+            lines.push_back("alias added" + std::to_string(i) + "='true'\n");
+        } else {
+            lines[rng() % lines.size()] = "alias edit" + std::to_string(i) + "='ls'\n";
+        }
+        states.push_back(join());
+        writeFile(rc, states.back());
+        const std::string path = b.createBackup();
+        assert(!path.empty());
+        std::string hash;
+        assert(store.isObjectPath(path, hash));
+        assert(store.chainOf(hash).size() <= BackupStore::kMaxChain);
+        const bool keyframe = fs::path(path).extension() != ".delta";
+        assert(keyframe == (i % BackupStore::kMaxChain == 0));
+    }
+    
+    // Kept: the newest 20 states, within 2 keyframes and 18 deltas
+    const std::vector<std::string> listed = b.listBackups();
+    assert(listed.size() == 20);
+    assert(storedBytes() < 3 * states.back().size());
+    for (size_t i = 0; i < listed.size(); ++i) {
+        assert(b.restoreFromBackup(listed[i]));
+        assert(readFile(rc) == states[20 + i]);
+    }
+    
+    // Damage the newest delta: the restore fails and leaves the file alone
+    const std::string newest = listed.back();
+    assert(fs::path(newest).extension() == ".delta");
+    std::string delta = readFile(newest);
+    delta[delta.size() - 3] ^= 0x20;
+    fs::permissions(newest, fs::perms::owner_write, fs::perm_options::add);
+    writeFile(newest, delta);
+    assert(!b.restoreFromBackup(newest));
+    assert(b.getLastError().find("damaged") != std::string::npos);
+    assert(readFile(rc) == states[39]);
+    
+    setenv("HOME", savedHome.c_str(), 1);
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
+// ------------------------------------------------------------------------------
+// Test: Backup Manifest
+// Purpose: Verify the manifest index of the backup store.
+// Tests:
+//   - Legacy .bak and .bak.xz files are imported once, oldest first, and
+//     their paths can still be restored; other files are left alone
+//   - Backups taken within the same second are all kept, in order
+//   - Entries are numbered and carry time, size, codec and file
+//   - Appends by another manager are seen; listing does not walk the
+//     backup directory, and the directory is resolved once
+// ------------------------------------------------------------------------------
+static void testBackupManifest() {
+    std::cout << "  Testing backup manifest... ";
+    
+    const fs::path dir = getTempTestFile() + ".manifest.d";
+    const fs::path backupDir = dir / "home/.shellbackup";
+    fs::remove_all(dir);
+    fs::create_directories(backupDir);
+    auto readFile = [](const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), {});
+    };
+    auto writeFile = [](const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc | std::ios::binary) << text;
+    };
+    
+    const char* home = std::getenv("HOME");
+    const std::string savedHome = home ? home : "";
+    setenv("HOME", (dir / "home").c_str(), 1);
+    
+    // Backups of an earlier version, one of them compressed
+    const std::string oldPlain = (backupDir / "alia-manifest.bak20240101_000000").string();
+    const std::string oldPacked = (backupDir / "alia-manifest.bak20240101_000001").string();
+    writeFile(oldPlain, "alias old='1'\n");
+    writeFile(oldPacked, "alias old='2'\n");
+    XzCodec codec;
+    assert(codec.compressFile(oldPacked, oldPacked + ".xz"));
+    fs::remove(oldPacked);
+    const struct timespec first[2] = {{1000000000, 0}, {1000000000, 0}};
+    const struct timespec second[2] = {{1000000001, 0}, {1000000001, 0}};
+    assert(utimensat(AT_FDCWD, oldPlain.c_str(), first, 0) == 0);
+    assert(utimensat(AT_FDCWD, (oldPacked + ".xz").c_str(), second, 0) == 0);
+    const std::string unrelated = (backupDir / "alia-manifest.bak.notes").string();
+    writeFile(unrelated, "mine\n");
+    
+    const std::string rc = (dir / "alia-manifest").string();
+    writeFile(rc, "alias now='0'\n");
+    BackupManager m(rc);
+    std::vector<std::string> listed = m.listBackups();
+    assert(listed.size() == 2);
+    assert(!fs::exists(oldPlain) && !fs::exists(oldPacked + ".xz"));
+    assert(m.restoreFromBackup(listed[0]) && readFile(rc) == "alias old='1'\n");
+    assert(m.restoreFromBackup(listed[1]) && readFile(rc) == "alias old='2'\n");
+    assert(m.restoreFromBackup(oldPlain) && readFile(rc) == "alias old='1'\n");
+    assert(m.restoreFromBackup(oldPacked + ".xz") && readFile(rc) == "alias old='2'\n");
+    assert(readFile(unrelated) == "mine\n");
+    
+    // A fast batch: five backups, none lost to a shared timestamp
+    for (int i = 0; i < 5; ++i) {
+        writeFile(rc, "alias batch='" + std::to_string(i) + "'\n");
+        assert(!m.createBackup().empty());
+    }
+    listed = m.listBackups();
+    assert(listed.size() == 7);
+    assert(m.getLastBackupPath() == listed.back());
+    assert(m.restoreFromBackup(listed[2]) && readFile(rc) == "alias batch='0'\n");
+    
+    BackupStore store(m.getBackupDirectory());
+    const std::vector<BackupStore::Entry> entries = store.entries();
+    assert(entries.size() == 7);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        assert(entries[i].seq == i + 1 && entries[i].file == entries[0].file);
+        assert(entries[i].codec == "raw" && entries[i].size == (i < 2 ? 14u : 16u));
+        assert(i == 0 || entries[i].timeNs > entries[i - 1].timeNs);
+    }
+    assert(entries[0].timeNs == int64_t(1000000000) * 1000000000);
+    assert(store.latest(entries[0].file)->seq == 7);
+    assert(store.latest("other") == nullptr);
+    
+    // Another manager's backup is the latest for this one too
+    BackupManager other(rc);
+    writeFile(rc, "alias other='1'\n");
+    const std::string theirs = other.createBackup();
+    assert(m.getLastBackupPath() == theirs && m.listBackups().size() == 8);
+    
+    // Files dropped into the directory later are not picked up by a scan
+    const std::string late = (backupDir / "alia-manifest.bak20240101_000002").string();
+    writeFile(late, "alias late='1'\n");
+    assert(m.listBackups().size() == 8 && fs::exists(late));
+    
+    // The backup directory is resolved once
+    setenv("HOME", dir.c_str(), 1);
+    assert(m.getBackupDirectory() == backupDir.string());
+    
+    setenv("HOME", savedHome.c_str(), 1);
+    fs::remove_all(dir);
+    std::cout << "✓ passed" << std::endl;
+}
+
 // ------------------------------------------------------------------------------
 // Main Test Runner
 // Purpose: Execute all ConfigFileHandler and BackupManager tests.
@@ -333,10 +2162,32 @@ void test_confighandler() {
     testLoadEmptyFile();      // Test empty file handling
     testAddAlias();           // Test single alias addition
     testRemoveAlias();        // Test alias removal
+    testMinimalEdits();       // Test in-place and suffix-only edits
+    testTransaction();        // Test batched alias changes
+    testUpdateRename();       // Test in-place update and rename
+    testAliasCache();         // Test the persistent parse cache
+    testAliasReloader();      // Test incremental reload
+    testFileWatcher();        // Test inotify change notification
+    testConcurrentWriters();  // Test multi-process locking and retry
+    testLineMerge();          // Test line diff and three-way merge
+    testMergeCommit();        // Test commits merged against a base
+    testManagedAliases();     // Test the owned alias block and sidecar file
+    testAliasDiscovery();     // Test include-following alias discovery
+    testSyscallBudget();      // Test fixed metadata calls per edit
+    testAtomicWriter();       // Test crash-safe file replacement
     testMultipleAliases();    // Test multiple aliases
+    testShellRoundTrip();     // Test round trip for every shell
+    testThreadPool();         // Test thread pool
+    testParallelLoad();       // Test chunked parsing of large files
+    testMappedFile();         // Test mmap and read() file access
     testValidationOnAdd();    // Test input validation
     testBackupCreation();     // Test backup functionality
     testRestoreBackup();      // Test backup restoration
+    testBackupCompression();  // Test in-process .xz compression
+    testAsyncBackup();        // Test the background backup worker
+    testBackupStore();        // Test deduplicated backups
+    testBackupDeltas();       // Test delta-encoded backup chains
+    testBackupManifest();     // Test the backup manifest index
     
     // Final cleanup
     cleanupTestFile();